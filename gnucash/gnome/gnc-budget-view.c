@@ -827,9 +827,15 @@ bgv_get_total_for_account(Account* account, GncBudget* budget)
     guint num_periods;
     int period_num;
     gnc_numeric numeric;
-    gnc_numeric total = gnc_numeric_zero();
+    gnc_numeric total;
+    gnc_numeric *amounts;
+    guint n = 0;
 
+    /* This runs for every row each time the totals column is drawn, so
+     * the period amounts are added in one call rather than converting
+     * a running total after each of them. */
     num_periods = gnc_budget_get_num_periods(budget);
+    amounts = g_new(gnc_numeric, num_periods);
     for (period_num = 0; period_num < num_periods; ++period_num)
     {
         if (!gnc_budget_is_account_period_value_set(budget, account, period_num))
@@ -837,7 +843,7 @@ bgv_get_total_for_account(Account* account, GncBudget* budget)
             if (gnc_account_n_children(account) != 0)
             {
                 numeric = gbv_get_accumulated_budget_amount(budget, account, period_num);
-                total = gnc_numeric_add(total, numeric, GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD);
+                amounts[n++] = numeric;
             }
         }
         else
@@ -845,10 +851,12 @@ bgv_get_total_for_account(Account* account, GncBudget* budget)
             numeric = gnc_budget_get_account_period_value(budget, account, period_num);
             if (!gnc_numeric_check(numeric))
             {
-                total = gnc_numeric_add(total, numeric, GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD);
+                amounts[n++] = numeric;
             }
         }
     }
+    total = gnc_numeric_sum(amounts, n, GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD);
+    g_free(amounts);
 
     return total;
 }
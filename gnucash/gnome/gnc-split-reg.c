@@ -86,6 +86,8 @@ static void gsr_update_summary_label( GtkWidget *label,
                                       gboolean euroFlag );
 
 static void gsr_redraw_all_cb (GnucashRegister *g_reg, gpointer data);
+static void gsr_scrolled_to_top_cb (GnucashRegister *g_reg, gpointer data);
+static void gsr_load_older_cb (GtkButton *button, gpointer data);
 
 static void gnc_split_reg_ld_destroy( GNCLedgerDisplay *ledger );
 
@@ -416,6 +418,8 @@ gsr_create_table( GNCSplitReg *gsr )
                       G_CALLBACK(gsr_redraw_all_cb), gsr);
     g_signal_connect (gsr->reg, "redraw_help",
                       G_CALLBACK(gsr_emit_help_changed), gsr);
+    g_signal_connect (gsr->reg, "scrolled_to_top",
+                      G_CALLBACK(gsr_scrolled_to_top_cb), gsr);
 
     LEAVE(" ");
 }
@@ -437,6 +441,13 @@ gsr_setup_status_widgets( GNCSplitReg *gsr )
 void
 gnc_split_reg_destroy_cb(GtkWidget *widget, gpointer data)
 {
+    GNCSplitReg *gsr = data;
+
+    if (gsr->load_more_id)
+    {
+        g_source_remove (gsr->load_more_id);
+        gsr->load_more_id = 0;
+    }
 }
 
 /**
@@ -496,6 +507,66 @@ gsr_update_summary_label( GtkWidget *label,
     gtk_label_set_text( GTK_LABEL(label), string );
 }
 
+static gboolean
+gsr_load_more_idle (gpointer data)
+{
+    GNCSplitReg *gsr = data;
+
+    gsr->load_more_id = 0;
+    gnc_ledger_display_load_more (gsr->ledger, FALSE);
+    return FALSE;
+}
+
+/* Load the older splits left out of the register once the user has
+ * scrolled up to the oldest one loaded. Reloading from inside the
+ * adjustment's signal would fight with the scrollbar, so it waits for the
+ * main loop to be idle. */
+static void
+gsr_scrolled_to_top_cb (GnucashRegister *g_reg, gpointer data)
+{
+    GNCSplitReg *gsr = data;
+
+    if (gsr->load_more_id)
+        return;
+
+    gsr->load_more_id = g_idle_add (gsr_load_more_idle, gsr);
+}
+
+static void
+gsr_load_older_cb (GtkButton *button, gpointer data)
+{
+    GNCSplitReg *gsr = data;
+
+    gnc_ledger_display_load_more (gsr->ledger, FALSE);
+}
+
+/* Tell the user that the oldest splits weren't loaded, and how many. */
+static void
+gsr_update_unloaded_label (GNCSplitReg *gsr)
+{
+    SplitRegister *reg;
+    gint unloaded;
+    gchar *text;
+
+    if (gsr->unloaded_label == NULL)
+        return;
+
+    reg = gnc_ledger_display_get_split_register (gsr->ledger);
+    unloaded = gnc_split_register_get_unloaded_splits (reg);
+    if (unloaded == 0)
+    {
+        gtk_widget_hide (gsr->unloaded_box);
+        return;
+    }
+
+    text = g_strdup_printf (ngettext ("%d older split not loaded",
+                                      "%d older splits not loaded",
+                                      unloaded), unloaded);
+    gtk_label_set_text (GTK_LABEL (gsr->unloaded_label), text);
+    g_free (text);
+    gtk_widget_show (gsr->unloaded_box);
+}
+
 static
 void
 gsr_redraw_all_cb (GnucashRegister *g_reg, gpointer data)
@@ -511,6 +582,8 @@ gsr_redraw_all_cb (GnucashRegister *g_reg, gpointer data)
     if ( gsr->summarybar == NULL )
         return;
 
+    gsr_update_unloaded_label (gsr);
+
     leader = gnc_ledger_display_leader( gsr->ledger );
 
     commodity = xaccAccountGetCommodity( leader );
@@ -1464,6 +1537,12 @@ gnc_split_reg_jump_to_split(GNCSplitReg *gsr, Split *split)
 
     reg = gnc_ledger_display_get_split_register( gsr->ledger );
 
+    /* The split may be newer than the last refresh, or older than the
+     * splits loaded in the register. */
+    gnc_ledger_display_finish_refresh( gsr->ledger );
+    if (!gnc_split_register_get_split_virt_loc(reg, split, &vcell_loc))
+        gnc_ledger_display_load_more( gsr->ledger, TRUE );
+
     if (gnc_split_register_get_split_virt_loc(reg, split, &vcell_loc))
         gnucash_register_goto_virt_cell( gsr->reg, vcell_loc );
 
@@ -1488,6 +1567,12 @@ gnc_split_reg_jump_to_split_amount(GNCSplitReg *gsr, Split *split)
 
     reg = gnc_ledger_display_get_split_register (gsr->ledger);
 
+    /* The split may be newer than the last refresh, or older than the
+     * splits loaded in the register. */
+    gnc_ledger_display_finish_refresh (gsr->ledger);
+    if (!gnc_split_register_get_split_virt_loc (reg, split, &virt_loc.vcell_loc))
+        gnc_ledger_display_load_more (gsr->ledger, TRUE);
+
     if (gnc_split_register_get_split_amount_virt_loc (reg, split, &virt_loc))
         gnucash_register_goto_virt_loc (gsr->reg, virt_loc);
 
@@ -1503,6 +1588,7 @@ gnc_split_reg_jump_to_blank (GNCSplitReg *gsr)
 
     ENTER("gsr=%p", gsr);
 
+    gnc_ledger_display_finish_refresh (gsr->ledger);
     blank = gnc_split_register_get_blank_split (reg);
     if (blank == NULL)
     {
@@ -2012,6 +2098,7 @@ GtkWidget *
 gsr_create_summary_bar( GNCSplitReg *gsr )
 {
     GtkWidget *summarybar;
+    GtkWidget *button;
 
     gsr->cleared_label    = NULL;
     gsr->balance_label    = NULL;
@@ -2020,6 +2107,8 @@ gsr_create_summary_bar( GNCSplitReg *gsr )
     gsr->projectedminimum_label  = NULL;
     gsr->shares_label     = NULL;
     gsr->value_label      = NULL;
+    gsr->unloaded_box     = NULL;
+    gsr->unloaded_label   = NULL;
 
     if ( gnc_ledger_display_type(gsr->ledger) >= LD_SUBACCOUNT )
     {
@@ -2044,6 +2133,21 @@ gsr_create_summary_bar( GNCSplitReg *gsr )
         gsr->value_label      = add_summary_label (summarybar, _("Current Value:"));
     }
 
+    gsr->unloaded_box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 2);
+    gtk_box_pack_end (GTK_BOX(summarybar), gsr->unloaded_box, FALSE, FALSE, 5);
+    gsr->unloaded_label = gtk_label_new ("");
+    gtk_box_pack_start (GTK_BOX(gsr->unloaded_box), gsr->unloaded_label,
+                        FALSE, FALSE, 0);
+    button = gtk_button_new_with_label (_("Load Older"));
+    gtk_widget_set_tooltip_text (button,
+        _("Load more of the older splits into the register. Scrolling to the top also loads them."));
+    g_signal_connect (button, "clicked", G_CALLBACK(gsr_load_older_cb), gsr);
+    gtk_box_pack_start (GTK_BOX(gsr->unloaded_box), button, FALSE, FALSE, 0);
+    /* Only shown while splits are left out. */
+    gtk_widget_show (gsr->unloaded_label);
+    gtk_widget_show (button);
+    gtk_widget_set_no_show_all (gsr->unloaded_box, TRUE);
+
     gsr->summarybar = summarybar;
 
     /* Force the first update */
@@ -74,6 +74,9 @@ struct _GNCSplitReg
     GtkWidget *projectedminimum_label;
     GtkWidget *shares_label;
     GtkWidget *value_label;
+    /** Says how many older splits the load window left out. **/
+    GtkWidget *unloaded_box;
+    GtkWidget *unloaded_label;
 
     /** The current ledger display. **/
     GNCLedgerDisplay *ledger;
@@ -85,6 +88,9 @@ struct _GNCSplitReg
     guint sort_type;
 
     gboolean read_only;
+
+    /** Idle source loading older splits after a scroll to the top. **/
+    guint load_more_id;
 };
 
 struct _GNCSplitRegClass
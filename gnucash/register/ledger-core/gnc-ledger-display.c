@@ -52,6 +52,10 @@
 #define GNC_PREF_DEFAULT_STYLE_AUTOLEDGER "default-style-autoledger"
 #define GNC_PREF_DEFAULT_STYLE_JOURNAL    "default-style-journal"
 
+/* How many splits a register loads at first, and how many more each time
+ * the user scrolls to the top of it. */
+#define LOAD_WINDOW_SPLITS 1000
+
 
 struct gnc_ledger_display
 {
@@ -72,6 +76,17 @@ struct gnc_ledger_display
     gpointer user_data;
 
     gint component_id;
+
+    /* Idle source of a refresh put off until the main loop is free,
+     * 0 if there is none. */
+    guint refresh_id;
+    /* Set when that refresh came while the register was loading, so
+     * that it is scheduled again once the load is done. */
+    gboolean refresh_pending;
+
+    /* GUIDs of the transactions shown, to tell whether one of them was
+     * destroyed. */
+    GHashTable *watched_trans;
 };
 
 
@@ -89,6 +104,7 @@ gnc_ledger_display_internal (Account *lead_account, Query *q,
                              gboolean is_template);
 static void gnc_ledger_display_refresh_internal (GNCLedgerDisplay *ld,
         GList *splits);
+static void gnc_ledger_display_cancel_refresh (GNCLedgerDisplay *ld);
 
 
 /** Implementations *************************************************/
@@ -515,6 +531,7 @@ gnc_ledger_display_set_watches (GNCLedgerDisplay *ld, GList *splits)
     GList *node;
 
     gnc_gui_component_clear_watches (ld->component_id);
+    g_hash_table_remove_all (ld->watched_trans);
 
     gnc_gui_component_watch_entity_type (ld->component_id,
                                          GNC_ID_ACCOUNT,
@@ -525,11 +542,124 @@ gnc_ledger_display_set_watches (GNCLedgerDisplay *ld, GList *splits)
     {
         Split *split = node->data;
         Transaction *trans = xaccSplitGetParent (split);
+        const GncGUID *guid = xaccTransGetGUID (trans);
 
-        gnc_gui_component_watch_entity (ld->component_id,
-                                        xaccTransGetGUID (trans),
+        gnc_gui_component_watch_entity (ld->component_id, guid,
                                         QOF_EVENT_MODIFY);
+        if (!g_hash_table_contains (ld->watched_trans, guid))
+            g_hash_table_add (ld->watched_trans, guid_copy (guid));
+    }
+}
+
+/* Whether the changes touch a transaction the user is working on in
+ * this register. Those are reloaded at once, so that the register can
+ * move on to the new blank transaction after a save. */
+static gboolean
+gnc_ledger_display_changes_edited_trans (GNCLedgerDisplay *ld,
+                                         GHashTable *changes)
+{
+    Transaction *trans[2];
+    Split *blank_split;
+    guint i;
+
+    trans[0] = gnc_split_register_get_current_trans (ld->reg);
+    blank_split = gnc_split_register_get_blank_split (ld->reg);
+    trans[1] = blank_split ? xaccSplitGetParent (blank_split) : NULL;
+
+    for (i = 0; i < G_N_ELEMENTS (trans); i++)
+        if (trans[i] &&
+            gnc_gui_get_entity_events (changes, xaccTransGetGUID (trans[i])))
+            return TRUE;
+
+    return FALSE;
+}
+
+/* Whether the changes add, remove or destroy something the register
+ * shows: one of its transactions, or a split of its lead account or of
+ * the accounts under it. Those are shown at once, so that the register
+ * doesn't keep showing a deleted split until the main loop is idle. */
+static gboolean
+gnc_ledger_display_changes_structure (GNCLedgerDisplay *ld,
+                                      GHashTable *changes)
+{
+    Account *leader = gnc_ledger_display_leader (ld);
+    GHashTableIter iter;
+    gpointer key, value;
+
+    g_hash_table_iter_init (&iter, changes);
+    while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+        const GncGUID *guid = key;
+        const EventInfo *info = value;
+        Account *account;
+
+        if (!(info->event_mask & (QOF_EVENT_DESTROY | QOF_EVENT_ADD |
+                                  QOF_EVENT_REMOVE | GNC_EVENT_ITEM_ADDED |
+                                  GNC_EVENT_ITEM_REMOVED)))
+            continue;
+
+        if (g_hash_table_contains (ld->watched_trans, guid))
+            return TRUE;
+
+        if (!leader)
+            continue;
+
+        account = xaccAccountLookup (guid, gnc_get_current_book ());
+        if (account && (account == leader ||
+                        (ld->ld_type == LD_SUBACCOUNT &&
+                         xaccAccountHasAncestor (account, leader))))
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+static gboolean
+gnc_ledger_display_refresh_idle (gpointer user_data)
+{
+    GNCLedgerDisplay *ld = user_data;
+    GList *splits;
+
+    ENTER("ld=%p", ld);
+
+    ld->refresh_id = 0;
+    if (ld->loading)
+    {
+        ld->refresh_pending = TRUE;
+        LEAVE("already loading, refresh once done");
+        return FALSE;
     }
+
+    /* Run the query now rather than when the refresh was asked for,
+     * so that it sees every change made in between. */
+    splits = qof_query_run (ld->query);
+
+    gnc_ledger_display_set_watches (ld, splits);
+
+    gnc_ledger_display_refresh_internal (ld, splits);
+    LEAVE(" ");
+    return FALSE;
+}
+
+static void
+gnc_ledger_display_cancel_refresh (GNCLedgerDisplay *ld)
+{
+    ld->refresh_pending = FALSE;
+    if (!ld->refresh_id)
+        return;
+
+    g_source_remove (ld->refresh_id);
+    ld->refresh_id = 0;
+}
+
+void
+gnc_ledger_display_finish_refresh (GNCLedgerDisplay *ld)
+{
+    if (!ld || !ld->refresh_id)
+        return;
+
+    gnc_ledger_display_cancel_refresh (ld);
+    gnc_ledger_display_refresh_idle (ld);
 }
 
 static void
@@ -572,6 +702,23 @@ refresh_handler (GHashTable *changes, gpointer user_data)
         }
     }
 
+    /* Registers that aren't being edited are brought up to date once
+     * the main loop is idle when their transactions were only modified,
+     * so that a change doesn't stall the GUI while every open register
+     * reloads, and a burst of changes costs a single reload. The reload
+     * itself still runs on the main thread, because the engine can't be
+     * read from another thread while it's being changed. */
+    if (changes && !gnc_ledger_display_changes_edited_trans (ld, changes) &&
+        !gnc_ledger_display_changes_structure (ld, changes))
+    {
+        if (!ld->refresh_id)
+            ld->refresh_id = g_idle_add (gnc_ledger_display_refresh_idle, ld);
+        LEAVE("deferred");
+        return;
+    }
+
+    gnc_ledger_display_cancel_refresh (ld);
+
     /* Its not clear if we should re-run the query, or if we should
      * just use qof_query_last_run().  Its possible that the dates
      * changed, requiring a full new query.  Similar considerations
@@ -596,6 +743,9 @@ close_handler (gpointer user_data)
     gnc_unregister_gui_component (ld->component_id);
     ld->component_id = NO_COMPONENT;
 
+    gnc_ledger_display_cancel_refresh (ld);
+    g_hash_table_destroy (ld->watched_trans);
+
     if (ld->destroy)
         ld->destroy (ld);
 
@@ -763,6 +913,12 @@ gnc_ledger_display_internal (Account *lead_account, Query *q,
     ld->destroy = NULL;
     ld->get_parent = NULL;
     ld->user_data = NULL;
+    ld->refresh_id = 0;
+    ld->refresh_pending = FALSE;
+    ld->watched_trans = g_hash_table_new_full (guid_hash_to_guint,
+                                               guid_g_hash_table_equal,
+                                               (GDestroyNotify) guid_free,
+                                               NULL);
 
     limit = gnc_prefs_get_float(GNC_PREFS_GROUP_GENERAL_REGISTER, GNC_PREF_MAX_TRANS);
 
@@ -785,6 +941,10 @@ gnc_ledger_display_internal (Account *lead_account, Query *q,
                                       is_template);
 
     gnc_split_register_set_data (ld->reg, ld, gnc_ledger_display_parent);
+    /* Only account registers have a summary bar to say that older splits
+     * were left out. */
+    if (ld_type == LD_SINGLE && !is_template)
+        gnc_split_register_set_load_window (ld->reg, LOAD_WINDOW_SPLITS);
 
     splits = qof_query_run (ld->query);
 
@@ -835,6 +995,14 @@ gnc_ledger_display_refresh_internal (GNCLedgerDisplay *ld, GList *splits)
                              gnc_ledger_display_leader (ld));
 
     ld->loading = FALSE;
+
+    /* A put off refresh that came during the load sees what it missed. */
+    if (ld->refresh_pending)
+    {
+        ld->refresh_pending = FALSE;
+        if (!ld->refresh_id)
+            ld->refresh_id = g_idle_add (gnc_ledger_display_refresh_idle, ld);
+    }
 }
 
 void
@@ -854,10 +1022,36 @@ gnc_ledger_display_refresh (GNCLedgerDisplay *ld)
         return;
     }
 
+    /* This refresh makes any that was put off unnecessary. */
+    gnc_ledger_display_cancel_refresh (ld);
+
     gnc_ledger_display_refresh_internal (ld, qof_query_run (ld->query));
     LEAVE(" ");
 }
 
+gboolean
+gnc_ledger_display_load_more (GNCLedgerDisplay *ld, gboolean all_splits)
+{
+    ENTER("ld=%p, all_splits=%d", ld, all_splits);
+
+    if (!ld || ld->loading)
+    {
+        LEAVE("no display or already loading");
+        return FALSE;
+    }
+
+    if (!gnc_split_register_extend_load_window (ld->reg,
+            all_splits ? 0 : LOAD_WINDOW_SPLITS))
+    {
+        LEAVE("all splits loaded");
+        return FALSE;
+    }
+
+    gnc_ledger_display_refresh (ld);
+    LEAVE(" ");
+    return TRUE;
+}
+
 void
 gnc_ledger_display_refresh_by_split_register (SplitRegister *reg)
 {
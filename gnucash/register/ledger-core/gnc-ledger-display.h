@@ -120,6 +120,19 @@ GNCLedgerDisplay * gnc_ledger_display_find_by_query (Query *q);
 void gnc_ledger_display_refresh (GNCLedgerDisplay * ledger_display);
 void gnc_ledger_display_refresh_by_split_register (SplitRegister *reg);
 
+/** Run now a refresh that was put off until the main loop is idle, for
+ * callers that need the register to show the latest changes, like when
+ * jumping to a split that was just created. Does nothing if no refresh
+ * is waiting. */
+void gnc_ledger_display_finish_refresh (GNCLedgerDisplay *ld);
+
+/** Load older splits which were left out of the register to keep it
+ * quick to open. If all_splits is FALSE another window's worth is loaded,
+ * otherwise all of them are.
+ * @return TRUE if the register was reloaded. */
+gboolean gnc_ledger_display_load_more (GNCLedgerDisplay *ld,
+                                       gboolean all_splits);
+
 /** close the window */
 void gnc_ledger_display_close (GNCLedgerDisplay * ledger_display);
 
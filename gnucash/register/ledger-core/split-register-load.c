@@ -32,6 +32,7 @@
 #include "qof.h"
 #include "gnc-ui-util.h"
 #include "gnc-gui-query.h"
+#include "gnc-trans-quickfill.h"
 #include "numcell.h"
 #include "quickfillcell.h"
 #include "recncell.h"
@@ -48,6 +49,7 @@ static QofLogModule log_module = GNC_MOD_LEDGER;
 
 static void gnc_split_register_load_xfer_cells (SplitRegister *reg,
         Account *base_account);
+static void gnc_split_register_load_quickfill_cells (SplitRegister *reg);
 
 static void
 gnc_split_register_load_recn_cells (SplitRegister *reg)
@@ -231,34 +233,6 @@ _find_split_with_parent_txn(gconstpointer a, gconstpointer b)
     return xaccSplitGetParent(split) == txn ? 0 : 1;
 }
 
-static void add_quickfill_completions(TableLayout *layout, Transaction *trans,
-                                      Split *split, gboolean has_last_num)
-{
-    Split *s;
-    int i = 0;
-
-    gnc_quickfill_cell_add_completion(
-        (QuickFillCell *) gnc_table_layout_get_cell(layout, DESC_CELL),
-        xaccTransGetDescription(trans));
-
-    gnc_quickfill_cell_add_completion(
-        (QuickFillCell *) gnc_table_layout_get_cell(layout, NOTES_CELL),
-        xaccTransGetNotes(trans));
-
-    if (!has_last_num)
-        gnc_num_cell_set_last_num(
-            (NumCell *) gnc_table_layout_get_cell(layout, NUM_CELL),
-            gnc_get_num_action(trans, split));
-
-    while ((s = xaccTransGetSplit(trans, i)) != NULL)
-    {
-        gnc_quickfill_cell_add_completion(
-            (QuickFillCell *) gnc_table_layout_get_cell(layout, MEMO_CELL),
-            xaccSplitGetMemo(s));
-        i++;
-    }
-}
-
 static Split*
 create_blank_split (Account *default_account, SRInfo *info)
 {
@@ -342,6 +316,36 @@ update_info (SRInfo *info, SplitRegister *reg)
     info->reg_loaded = TRUE;
 }
 
+/* The load window leaves out the splits at the head of the list, which is
+ * only right if they are the oldest, as they are in the default sort. Other
+ * sorts, or the default one reversed, would hide the wrong splits, unless
+ * they happen to leave the splits in date order too. The pending
+ * transaction may have been put at the end and is always loaded anyway. */
+static gboolean
+splits_oldest_first (GList *slist, Transaction *pending_trans)
+{
+    gboolean first = TRUE;
+    time64 last_date = 0;
+    GList *node;
+
+    for (node = slist; node; node = node->next)
+    {
+        Transaction *trans = xaccSplitGetParent (node->data);
+        time64 date;
+
+        if (trans == pending_trans)
+            continue;
+
+        date = xaccTransGetDate (trans);
+        if (!first && date < last_date)
+            return FALSE;
+
+        first = FALSE;
+        last_date = date;
+    }
+    return TRUE;
+}
+
 void
 gnc_split_register_load (SplitRegister *reg, GList * slist,
                          Account *default_account)
@@ -384,6 +388,8 @@ gnc_split_register_load (SplitRegister *reg, GList * slist,
     int new_trans_split_row = -1;
     int new_trans_row = -1;
     int new_split_row = -1;
+    int anchor_row = -1;
+    int skip = 0;
     time64 present, autoreadonly_time = 0;
 
     g_return_if_fail(reg);
@@ -509,6 +515,7 @@ gnc_split_register_load (SplitRegister *reg, GList * slist,
 
         /* load up account names into the transfer combobox menus */
         gnc_split_register_load_xfer_cells (reg, default_account);
+        gnc_split_register_load_quickfill_cells (reg);
         gnc_split_register_load_associate_cells (reg);
         gnc_split_register_load_recn_cells (reg);
         gnc_split_register_load_type_cells (reg);
@@ -546,11 +553,37 @@ gnc_split_register_load (SplitRegister *reg, GList * slist,
         }
     }
 
+    /* Leave out the oldest splits that don't fit in the load window, but
+     * never the transaction being edited or the one the cursor goes to. */
+    if (info->load_window > 0)
+    {
+        int n_splits = g_list_length (slist);
+
+        if (n_splits > info->load_window &&
+            splits_oldest_first (slist, pending_trans))
+        {
+            int i;
+
+            skip = n_splits - info->load_window;
+            for (node = slist, i = 0; node && i < skip; node = node->next, i++)
+            {
+                trans = xaccSplitGetParent (node->data);
+                if (trans == find_trans || trans == pending_trans)
+                {
+                    skip = i;
+                    break;
+                }
+            }
+        }
+    }
+    info->unloaded_splits = skip;
+    info->window_first_guid = *guid_null ();
+
     if (multi_line)
         trans_table = g_hash_table_new (g_direct_hash, g_direct_equal);
 
     /* populate the table */
-    for (node = slist; node; node = node->next)
+    for (node = g_list_nth (slist, skip); node; node = node->next)
     {
         split = node->data;
         trans = xaccSplitGetParent (split);
@@ -638,10 +671,12 @@ gnc_split_register_load (SplitRegister *reg, GList * slist,
             }
         }
 
-        /* If this is the first load of the register,
-         * fill up the quickfill cells. */
-        if (info->first_pass)
-            add_quickfill_completions(reg->table->layout, trans, split, has_last_num);
+        /* If this is the first load of the register, and the account
+         * doesn't remember its last number, take it from the splits. */
+        if (info->first_pass && !has_last_num)
+            gnc_num_cell_set_last_num
+                ((NumCell *) gnc_table_layout_get_cell (table->layout, NUM_CELL),
+                 gnc_get_num_action (trans, split));
 
         if (trans == find_trans)
             new_trans_row = vcell_loc.virt_row;
@@ -649,6 +684,13 @@ gnc_split_register_load (SplitRegister *reg, GList * slist,
         if (split == find_trans_split)
             new_trans_split_row = vcell_loc.virt_row;
 
+        if (guid_equal (&info->window_first_guid, guid_null ()))
+            info->window_first_guid = *xaccSplitGetGUID (split);
+
+        if (anchor_row < 0 &&
+            guid_equal (xaccSplitGetGUID (split), &info->window_anchor_guid))
+            anchor_row = vcell_loc.virt_row;
+
         gnc_split_register_add_transaction (reg, trans, split,
                                             lead_cursor, split_cursor,
                                             multi_line, start_primary_color,
@@ -779,7 +821,16 @@ gnc_split_register_load (SplitRegister *reg, GList * slist,
 
     gnc_table_refresh_gui (table, TRUE);
 
-    gnc_split_register_show_trans (reg, table->current_cursor_loc.vcell_loc);
+    /* After the load window grew, keep the rows that were on screen where
+     * they were instead of jumping to the cursor. */
+    if (anchor_row > 0)
+    {
+        VirtualCellLocation anchor_loc = { anchor_row, 0 };
+        gnc_table_show_at_top (table, anchor_loc);
+    }
+    else
+        gnc_split_register_show_trans (reg, table->current_cursor_loc.vcell_loc);
+    info->window_anchor_guid = *guid_null ();
 
     /* enable callback for cursor user-driven moves */
     gnc_table_control_allow_move (table->control, TRUE);
@@ -833,4 +884,24 @@ gnc_split_register_load_xfer_cells (SplitRegister *reg, Account *base_account)
     gnc_combo_cell_use_list_store_cache (cell, store);
 }
 
+/* The description, notes and memo cells complete from the texts of the
+ * whole book, which all registers share. */
+static void
+gnc_split_register_load_quickfill_cells (SplitRegister *reg)
+{
+    QofBook *book = gnc_get_current_book ();
+
+    gnc_quickfill_cell_use_quickfill_cache
+    ((QuickFillCell *) gnc_table_layout_get_cell (reg->table->layout, DESC_CELL),
+     gnc_get_shared_trans_desc_quickfill (book));
+
+    gnc_quickfill_cell_use_quickfill_cache
+    ((QuickFillCell *) gnc_table_layout_get_cell (reg->table->layout, NOTES_CELL),
+     gnc_get_shared_trans_notes_quickfill (book));
+
+    gnc_quickfill_cell_use_quickfill_cache
+    ((QuickFillCell *) gnc_table_layout_get_cell (reg->table->layout, MEMO_CELL),
+     gnc_get_shared_split_memo_quickfill (book));
+}
+
 /* ====================== END OF FILE ================================== */
@@ -100,6 +100,18 @@ struct sr_info
     /** true if we are loading the register for the first time */
     gboolean first_pass;
 
+    /** The most splits to load into the register, 0 to load them all */
+    gint load_window;
+
+    /** How many of the oldest splits the last load left out */
+    gint unloaded_splits;
+
+    /** The first split the last load put in the register */
+    GncGUID window_first_guid;
+
+    /** A split to keep at the top of the register when the window grows */
+    GncGUID window_anchor_guid;
+
     /** true if the user has already confirmed changes of a reconciled
      * split */
     gboolean change_confirmed;
@@ -51,6 +51,8 @@ gnc_split_register_init_info (SplitRegister *reg)
     info->pending_trans_guid = *guid_null ();
     info->default_account = *guid_null ();
     info->template_account = *guid_null ();
+    info->window_first_guid = *guid_null ();
+    info->window_anchor_guid = *guid_null ();
 
     info->last_date_entered = gnc_time64_get_today_start ();
 
@@ -2453,6 +2453,50 @@ gnc_split_register_show_present_divider (SplitRegister *reg,
     info->show_present_divider = show_present;
 }
 
+void
+gnc_split_register_set_load_window (SplitRegister *reg, gint max_splits)
+{
+    SRInfo *info = gnc_split_register_get_info (reg);
+
+    if (!info)
+        return;
+
+    info->load_window = MAX (max_splits, 0);
+}
+
+gint
+gnc_split_register_get_unloaded_splits (SplitRegister *reg)
+{
+    SRInfo *info = gnc_split_register_get_info (reg);
+
+    if (!info)
+        return 0;
+
+    return info->unloaded_splits;
+}
+
+gboolean
+gnc_split_register_extend_load_window (SplitRegister *reg, gint n_splits)
+{
+    SRInfo *info = gnc_split_register_get_info (reg);
+
+    if (!info || info->load_window == 0 || info->unloaded_splits == 0)
+        return FALSE;
+
+    if (n_splits <= 0)
+    {
+        info->load_window = 0;
+        info->window_anchor_guid = *guid_null ();
+    }
+    else
+    {
+        info->load_window += n_splits;
+        info->window_anchor_guid = info->window_first_guid;
+    }
+
+    return TRUE;
+}
+
 gboolean
 gnc_split_register_full_refresh_ok (SplitRegister *reg)
 {
@@ -523,6 +523,38 @@ gboolean gnc_split_register_changed (SplitRegister *reg);
 void gnc_split_register_show_present_divider (SplitRegister *reg,
         gboolean show_present);
 
+/** Load at most max_splits of the newest splits into the register, so
+ * that long registers open quickly. Older splits are loaded on demand
+ * with gnc_split_register_extend_load_window(). The transaction being
+ * edited and the one holding the cursor are always loaded. The window only
+ * applies while the splits are sorted oldest first; otherwise all of them
+ * are loaded.
+ *
+ * @param reg The register.
+ * @param max_splits The window size, 0 to load all splits.
+ */
+void gnc_split_register_set_load_window (SplitRegister *reg, gint max_splits);
+
+/** Grow the load window to take in older splits. The next load keeps the
+ * split which was at the top of the register at the top of the view, so
+ * the user's scroll position doesn't jump.
+ *
+ * @param reg The register.
+ * @param n_splits How many more splits to load, 0 or less to load them all.
+ * @return TRUE if the last load left splits out, and the register must be
+ * reloaded to show them.
+ */
+gboolean gnc_split_register_extend_load_window (SplitRegister *reg,
+                                                gint n_splits);
+
+/** Report how many of the oldest splits the last load left out of the
+ * register because of the load window.
+ *
+ * @param reg The register.
+ * @return The number of splits not loaded, 0 if all of them were.
+ */
+gint gnc_split_register_get_unloaded_splits (SplitRegister *reg);
+
 /** Expand the current transaction if it is collapsed. */
 void gnc_split_register_expand_current_trans (SplitRegister *reg,
         gboolean expand);
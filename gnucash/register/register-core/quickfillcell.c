@@ -244,14 +244,17 @@ gnc_quickfill_cell_modify_verify (BasicCell *_cell,
     gnc_basic_cell_set_value_internal (&cell->cell, match_str);
 }
 
-/* when leaving cell, make sure that text was put into the qf */
+/* when leaving cell, make sure that text was put into the qf. A shared
+ * quickfill only learns texts once they are committed, not ones that were
+ * typed and then abandoned. */
 
 static void
 gnc_quickfill_cell_leave (BasicCell * _cell)
 {
     QuickFillCell *cell = (QuickFillCell *) _cell;
 
-    gnc_quickfill_insert (cell->qf, _cell->value, cell->sort);
+    if (!cell->use_quickfill_cache)
+        gnc_quickfill_insert (cell->qf, _cell->value, cell->sort);
 }
 
 static void
@@ -311,7 +314,8 @@ gnc_quickfill_cell_set_value (QuickFillCell *cell, const char * value)
         return;
 
     gnc_basic_cell_set_value_internal (&cell->cell, value);
-    gnc_quickfill_insert (cell->qf, value, cell->sort);
+    if (!cell->use_quickfill_cache)
+        gnc_quickfill_insert (cell->qf, value, cell->sort);
 }
 
 void
@@ -345,6 +345,10 @@ void        gnc_table_show_range (Table *table,
                                   VirtualCellLocation start_loc,
                                   VirtualCellLocation end_loc);
 
+/** Scroll the register so the given location is at the top of the view. */
+void        gnc_table_show_at_top (Table *table,
+                                   VirtualCellLocation vcell_loc);
+
 /** Refresh the cursor in the given location. If do_scroll is TRUE,
  * scroll the register so the location is in view. */
 void        gnc_table_refresh_cursor_gui (Table * table,
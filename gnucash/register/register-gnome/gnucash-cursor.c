@@ -77,7 +77,7 @@ gnucash_cursor_get_pixel_coords (GnucashCursor *cursor,
             break;
     }
 
-    *y = block->origin_y;
+    *y = gnucash_sheet_block_origin_y (sheet, vcell_loc);
 
     cd = gnucash_style_get_cell_dimensions (block->style, 0, col);
     if (cd)
@@ -225,7 +225,7 @@ gnc_item_edit_get_pixel_coords (GncItemEdit *item_edit,
         return;
 
     xd = block->origin_x;
-    yd = block->origin_y;
+    yd = gnucash_sheet_block_origin_y (sheet, item_edit->virt_loc.vcell_loc);
 
     gnucash_sheet_style_get_cell_pixel_rel_coords
     (item_edit->style,
@@ -63,27 +63,13 @@ find_block_by_pixel (GnucashSheet *sheet,
     g_return_val_if_fail(y >= 0, NULL);
     g_return_val_if_fail(x >= 0, NULL);
 
-    do
-    {
-        block = gnucash_sheet_get_block (sheet, vc_loc);
-        if (!block)
-            return NULL;
-
-        if (block->visible &&
-                y >= block->origin_y &&
-                y < block->origin_y + block->style->dimensions->height)
-        {
-            if (vcell_loc)
-                vcell_loc->virt_row = vc_loc.virt_row;
-            break;
-        }
-        vc_loc.virt_row++;
-    }
-    while (vc_loc.virt_row < sheet->num_virt_rows);
-
-    if (vc_loc.virt_row == sheet->num_virt_rows)
+    vc_loc.virt_row = gnucash_sheet_y_pixel_to_block (sheet, y);
+    if (vc_loc.virt_row >= sheet->num_virt_rows)
         return NULL;
 
+    if (vcell_loc)
+        vcell_loc->virt_row = vc_loc.virt_row;
+
     do
     {
         block = gnucash_sheet_get_block (sheet, vc_loc);
@@ -126,7 +112,7 @@ find_cell_by_pixel (GnucashSheet *sheet, gint x, gint y,
 
     /* now make x, y relative to the block origin */
     x -= block->origin_x;
-    y -= block->origin_y;
+    y -= gnucash_sheet_block_origin_y (sheet, virt_loc->vcell_loc);
 
     style = block->style;
     if (style == NULL)
@@ -386,12 +372,11 @@ draw_cell (GnucashSheet *sheet,
     PhysicalCellBorders borders;
     const char *text;
     PangoLayout *layout;
-    PangoContext *context;
-    PangoFontDescription *font;
     PangoRectangle logical_rect;
     GdkRGBA *bg_color, *fg_color;
     GdkRectangle rect;
     gboolean hatching;
+    gboolean italic = FALSE;
     guint32 color_type;
     int x_offset;
     GtkStyleContext *stylectxt = gtk_widget_get_style_context (GTK_WIDGET(sheet));
@@ -479,16 +464,9 @@ draw_cell (GnucashSheet *sheet,
 
     text = gnc_table_get_entry (table, virt_loc);
 
-    layout = gtk_widget_create_pango_layout (GTK_WIDGET (sheet), text);
-
     if (gtk_style_context_has_class (stylectxt, GTK_STYLE_CLASS_VIEW))
         gtk_style_context_remove_class (stylectxt, GTK_STYLE_CLASS_VIEW);
 
-    // We don't need word wrap or line wrap
-    pango_layout_set_width (layout, -1);
-    context = pango_layout_get_context (layout);
-    font = pango_font_description_copy (pango_context_get_font_description (context));
-
 #ifdef READONLY_LINES_WITH_CHANGED_FG_COLOR
     // Are we in a read-only row? Then make the foreground color somewhat less black
     if ((virt_loc.phys_row_offset < block->style->nrows)
@@ -513,9 +491,7 @@ draw_cell (GnucashSheet *sheet,
         // Make text color greyed
         gtk_style_context_add_class (stylectxt, "lighter-grey-mix");
 
-        pango_layout_set_text (layout, text, strlen (text));
-        pango_font_description_set_style (font, PANGO_STYLE_ITALIC);
-        pango_context_set_font_description (context, font);
+        italic = TRUE;
     }
 
     if ((text == NULL) || (*text == '\0'))
@@ -523,6 +499,7 @@ draw_cell (GnucashSheet *sheet,
         goto exit;
     }
 
+    layout = gnucash_sheet_get_text_layout (sheet, text, italic);
     pango_layout_get_pixel_extents (layout, NULL, &logical_rect);
 
     gnucash_sheet_set_text_bounds (sheet, &rect, x, y, width, height);
@@ -540,11 +517,6 @@ draw_cell (GnucashSheet *sheet,
     cairo_restore (cr);
 
 exit:
-    pango_font_description_set_style (font, PANGO_STYLE_NORMAL);
-    pango_context_set_font_description (context, font);
-    pango_font_description_free (font);
-    g_object_unref (layout);
-
     gtk_style_context_restore (stylectxt);
 }
 
@@ -552,6 +524,7 @@ static void
 draw_block (GnucashSheet *sheet,
             SheetBlock *block,
             VirtualLocation virt_loc,
+            gint origin_y,
             cairo_t *cr,
             int x, int y, int width, int height)
 {
@@ -577,7 +550,7 @@ draw_block (GnucashSheet *sheet,
             if (x_paint > width)
                 break;
 
-            y_paint = block->origin_y + cd->origin_y - y;
+            y_paint = origin_y + cd->origin_y - y;
             if (y_paint > height)
                 return;
 
@@ -605,6 +578,7 @@ gnucash_sheet_draw_internal (GnucashSheet* sheet, cairo_t* cr,
 {
     VirtualLocation virt_loc;
     SheetBlock *sheet_block;
+    gint block_y;
     int x = 0;
     int y = 0;
     int width = alloc->width;
@@ -625,6 +599,8 @@ gnucash_sheet_draw_internal (GnucashSheet* sheet, cairo_t* cr,
     if (!sheet_block || !sheet_block->style)
         return FALSE;
 
+    block_y = gnucash_sheet_block_origin_y (sheet, virt_loc.vcell_loc);
+
     for ( ; virt_loc.vcell_loc.virt_row < sheet->num_virt_rows;
             virt_loc.vcell_loc.virt_row++ )
     {
@@ -642,11 +618,13 @@ gnucash_sheet_draw_internal (GnucashSheet* sheet, cairo_t* cr,
             virt_loc.vcell_loc.virt_row++;
         }
 
-        if (y + height < sheet_block->origin_y)
+        if (y + height < block_y)
             return TRUE;
 
-        draw_block (sheet, sheet_block, virt_loc, cr,
+        draw_block (sheet, sheet_block, virt_loc, block_y, cr,
                     x, y, width, height);
+
+        block_y += sheet_block->style->dimensions->height;
     }
 
     return TRUE;
@@ -303,6 +303,119 @@ gnucash_sheet_get_text_offset (GnucashSheet *sheet, const VirtualLocation virt_l
     return x_offset;
 }
 
+/* Registers draw the same few strings over and over: account names,
+ * reconcile flags, amounts, and so on. Shaping them is the costly part of
+ * drawing a cell, so the sheet keeps the layouts it made last in a cache
+ * keyed by the text and whether it's in italics. All the layouts share the
+ * widget's Pango context and are never wrapped, so those are the only
+ * things that vary. */
+#define LAYOUT_CACHE_SIZE 1024
+
+typedef struct
+{
+    gchar *key;
+    PangoLayout *layout;
+} SheetLayout;
+
+static void
+gnucash_sheet_layout_free (gpointer data)
+{
+    SheetLayout *sl = data;
+
+    g_free (sl->key);
+    g_object_unref (sl->layout);
+    g_free (sl);
+}
+
+PangoLayout *
+gnucash_sheet_get_text_layout (GnucashSheet *sheet, const char *text,
+                               gboolean italic)
+{
+    SheetLayout *sl;
+    GList *link;
+    gchar *key;
+
+    g_return_val_if_fail (GNUCASH_IS_SHEET (sheet), NULL);
+
+    if (text == NULL)
+        text = "";
+
+    key = g_strconcat (italic ? "i" : "n", text, NULL);
+    link = g_hash_table_lookup (sheet->layout_cache, key);
+    if (link)
+    {
+        g_free (key);
+        sheet->layout_cache_hits++;
+        g_queue_unlink (&sheet->layout_lru, link);
+        g_queue_push_head_link (&sheet->layout_lru, link);
+        return ((SheetLayout *) link->data)->layout;
+    }
+
+    sheet->layout_cache_misses++;
+
+    if (g_queue_get_length (&sheet->layout_lru) >= LAYOUT_CACHE_SIZE)
+    {
+        sl = g_queue_pop_tail (&sheet->layout_lru);
+        g_hash_table_remove (sheet->layout_cache, sl->key);
+        gnucash_sheet_layout_free (sl);
+    }
+
+    sl = g_new (SheetLayout, 1);
+    sl->key = key;
+    sl->layout = pango_layout_new (gtk_widget_get_pango_context (GTK_WIDGET (sheet)));
+    pango_layout_set_text (sl->layout, text, -1);
+
+    // We don't need word wrap or line wrap
+    pango_layout_set_width (sl->layout, -1);
+
+    if (italic)
+    {
+        PangoFontDescription *font;
+
+        font = pango_font_description_copy
+               (pango_context_get_font_description
+                (pango_layout_get_context (sl->layout)));
+        pango_font_description_set_style (font, PANGO_STYLE_ITALIC);
+        pango_layout_set_font_description (sl->layout, font);
+        pango_font_description_free (font);
+    }
+
+    g_queue_push_head (&sheet->layout_lru, sl);
+    g_hash_table_insert (sheet->layout_cache, sl->key,
+                         g_queue_peek_head_link (&sheet->layout_lru));
+
+    return sl->layout;
+}
+
+void
+gnucash_sheet_clear_layout_cache (GnucashSheet *sheet)
+{
+    g_return_if_fail (GNUCASH_IS_SHEET (sheet));
+
+    if (!sheet->layout_cache)
+        return;
+
+    DEBUG("layout cache had %u layouts, %u hits, %u misses",
+          g_queue_get_length (&sheet->layout_lru),
+          sheet->layout_cache_hits, sheet->layout_cache_misses);
+
+    g_hash_table_remove_all (sheet->layout_cache);
+    while (!g_queue_is_empty (&sheet->layout_lru))
+        gnucash_sheet_layout_free (g_queue_pop_head (&sheet->layout_lru));
+}
+
+void
+gnucash_sheet_get_layout_cache_stats (GnucashSheet *sheet,
+                                      guint *hits, guint *misses)
+{
+    g_return_if_fail (GNUCASH_IS_SHEET (sheet));
+
+    if (hits)
+        *hits = sheet->layout_cache_hits;
+    if (misses)
+        *misses = sheet->layout_cache_misses;
+}
+
 static gint
 gnucash_sheet_get_text_cursor_position (GnucashSheet *sheet, const VirtualLocation virt_loc)
 {
@@ -323,10 +436,7 @@ gnucash_sheet_get_text_cursor_position (GnucashSheet *sheet, const VirtualLocati
     // Get the item_edit position
     gnc_item_edit_get_pixel_coords (item_edit, &x, &y, &width, &height);
 
-    layout = gtk_widget_create_pango_layout (GTK_WIDGET (sheet), text);
-
-    // We don't need word wrap or line wrap
-    pango_layout_set_width (layout, -1);
+    layout = gnucash_sheet_get_text_layout (sheet, text, FALSE);
 
     pango_layout_get_pixel_extents (layout, NULL, &logical_rect);
 
@@ -339,8 +449,6 @@ gnucash_sheet_get_text_cursor_position (GnucashSheet *sheet, const VirtualLocati
                  PANGO_SCALE * (sheet->button_x - rect.x - x_offset),
                  PANGO_SCALE * (height/2), &index, &trailing);
 
-    g_object_unref (layout);
-
     return index + trailing;
 }
 
@@ -464,26 +572,71 @@ gnucash_sheet_cursor_move (GnucashSheet *sheet, VirtualLocation virt_loc)
 }
 
 
+/* The heights of the blocks are kept in a Fenwick tree indexed by virtual
+ * row, so finding the y origin of a row, or the row at a y offset, doesn't
+ * have to walk every block above it. Hidden blocks and the header, which
+ * is drawn outside the sheet, take no height. */
 static gint
-gnucash_sheet_y_pixel_to_block (GnucashSheet *sheet, int y)
+gnucash_sheet_block_height (SheetBlock *block, gint virt_row)
 {
-    VirtualCellLocation vcell_loc = { 1, 0 };
+    if (virt_row == 0 || !block || !block->visible || !block->style)
+        return 0;
 
-    for (;
-            vcell_loc.virt_row < sheet->num_virt_rows;
-            vcell_loc.virt_row++)
-    {
-        SheetBlock *block;
+    return block->style->dimensions->height;
+}
 
-        block = gnucash_sheet_get_block (sheet, vcell_loc);
-        if (!block || !block->visible)
-            continue;
+static void
+gnucash_sheet_block_height_changed (GnucashSheet *sheet, gint virt_row,
+                                    gint delta)
+{
+    gint i;
 
-        if (block->origin_y + block->style->dimensions->height > y)
-            break;
+    if (delta == 0 || virt_row >= sheet->num_block_heights)
+        return;
+
+    for (i = virt_row + 1; i <= sheet->num_block_heights; i += i & -i)
+        sheet->block_heights[i] += delta;
+
+    sheet->height += delta;
+}
+
+gint
+gnucash_sheet_block_origin_y (GnucashSheet *sheet,
+                              VirtualCellLocation vcell_loc)
+{
+    gint i, y = 0;
+
+    g_return_val_if_fail (sheet != NULL, 0);
+    g_return_val_if_fail (GNUCASH_IS_SHEET (sheet), 0);
+
+    for (i = MIN (vcell_loc.virt_row, sheet->num_block_heights); i > 0;
+         i -= i & -i)
+        y += sheet->block_heights[i];
+
+    return y;
+}
+
+/* Return the first visible row which ends below y, or num_virt_rows if
+ * y is past the end of the sheet. */
+gint
+gnucash_sheet_y_pixel_to_block (GnucashSheet *sheet, gint y)
+{
+    gint step, row = 0;
+
+    for (step = 1; step * 2 <= sheet->num_block_heights; step *= 2)
+        ;
+
+    for (; step > 0; step /= 2)
+    {
+        if (row + step <= sheet->num_block_heights &&
+            sheet->block_heights[row + step] <= y)
+        {
+            row += step;
+            y -= sheet->block_heights[row];
+        }
     }
 
-    return vcell_loc.virt_row;
+    return CLAMP (row, 1, MAX (sheet->num_virt_rows, 1));
 }
 
 
@@ -494,7 +647,7 @@ gnucash_sheet_compute_visible_range (GnucashSheet *sheet)
     GtkAllocation alloc;
     GtkAdjustment *adj;
     gint height;
-    gint cy;
+    gint cy, y;
     gint top_block;
 //    gint old_visible_blocks, old_visible_rows;
 
@@ -514,9 +667,11 @@ gnucash_sheet_compute_visible_range (GnucashSheet *sheet)
     sheet->num_visible_blocks = 0;
     sheet->num_visible_phys_rows = 0;
 
-    for ( vcell_loc.virt_row = top_block, vcell_loc.virt_col = 0;
-            vcell_loc.virt_row < sheet->num_virt_rows;
-            vcell_loc.virt_row++ )
+    vcell_loc.virt_row = top_block;
+    vcell_loc.virt_col = 0;
+    y = gnucash_sheet_block_origin_y (sheet, vcell_loc);
+
+    for ( ; vcell_loc.virt_row < sheet->num_virt_rows; vcell_loc.virt_row++ )
     {
         SheetBlock *block;
 
@@ -527,8 +682,8 @@ gnucash_sheet_compute_visible_range (GnucashSheet *sheet)
         sheet->num_visible_blocks++;
         sheet->num_visible_phys_rows += block->style->nrows;
 
-        if (block->origin_y - cy + block->style->dimensions->height
-                >= height)
+        y += block->style->dimensions->height;
+        if (y - cy >= height)
             break;
     }
 }
@@ -565,7 +720,7 @@ gnucash_sheet_show_row (GnucashSheet *sheet, gint virt_row)
 
     block = gnucash_sheet_get_block (sheet, vcell_loc);
 
-    y = block->origin_y;
+    y = gnucash_sheet_block_origin_y (sheet, vcell_loc);
     block_height = block->style->dimensions->height;
 
     if ((cy <= y) && (cy + height >= y + block_height))
@@ -645,8 +800,8 @@ gnucash_sheet_show_range (GnucashSheet *sheet,
     start_block = gnucash_sheet_get_block (sheet, start_loc);
     end_block = gnucash_sheet_get_block (sheet, end_loc);
 
-    y = start_block->origin_y;
-    block_height = (end_block->origin_y +
+    y = gnucash_sheet_block_origin_y (sheet, start_loc);
+    block_height = (gnucash_sheet_block_origin_y (sheet, end_loc) +
                     end_block->style->dimensions->height) - y;
 
     if ((cy <= y) && (cy + height >= y + block_height))
@@ -674,6 +829,40 @@ gnucash_sheet_show_range (GnucashSheet *sheet,
 }
 
 
+void
+gnucash_sheet_show_at_top (GnucashSheet *sheet, VirtualCellLocation vcell_loc)
+{
+    SheetBlock *block;
+    GtkAllocation alloc;
+    gint y;
+
+    g_return_if_fail (sheet != NULL);
+    g_return_if_fail (GNUCASH_IS_SHEET(sheet));
+
+    vcell_loc.virt_row = MAX (vcell_loc.virt_row, 1);
+    vcell_loc.virt_row = MIN (vcell_loc.virt_row,
+                              sheet->num_virt_rows - 1);
+
+    block = gnucash_sheet_get_block (sheet, vcell_loc);
+    if (!block)
+        return;
+
+    gtk_widget_get_allocation (GTK_WIDGET(sheet), &alloc);
+
+    y = gnucash_sheet_block_origin_y (sheet, vcell_loc);
+    if ((sheet->height - y) < alloc.height)
+        y = sheet->height - alloc.height;
+    if (y < 0)
+        y = 0;
+
+    if (y != gtk_adjustment_get_value (sheet->vadj))
+        gtk_adjustment_set_value (sheet->vadj, y);
+
+    gnucash_sheet_compute_visible_range (sheet);
+    gnucash_sheet_update_adjustments (sheet);
+}
+
+
 void
 gnucash_sheet_update_adjustments (GnucashSheet *sheet)
 {
@@ -698,6 +887,11 @@ gnucash_sheet_vadjustment_value_changed (GtkAdjustment *adj,
         GnucashSheet *sheet)
 {
     gnucash_sheet_compute_visible_range (sheet);
+
+    /* Let the register load older rows, if it left any out. */
+    if (sheet->reg &&
+        gtk_adjustment_get_value (adj) <= gtk_adjustment_get_lower (adj))
+        g_signal_emit_by_name (sheet->reg, "scrolled_to_top");
 }
 
 
@@ -736,7 +930,7 @@ gnucash_sheet_redraw_block (GnucashSheet *sheet, VirtualCellLocation vcell_loc)
         return;
 
     x = block->origin_x;
-    y = block->origin_y;
+    y = gnucash_sheet_block_origin_y (sheet, vcell_loc);
 
     gtk_widget_get_allocation (GTK_WIDGET(sheet), &alloc);
     h = block->style->dimensions->height;
@@ -754,6 +948,18 @@ gnucash_sheet_is_read_only (GnucashSheet *sheet)
     return gnc_table_model_read_only (sheet->table->model);
 }
 
+static void
+gnucash_sheet_style_updated (GtkWidget *widget)
+{
+    GnucashSheet *sheet = GNUCASH_SHEET (widget);
+
+    if (GTK_WIDGET_CLASS (sheet_parent_class)->style_updated)
+        (*GTK_WIDGET_CLASS (sheet_parent_class)->style_updated)(widget);
+
+    /* The font may have changed. */
+    gnucash_sheet_clear_layout_cache (sheet);
+}
+
 static void
 gnucash_sheet_finalize (GObject *object)
 {
@@ -764,6 +970,12 @@ gnucash_sheet_finalize (GObject *object)
     g_table_destroy (sheet->blocks);
     sheet->blocks = NULL;
 
+    g_free (sheet->block_heights);
+    sheet->block_heights = NULL;
+
+    gnucash_sheet_clear_layout_cache (sheet);
+    g_hash_table_destroy (sheet->layout_cache);
+
     gnucash_sheet_clear_styles (sheet);
 
     g_hash_table_destroy (sheet->cursor_styles);
@@ -2181,6 +2393,8 @@ gnucash_sheet_block_set_from_table (GnucashSheet *sheet,
     SheetBlock *block;
     SheetBlockStyle *style;
     VirtualCell *vcell;
+    gboolean changed = FALSE;
+    gint old_height, new_height;
 
     block = gnucash_sheet_get_block (sheet, vcell_loc);
     style = gnucash_sheet_get_style_from_table (sheet, vcell_loc);
@@ -2192,6 +2406,8 @@ gnucash_sheet_block_set_from_table (GnucashSheet *sheet,
 
     vcell = gnc_table_get_virtual_cell (table, vcell_loc);
 
+    old_height = gnucash_sheet_block_height (block, vcell_loc.virt_row);
+
     if (block->style && (block->style != style))
     {
         gnucash_style_unref (block->style);
@@ -2204,10 +2420,18 @@ gnucash_sheet_block_set_from_table (GnucashSheet *sheet,
     {
         block->style = style;
         gnucash_style_ref(block->style);
-        return TRUE;
+        changed = TRUE;
     }
 
-    return FALSE;
+    new_height = gnucash_sheet_block_height (block, vcell_loc.virt_row);
+    if (new_height != old_height)
+    {
+        gnucash_sheet_block_height_changed (sheet, vcell_loc.virt_row,
+                                            new_height - old_height);
+        changed = TRUE;
+    }
+
+    return changed;
 }
 
 
@@ -2220,7 +2444,6 @@ gnucash_sheet_col_max_width (GnucashSheet *sheet, gint virt_col, gint cell_col)
     int width;
     SheetBlock *block;
     SheetBlockStyle *style;
-    PangoLayout *layout = gtk_widget_create_pango_layout (GTK_WIDGET (sheet), "");
     GncItemEdit *item_edit = GNC_ITEM_EDIT(sheet->item_editor);
 
     g_return_val_if_fail (virt_col >= 0, 0);
@@ -2258,8 +2481,9 @@ gnucash_sheet_col_max_width (GnucashSheet *sheet, gint virt_col, gint cell_col)
                            (sheet->table, virt_loc);
                 }
 
-                pango_layout_set_text (layout, text, strlen (text));
-                pango_layout_get_pixel_size (layout, &width, NULL);
+                pango_layout_get_pixel_size
+                    (gnucash_sheet_get_text_layout (sheet, text, FALSE),
+                     &width, NULL);
 
                 width += gnc_item_edit_get_margin (item_edit, left_right);
 
@@ -2267,8 +2491,6 @@ gnucash_sheet_col_max_width (GnucashSheet *sheet, gint virt_col, gint cell_col)
             }
     }
 
-    g_object_unref (layout);
-
     return max;
 }
 
@@ -2353,6 +2575,11 @@ gnucash_sheet_recompute_block_offsets (GnucashSheet *sheet)
 
     table = sheet->table;
 
+    sheet->num_block_heights = table->num_virt_rows;
+    sheet->block_heights = g_renew (gint, sheet->block_heights,
+                                    sheet->num_block_heights + 1);
+    sheet->block_heights[0] = 0;
+
     height = 0;
     block = NULL;
     for (i = 0; i < table->num_virt_rows; i++)
@@ -2366,14 +2593,21 @@ gnucash_sheet_recompute_block_offsets (GnucashSheet *sheet)
             block = gnucash_sheet_get_block (sheet, vcell_loc);
 
             block->origin_x = width;
-            block->origin_y = height;
 
             if (block->visible)
                 width += block->style->dimensions->width;
         }
 
-        if (i > 0 && block->visible)
-            height += block->style->dimensions->height;
+        sheet->block_heights[i + 1] = gnucash_sheet_block_height (block, i);
+        height += sheet->block_heights[i + 1];
+    }
+
+    /* Turn the heights into the tree in place. */
+    for (i = 1; i <= sheet->num_block_heights; i++)
+    {
+        j = i + (i & -i);
+        if (j <= sheet->num_block_heights)
+            sheet->block_heights[j] += sheet->block_heights[i];
     }
 
     sheet->height = height;
@@ -2530,6 +2764,7 @@ gnucash_sheet_class_init (GnucashSheetClass *klass)
     widget_class->button_press_event = gnucash_sheet_button_press_event;
     widget_class->button_release_event = gnucash_sheet_button_release_event;
     widget_class->scroll_event = gnucash_scroll_event;
+    widget_class->style_updated = gnucash_sheet_style_updated;
 }
 
 
@@ -2559,6 +2794,11 @@ gnucash_sheet_init (GnucashSheet *sheet)
     sheet->window_height = -1;
     sheet->width = 0;
     sheet->height = 0;
+    sheet->block_heights = NULL;
+    sheet->num_block_heights = 0;
+
+    sheet->layout_cache = g_hash_table_new (g_str_hash, g_str_equal);
+    g_queue_init (&sheet->layout_lru);
 
     sheet->cursor_styles = g_hash_table_new (g_str_hash, g_str_equal);
 
@@ -50,7 +50,6 @@ typedef struct
     SheetBlockStyle *style;
 
     gint origin_x; /** x origin of block */
-    gint origin_y; /** y origin of block */
 
     gboolean visible; /** is block visible */
 } SheetBlock;
@@ -66,6 +65,11 @@ void gnucash_sheet_recompute_block_offsets (GnucashSheet *sheet);
 SheetBlock *gnucash_sheet_get_block (GnucashSheet *sheet,
                                      VirtualCellLocation vcell_loc);
 
+/** Return the y origin of the block at vcell_loc, in pixels from the top of
+ * the sheet. */
+gint gnucash_sheet_block_origin_y (GnucashSheet *sheet,
+                                   VirtualCellLocation vcell_loc);
+
 gint gnucash_sheet_col_max_width (GnucashSheet *sheet,
                                   gint virt_col, gint cell_col);
 
@@ -97,6 +101,11 @@ void gnucash_sheet_show_range (GnucashSheet *sheet,
                                VirtualCellLocation start_loc,
                                VirtualCellLocation end_loc);
 
+/** Scroll the sheet so that the block at vcell_loc is at the top of the view,
+ * or as near to it as the length of the sheet allows. */
+void gnucash_sheet_show_at_top (GnucashSheet *sheet,
+                                VirtualCellLocation vcell_loc);
+
 void gnucash_sheet_update_adjustments (GnucashSheet *sheet);
 
 void gnucash_sheet_set_window (GnucashSheet *sheet, GtkWidget *window);
@@ -110,6 +119,26 @@ void gnucash_sheet_set_text_bounds (GnucashSheet *sheet, GdkRectangle *rect,
 gint gnucash_sheet_get_text_offset (GnucashSheet *sheet, const VirtualLocation virt_loc,
                                     gint rect_width, gint logical_width);
 
+/** Return a layout of text in the sheet's font, from a cache of the most
+ * recently used ones. The layout belongs to the cache and is only good until
+ * the next call.
+ *
+ * @param sheet The sheet.
+ * @param text The text to lay out.
+ * @param italic TRUE for an italic layout, as used for cell labels.
+ */
+PangoLayout *gnucash_sheet_get_text_layout (GnucashSheet *sheet,
+                                            const char *text,
+                                            gboolean italic);
+
+/** Empty the layout cache, for when the sheet's font changes. */
+void gnucash_sheet_clear_layout_cache (GnucashSheet *sheet);
+
+/** Report how often gnucash_sheet_get_text_layout() found a layout in the
+ * cache and how often it had to make a new one. */
+void gnucash_sheet_get_layout_cache_stats (GnucashSheet *sheet,
+                                           guint *hits, guint *misses);
+
 gboolean gnucash_sheet_is_read_only (GnucashSheet *sheet);
 
 /** @} */
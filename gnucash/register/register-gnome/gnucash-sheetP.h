@@ -75,6 +75,16 @@ struct _GnucashSheet
     gint width;  /* the width in pixels of the sheet */
     gint height;
 
+    /* Fenwick tree of block heights, indexed by virtual row + 1 */
+    gint *block_heights;
+    gint num_block_heights;
+
+    /* Most recently used text layouts, see gnucash_sheet_get_text_layout */
+    GHashTable *layout_cache;
+    GQueue layout_lru;
+    guint layout_cache_hits;
+    guint layout_cache_misses;
+
     gint window_height;
     gint window_width;
 
@@ -132,6 +142,7 @@ void gnucash_sheet_refresh_from_prefs (GnucashSheet *sheet);
 
 gboolean   gnucash_sheet_find_loc_by_pixel (GnucashSheet *sheet, gint x, gint y,
                                            VirtualLocation *vcell_loc);
+gint gnucash_sheet_y_pixel_to_block (GnucashSheet *sheet, gint y);
 gboolean gnucash_sheet_draw_internal (GnucashSheet *sheet, cairo_t *cr,
                                       GtkAllocation *alloc);
 void gnucash_sheet_draw_cursor (GnucashCursor *cursor, cairo_t *cr);
@@ -204,7 +204,6 @@ gnc_table_refresh_cursor_gnome (Table * table,
 
     if (gnucash_sheet_block_set_from_table (sheet, vcell_loc))
     {
-        gnucash_sheet_recompute_block_offsets (sheet);
         gnucash_sheet_set_scroll_region (sheet);
         gnucash_sheet_compute_visible_range (sheet);
         gnucash_sheet_redraw_all (sheet);
@@ -236,6 +235,24 @@ gnc_table_show_range (Table *table,
     gnucash_sheet_show_range (sheet, start_loc, end_loc);
 }
 
+void
+gnc_table_show_at_top (Table *table, VirtualCellLocation vcell_loc)
+{
+    GnucashSheet *sheet;
+
+    if (!table || !table->ui_data)
+        return;
+
+    g_return_if_fail (GNUCASH_IS_SHEET (table->ui_data));
+
+    if (gnc_table_virtual_cell_out_of_bounds (table, vcell_loc))
+        return;
+
+    sheet = GNUCASH_SHEET (table->ui_data);
+
+    gnucash_sheet_show_at_top (sheet, vcell_loc);
+}
+
 void
 gnc_table_gnome_init (void)
 {
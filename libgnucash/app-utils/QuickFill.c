@@ -32,11 +32,18 @@
 #include "gnc-ui-util.h"
 
 
+typedef struct
+{
+    guint key;           /* upper-cased next character         */
+    QuickFill *qf;       /* node for strings with that char    */
+} QuickFillMatch;
+
 struct _QuickFill
 {
     char *text;          /* the first matching text string     */
     int len;             /* number of chars in text string     */
-    GHashTable *matches; /* array of children in the tree      */
+    guint n_matches;     /* number of children in the tree     */
+    QuickFillMatch *matches; /* children, sorted by key        */
 };
 
 
@@ -50,6 +57,99 @@ static void gnc_quickfill_remove_recursive (QuickFill *qf, const gchar *text,
 /* This static indicates the debugging module that this .o belongs to.  */
 static QofLogModule log_module = GNC_MOD_REGISTER;
 
+/* A tree holds a node for every character of every string in it, and most
+ * nodes have only one child, so the children are kept in a small sorted
+ * array rather than a hash table per node. */
+static gint
+quickfill_find_match (const QuickFill *qf, guint key)
+{
+    gint lo = 0, hi = (gint) qf->n_matches - 1;
+
+    while (lo <= hi)
+    {
+        gint mid = (lo + hi) / 2;
+
+        if (qf->matches[mid].key == key)
+            return mid;
+        if (qf->matches[mid].key < key)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+
+    return -(lo + 1);
+}
+
+/* Whether prefix starts text, comparing characters the way the tree's
+ * keys do, without regard to case. */
+static gboolean
+quickfill_is_prefix (const char *prefix, const char *text)
+{
+    while (*prefix)
+    {
+        if (!*text || g_unichar_toupper (g_utf8_get_char (prefix)) !=
+                      g_unichar_toupper (g_utf8_get_char (text)))
+            return FALSE;
+
+        prefix = g_utf8_next_char (prefix);
+        text = g_utf8_next_char (text);
+    }
+
+    return TRUE;
+}
+
+static QuickFill *
+quickfill_lookup (const QuickFill *qf, guint key)
+{
+    gint i = quickfill_find_match (qf, key);
+
+    return (i >= 0) ? qf->matches[i].qf : NULL;
+}
+
+static void
+quickfill_add_match (QuickFill *qf, guint key, QuickFill *match_qf)
+{
+    gint i = -(quickfill_find_match (qf, key) + 1);
+
+    qf->matches = g_renew (QuickFillMatch, qf->matches, qf->n_matches + 1);
+    memmove (qf->matches + i + 1, qf->matches + i,
+             (qf->n_matches - i) * sizeof (QuickFillMatch));
+    qf->matches[i].key = key;
+    qf->matches[i].qf = match_qf;
+    qf->n_matches++;
+}
+
+static void
+quickfill_remove_match (QuickFill *qf, guint key)
+{
+    gint i = quickfill_find_match (qf, key);
+
+    if (i < 0)
+        return;
+
+    qf->n_matches--;
+    memmove (qf->matches + i, qf->matches + i + 1,
+             (qf->n_matches - i) * sizeof (QuickFillMatch));
+    if (qf->n_matches == 0)
+    {
+        g_free (qf->matches);
+        qf->matches = NULL;
+    }
+}
+
+static void
+quickfill_destroy_matches (QuickFill *qf)
+{
+    guint i;
+
+    for (i = 0; i < qf->n_matches; i++)
+        gnc_quickfill_destroy (qf->matches[i].qf);
+
+    g_free (qf->matches);
+    qf->matches = NULL;
+    qf->n_matches = 0;
+}
+
 /********************************************************************\
 \********************************************************************/
 
@@ -69,7 +169,8 @@ gnc_quickfill_new (void)
     qf->text = NULL;
     qf->len = 0;
 
-    qf->matches = g_hash_table_new (g_direct_hash, g_direct_equal);
+    qf->n_matches = 0;
+    qf->matches = NULL;
 
     return qf;
 }
@@ -77,25 +178,16 @@ gnc_quickfill_new (void)
 /********************************************************************\
 \********************************************************************/
 
-static gboolean
-destroy_helper (gpointer key, gpointer value, gpointer data)
-{
-    gnc_quickfill_destroy (value);
-    return TRUE;
-}
-
 void
 gnc_quickfill_destroy (QuickFill *qf)
 {
     if (qf == NULL)
         return;
 
-    g_hash_table_foreach (qf->matches, (GHFunc)destroy_helper, NULL);
-    g_hash_table_destroy (qf->matches);
-    qf->matches = NULL;
+    quickfill_destroy_matches (qf);
 
     if (qf->text)
-        g_free(qf->text);
+        CACHE_REMOVE(qf->text);
     qf->text = NULL;
     qf->len = 0;
 
@@ -108,10 +200,10 @@ gnc_quickfill_purge (QuickFill *qf)
     if (qf == NULL)
         return;
 
-    g_hash_table_foreach_remove (qf->matches, destroy_helper, NULL);
+    quickfill_destroy_matches (qf);
 
     if (qf->text)
-        g_free (qf->text);
+        CACHE_REMOVE (qf->text);
     qf->text = NULL;
     qf->len = 0;
 }
@@ -140,7 +232,7 @@ gnc_quickfill_get_char_match (QuickFill *qf, gunichar uc)
 
     DEBUG ("xaccGetQuickFill(): index = %u\n", key);
 
-    return g_hash_table_lookup (qf->matches, GUINT_TO_POINTER (key));
+    return quickfill_lookup (qf, key);
 }
 
 /********************************************************************\
@@ -187,14 +279,6 @@ gnc_quickfill_get_string_match (QuickFill *qf, const char *str)
 /********************************************************************\
 \********************************************************************/
 
-static void
-unique_len_helper (gpointer key, gpointer value, gpointer data)
-{
-    QuickFill **qf_p = data;
-
-    *qf_p = value;
-}
-
 QuickFill *
 gnc_quickfill_get_unique_len_match (QuickFill *qf, int *length)
 {
@@ -204,16 +288,9 @@ gnc_quickfill_get_unique_len_match (QuickFill *qf, int *length)
     if (qf == NULL)
         return NULL;
 
-    while (1)
+    while (qf->n_matches == 1)
     {
-        guint count;
-
-        count = g_hash_table_size (qf->matches);
-
-        if (count != 1)
-            break;
-
-        g_hash_table_foreach (qf->matches, unique_len_helper, &qf);
+        qf = qf->matches[0].qf;
 
         if (length != NULL)
             (*length)++;
@@ -229,16 +306,20 @@ void
 gnc_quickfill_insert (QuickFill *qf, const char *text, QuickFillSort sort)
 {
     gchar *normalized_str;
+    char *cached_str;
     int len;
 
     if (NULL == qf) return;
     if (NULL == text) return;
 
 
+    /* Every node along the path shares the one cached copy of the text. */
     normalized_str = g_utf8_normalize (text, -1, G_NORMALIZE_NFC);
-    len = g_utf8_strlen (text, -1);
-    quickfill_insert_recursive (qf, normalized_str, len, normalized_str, sort);
+    cached_str = CACHE_INSERT (normalized_str);
     g_free (normalized_str);
+    len = g_utf8_strlen (text, -1);
+    quickfill_insert_recursive (qf, cached_str, len, cached_str, sort);
+    CACHE_REMOVE (cached_str);
 }
 
 /********************************************************************\
@@ -263,11 +344,11 @@ quickfill_insert_recursive (QuickFill *qf, const char *text, int len,
     key_char_uc = g_utf8_get_char (next_char);
     key = g_unichar_toupper (key_char_uc);
 
-    match_qf = g_hash_table_lookup (qf->matches, GUINT_TO_POINTER (key));
+    match_qf = quickfill_lookup (qf, key);
     if (match_qf == NULL)
     {
         match_qf = gnc_quickfill_new ();
-        g_hash_table_insert (qf->matches, GUINT_TO_POINTER (key), match_qf);
+        quickfill_add_match (qf, key, match_qf);
     }
 
     old_text = match_qf->text;
@@ -275,7 +356,8 @@ quickfill_insert_recursive (QuickFill *qf, const char *text, int len,
     switch (sort)
     {
     case QUICKFILL_ALPHA:
-        if (old_text && (g_utf8_collate (text, old_text) >= 0))
+        if (old_text && (CACHE_EQUAL (text, old_text) ||
+                         g_utf8_collate (text, old_text) >= 0))
             break;
         /* fall through */
 
@@ -284,18 +366,21 @@ quickfill_insert_recursive (QuickFill *qf, const char *text, int len,
         /* If there's no string there already, just put the new one in. */
         if (old_text == NULL)
         {
-            match_qf->text = g_strdup(text);
+            match_qf->text = CACHE_INSERT(text);
             match_qf->len = len;
             break;
         }
 
-        /* Leave prefixes in place */
-        if ((len > match_qf->len) &&
-                (strncmp(text, old_text, strlen(old_text)) == 0))
+        /* Leave prefixes, and the text itself, in place. A prefix in
+         * another case counts too, as lookups ignore case; replacing it
+         * would lose it for good once the longer text is removed. */
+        if (CACHE_EQUAL (text, old_text) ||
+                ((len > match_qf->len) &&
+                 quickfill_is_prefix (old_text, text)))
             break;
 
-        g_free(old_text);
-        match_qf->text = g_strdup(text);
+        match_qf->text = CACHE_INSERT(text);
+        CACHE_REMOVE(old_text);
         match_qf->len = len;
         break;
     }
@@ -310,13 +395,16 @@ void
 gnc_quickfill_remove (QuickFill *qf, const gchar *text, QuickFillSort sort)
 {
     gchar *normalized_str;
+    char *cached_str;
 
     if (qf == NULL) return;
     if (text == NULL) return;
 
     normalized_str = g_utf8_normalize (text, -1, G_NORMALIZE_NFC);
-    gnc_quickfill_remove_recursive (qf, normalized_str, 0, sort);
+    cached_str = CACHE_INSERT (normalized_str);
     g_free (normalized_str);
+    gnc_quickfill_remove_recursive (qf, cached_str, 0, sort);
+    CACHE_REMOVE (cached_str);
 }
 
 /********************************************************************\
@@ -329,11 +417,8 @@ struct _BestText
 };
 
 static void
-best_text_helper (gpointer key, gpointer value, gpointer user_data)
+best_text_helper (QuickFill *qf, struct _BestText *best)
 {
-    QuickFill *qf = value;
-    struct _BestText *best = user_data;
-
     if (best->text == NULL)
     {
         /* start with the first text */
@@ -361,6 +446,7 @@ gnc_quickfill_remove_recursive (QuickFill *qf, const gchar *text, gint depth,
 {
     QuickFill *match_qf;
     gchar *child_text;
+    gchar *old_text;
     gint child_len;
 
     child_text = NULL;
@@ -378,7 +464,7 @@ gnc_quickfill_remove_recursive (QuickFill *qf, const gchar *text, gint depth,
         key_char_uc = g_utf8_get_char (key_char);
         key = g_unichar_toupper (key_char_uc);
 
-        match_qf = g_hash_table_lookup (qf->matches, GUINT_TO_POINTER (key));
+        match_qf = quickfill_lookup (qf, key);
         if (match_qf)
         {
             /* remove text from child qf */
@@ -387,7 +473,7 @@ gnc_quickfill_remove_recursive (QuickFill *qf, const gchar *text, gint depth,
             if (match_qf->text == NULL)
             {
                 /* text was the only word with a prefix up to match_qf */
-                g_hash_table_remove (qf->matches, GUINT_TO_POINTER (key));
+                quickfill_remove_match (qf, key);
                 gnc_quickfill_destroy (match_qf);
 
             }
@@ -403,7 +489,7 @@ gnc_quickfill_remove_recursive (QuickFill *qf, const gchar *text, gint depth,
     if (qf->text == NULL)
         return;
 
-    if (strcmp (text, qf->text) == 0)
+    if (CACHE_EQUAL (text, qf->text))
     {
         /* the currently best text is about to be removed */
 
@@ -419,24 +505,26 @@ gnc_quickfill_remove_recursive (QuickFill *qf, const gchar *text, gint depth,
         }
         else
         {
-            if (g_hash_table_size (qf->matches) != 0)
+            if (qf->n_matches != 0)
             {
                 /* otherwise search for another good text */
                 struct _BestText bts;
+                guint i;
                 bts.text = NULL;
                 bts.sort = sort;
 
-                g_hash_table_foreach (qf->matches, (GHFunc) best_text_helper, &bts);
+                for (i = 0; i < qf->n_matches; i++)
+                    best_text_helper (qf->matches[i].qf, &bts);
                 best_text = bts.text;
                 best_len = (best_text == NULL) ? 0 : g_utf8_strlen (best_text, -1);
             }
         }
 
         /* now replace or clear text */
-        g_free(qf->text);
+        old_text = qf->text;
         if (best_text != NULL)
         {
-            qf->text = g_strdup(best_text);
+            qf->text = CACHE_INSERT(best_text);
             qf->len = best_len;
         }
         else
@@ -444,6 +532,7 @@ gnc_quickfill_remove_recursive (QuickFill *qf, const gchar *text, gint depth,
             qf->text = NULL;
             qf->len = 0;
         }
+        CACHE_REMOVE(old_text);
     }
 }
 
@@ -44,6 +44,26 @@ typedef struct
     gboolean match;
 } ComponentEventInfo;
 
+/* The key and value of an entity_events entry, allocated together. */
+typedef struct
+{
+    GncGUID guid;
+    EventInfo info;
+} EntityEvent;
+
+/* The components watching an entity or a type of entity. */
+typedef struct
+{
+    GncGUID guid;
+    GList *components;
+} EntityWatchers;
+
+typedef struct
+{
+    char *entity_type;
+    GList *components;
+} TypeWatchers;
+
 typedef struct
 {
     GNCComponentRefreshHandler refresh_handler;
@@ -67,6 +87,11 @@ static GList *components = NULL;
 static ComponentEventInfo changes = { NULL, NULL, FALSE };
 static ComponentEventInfo changes_backup = { NULL, NULL, FALSE };
 
+/* Which components watch which entities and types, so that a refresh
+ * only looks at the components whose watches match the changes. */
+static GHashTable *entity_watchers = NULL;
+static GHashTable *type_watchers = NULL;
+
 
 /* This static indicates the debugging module that this .o belongs to.  */
 static QofLogModule log_module = GNC_MOD_GUI;
@@ -140,17 +165,13 @@ destroy_mask_hash (GHashTable *hash)
 static gboolean
 destroy_event_hash_helper (gpointer key, gpointer value, gpointer user_data)
 {
-    GncGUID *guid = key;
-    EventInfo *ei = value;
-
-    guid_free (guid);
-    g_free (ei);
+    g_slice_free (EntityEvent, key);
 
     return TRUE;
 }
 
 /* clear a hash table of the form GncGUID --> EventInfo, where
- * both keys and values are g_malloced */
+ * each key and value are an EntityEvent from the slice allocator */
 static void
 clear_event_hash (GHashTable *hash)
 {
@@ -177,6 +198,26 @@ clear_event_info (ComponentEventInfo *cei)
     clear_event_hash (cei->entity_events);
 }
 
+/* Returns the changes recorded for entity, adding an empty entry if there
+ * are none yet. */
+static EventInfo *
+entity_event_info (GHashTable *hash, const GncGUID *entity)
+{
+    EventInfo *ei = g_hash_table_lookup (hash, entity);
+
+    if (ei == NULL)
+    {
+        EntityEvent *entry = g_slice_new (EntityEvent);
+
+        entry->guid = *entity;
+        entry->info.event_mask = 0;
+        ei = &entry->info;
+
+        g_hash_table_insert (hash, &entry->guid, ei);
+    }
+    return ei;
+}
+
 static void
 add_event (ComponentEventInfo *cei, const GncGUID *entity,
            QofEventId event_mask, gboolean or_in)
@@ -199,27 +240,12 @@ add_event (ComponentEventInfo *cei, const GncGUID *entity,
         if (g_hash_table_lookup_extended (hash, entity, &key, &value))
         {
             g_hash_table_remove (hash, entity);
-            guid_free (key);
-            g_free (value);
+            g_slice_free (EntityEvent, key);
         }
     }
     else
     {
-        EventInfo *ei;
-
-        ei = g_hash_table_lookup (hash, entity);
-        if (ei == NULL)
-        {
-            GncGUID *key;
-
-            key = guid_malloc ();
-            *key = *entity;
-
-            ei = g_new (EventInfo, 1);
-            ei->event_mask = 0;
-
-            g_hash_table_insert (hash, key, ei);
-        }
+        EventInfo *ei = entity_event_info (hash, entity);
 
         if (or_in)
             ei->event_mask |= event_mask;
@@ -228,6 +254,22 @@ add_event (ComponentEventInfo *cei, const GncGUID *entity,
     }
 }
 
+/* Returns the mask of events recorded for entity_type, adding an empty one
+ * if there is none yet. */
+static QofEventId *
+event_type_mask (GHashTable *hash, QofIdTypeConst entity_type)
+{
+    QofEventId *mask = g_hash_table_lookup (hash, entity_type);
+
+    if (!mask)
+    {
+        char * key = qof_string_cache_insert ((gpointer) entity_type);
+        mask = g_new0 (QofEventId, 1);
+        g_hash_table_insert (hash, key, mask);
+    }
+    return mask;
+}
+
 static void
 add_event_type (ComponentEventInfo *cei, QofIdTypeConst entity_type,
                 QofEventId event_mask, gboolean or_in)
@@ -238,13 +280,7 @@ add_event_type (ComponentEventInfo *cei, QofIdTypeConst entity_type,
     g_return_if_fail (cei->event_masks);
     g_return_if_fail (entity_type);
 
-    mask = g_hash_table_lookup (cei->event_masks, entity_type);
-    if (!mask)
-    {
-        char * key = qof_string_cache_insert ((gpointer) entity_type);
-        mask = g_new0 (QofEventId, 1);
-        g_hash_table_insert (cei->event_masks, key, mask);
-    }
+    mask = event_type_mask (cei->event_masks, entity_type);
 
     if (or_in)
         *mask |= event_mask;
@@ -253,29 +289,136 @@ add_event_type (ComponentEventInfo *cei, QofIdTypeConst entity_type,
 }
 
 static void
-gnc_cm_event_handler (QofInstance *entity,
-                      QofEventId event_type,
-                      gpointer user_data,
-                      gpointer event_data)
+destroy_entity_watchers (gpointer data)
+{
+    EntityWatchers *watchers = data;
+
+    g_list_free (watchers->components);
+    g_slice_free (EntityWatchers, watchers);
+}
+
+static void
+destroy_type_watchers (gpointer data)
+{
+    TypeWatchers *watchers = data;
+
+    g_list_free (watchers->components);
+    qof_string_cache_remove (watchers->entity_type);
+    g_slice_free (TypeWatchers, watchers);
+}
+
+static void
+add_entity_watcher (const GncGUID *entity, ComponentInfo *ci)
+{
+    EntityWatchers *watchers = g_hash_table_lookup (entity_watchers, entity);
+
+    if (!watchers)
+    {
+        watchers = g_slice_new (EntityWatchers);
+        watchers->guid = *entity;
+        watchers->components = NULL;
+        g_hash_table_insert (entity_watchers, &watchers->guid, watchers);
+    }
+    watchers->components = g_list_prepend (watchers->components, ci);
+}
+
+static void
+remove_entity_watcher (const GncGUID *entity, ComponentInfo *ci)
+{
+    EntityWatchers *watchers = g_hash_table_lookup (entity_watchers, entity);
+
+    if (!watchers)
+        return;
+    watchers->components = g_list_remove (watchers->components, ci);
+    if (!watchers->components)
+        g_hash_table_remove (entity_watchers, entity);
+}
+
+static void
+add_type_watcher (QofIdTypeConst entity_type, ComponentInfo *ci)
+{
+    TypeWatchers *watchers = g_hash_table_lookup (type_watchers, entity_type);
+
+    if (!watchers)
+    {
+        watchers = g_slice_new (TypeWatchers);
+        watchers->entity_type = qof_string_cache_insert (entity_type);
+        watchers->components = NULL;
+        g_hash_table_insert (type_watchers, watchers->entity_type, watchers);
+    }
+    watchers->components = g_list_prepend (watchers->components, ci);
+}
+
+static void
+remove_type_watcher (gpointer key, gpointer value, gpointer user_data)
+{
+    ComponentInfo *ci = user_data;
+    TypeWatchers *watchers = g_hash_table_lookup (type_watchers, key);
+
+    if (!watchers)
+        return;
+    watchers->components = g_list_remove (watchers->components, ci);
+    if (!watchers->components)
+        g_hash_table_remove (type_watchers, key);
+}
+
+static void
+remove_entity_watch_helper (gpointer key, gpointer value, gpointer user_data)
 {
-    const GncGUID *guid = qof_entity_get_guid(entity);
+    remove_entity_watcher (key, user_data);
+}
+
+/* Events come in batches, one entry per entity, while the GUI refresh is
+ * suspended and one at a time otherwise. The entries are or'ed straight into
+ * the change tables; entries of one type tend to come together, so the type's
+ * mask is only looked up again when the type changes. */
+static void
+gnc_cm_event_handler (const QofEventBatchEntry *entries,
+                      guint n_entries,
+                      gpointer user_data)
+{
+    QofIdTypeConst last_type = NULL;
+    QofEventId *type_mask = NULL;
+    guint i;
+
+    g_return_if_fail (changes.entity_events);
+    g_return_if_fail (changes.event_masks);
+
+    for (i = 0; i < n_entries; i++)
+    {
+        const QofEventBatchEntry *entry = &entries[i];
+        QofIdTypeConst type = entry->type;
+        QofEventId event_mask = entry->event_mask;
 #if CM_DEBUG
-    gchar guidstr[GUID_ENCODING_LENGTH+1];
-    guid_to_string_buff (guid, guidstr);
-    fprintf (stderr, "event_handler: event %d, entity %p, guid %s\n", event_type,
-             entity, guidstr);
+        gchar guidstr[GUID_ENCODING_LENGTH+1];
+        guid_to_string_buff (&entry->guid, guidstr);
+        fprintf (stderr, "event_handler: event %d, type %s, guid %s\n",
+                 entry->event_mask, entry->type, guidstr);
 #endif
-    add_event (&changes, guid, event_type, TRUE);
+        if (event_mask == 0)
+            continue;
 
-    if (QOF_CHECK_TYPE(entity, GNC_ID_SPLIT))
-    {
-        /* split events are never generated by the engine, but might
-         * be generated by a backend (viz. the postgres backend.)
-         * Handle them like a transaction modify event. */
-        add_event_type (&changes, GNC_ID_TRANS, QOF_EVENT_MODIFY, TRUE);
+        entity_event_info (changes.entity_events, &entry->guid)->event_mask
+            |= event_mask;
+
+        if (g_strcmp0 (type, GNC_ID_SPLIT) == 0)
+        {
+            /* split events are never generated by the engine, but might
+             * be generated by a backend (viz. the postgres backend.)
+             * Handle them like a transaction modify event. */
+            type = GNC_ID_TRANS;
+            event_mask = QOF_EVENT_MODIFY;
+        }
+        if (!type)
+            continue;
+
+        if (type != last_type && g_strcmp0 (type, last_type) != 0)
+        {
+            type_mask = event_type_mask (changes.event_masks, type);
+            last_type = type;
+        }
+        *type_mask |= event_mask;
     }
-    else
-        add_event_type (&changes, entity->e_type, event_type, TRUE);
 
     got_events = TRUE;
 
@@ -300,7 +443,13 @@ gnc_component_manager_init (void)
     changes_backup.event_masks = g_hash_table_new (g_str_hash, g_str_equal);
     changes_backup.entity_events = guid_hash_table_new ();
 
-    handler_id = qof_event_register_handler (gnc_cm_event_handler, NULL);
+    entity_watchers = g_hash_table_new_full (guid_hash_to_guint,
+                                             guid_g_hash_table_equal,
+                                             NULL, destroy_entity_watchers);
+    type_watchers = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                           NULL, destroy_type_watchers);
+
+    handler_id = qof_event_register_batch_handler (gnc_cm_event_handler, NULL);
 }
 
 void
@@ -324,6 +473,12 @@ gnc_component_manager_shutdown (void)
     destroy_event_hash (changes_backup.entity_events);
     changes_backup.entity_events = NULL;
 
+    g_hash_table_destroy (entity_watchers);
+    entity_watchers = NULL;
+
+    g_hash_table_destroy (type_watchers);
+    type_watchers = NULL;
+
     qof_event_unregister_handler (handler_id);
 }
 
@@ -454,6 +609,7 @@ gnc_gui_component_watch_entity (gint component_id,
                                 QofEventId event_mask)
 {
     ComponentInfo *ci;
+    gboolean watched;
 
     if (entity == NULL)
         return;
@@ -465,7 +621,12 @@ gnc_gui_component_watch_entity (gint component_id,
         return;
     }
 
+    watched = g_hash_table_contains (ci->watch_info.entity_events, entity);
     add_event (&ci->watch_info, entity, event_mask, FALSE);
+    if (!watched && event_mask)
+        add_entity_watcher (entity, ci);
+    else if (watched && !event_mask)
+        remove_entity_watcher (entity, ci);
 }
 
 void
@@ -482,6 +643,9 @@ gnc_gui_component_watch_entity_type (gint component_id,
         return;
     }
 
+    if (entity_type &&
+        !g_hash_table_contains (ci->watch_info.event_masks, entity_type))
+        add_type_watcher (entity_type, ci);
     add_event_type (&ci->watch_info, entity_type, event_mask, FALSE);
 }
 
@@ -506,6 +670,10 @@ gnc_gui_component_clear_watches (gint component_id)
         return;
     }
 
+    /* The type masks are only zeroed, so the component stays in the type
+     * index until it's unregistered. */
+    g_hash_table_foreach (ci->watch_info.entity_events,
+                          remove_entity_watch_helper, ci);
     clear_event_info (&ci->watch_info);
 }
 
@@ -531,6 +699,7 @@ gnc_unregister_gui_component (gint component_id)
 
     components = g_list_remove (components, ci);
 
+    g_hash_table_foreach (ci->watch_info.event_masks, remove_type_watcher, ci);
     destroy_mask_hash (ci->watch_info.event_masks);
     ci->watch_info.event_masks = NULL;
 
@@ -579,6 +748,7 @@ gnc_suspend_gui_refresh (void)
     {
         PERR ("suspend counter overflow");
     }
+    qof_event_begin_batch ();
 }
 
 void
@@ -591,6 +761,7 @@ gnc_resume_gui_refresh (void)
     }
 
     suspend_counter--;
+    qof_event_end_batch ();
 
     if (suspend_counter == 0)
         gnc_gui_refresh_internal (FALSE);
@@ -599,67 +770,65 @@ gnc_resume_gui_refresh (void)
 static void
 match_type_helper (gpointer key, gpointer value, gpointer user_data)
 {
-    ComponentEventInfo *cei = user_data;
-    QofIdType id_type = key;
-    QofEventId * et = value;
-    QofEventId * et_2;
+    QofEventId *changed = value;
+    TypeWatchers *watchers;
+    GList *node;
 
-    et_2 = g_hash_table_lookup (cei->event_masks, id_type);
-    if (!et_2)
+    if (*changed == 0)
+        return;
+    watchers = g_hash_table_lookup (type_watchers, key);
+    if (!watchers)
         return;
 
-    if (*et & *et_2)
-        cei->match = TRUE;
+    for (node = watchers->components; node; node = node->next)
+    {
+        ComponentInfo *ci = node->data;
+        QofEventId *watched = g_hash_table_lookup (ci->watch_info.event_masks,
+                                                   key);
+
+        if (watched && (*watched & *changed))
+            ci->watch_info.match = TRUE;
+    }
 }
 
 static void
 match_helper (gpointer key, gpointer value, gpointer user_data)
 {
-    GncGUID *guid = key;
-    EventInfo *ei_1 = value;
-    EventInfo *ei_2;
-    ComponentEventInfo *cei = user_data;
+    EventInfo *changed = value;
+    EntityWatchers *watchers;
+    GList *node;
 
-    ei_2 = g_hash_table_lookup (cei->entity_events, guid);
-    if (!ei_2)
+    watchers = g_hash_table_lookup (entity_watchers, key);
+    if (!watchers)
         return;
 
-    if (ei_1->event_mask & ei_2->event_mask)
-        cei->match = TRUE;
+    for (node = watchers->components; node; node = node->next)
+    {
+        ComponentInfo *ci = node->data;
+        EventInfo *watched = g_hash_table_lookup (ci->watch_info.entity_events,
+                                                  key);
+
+        if (watched && (watched->event_mask & changed->event_mask))
+            ci->watch_info.match = TRUE;
+    }
 }
 
-static gboolean
-changes_match (ComponentEventInfo *cei, ComponentEventInfo *changes)
+/* Flag the components watching any of the changes. Only the changed
+ * entities and types are looked up in the watch indexes, so components
+ * unaffected by the changes cost nothing but clearing their flag. */
+static void
+mark_matching_components (ComponentEventInfo *changes)
 {
-    ComponentEventInfo *big_cei;
-    GHashTable *smalltable;
-
-    if (cei == NULL)
-        return FALSE;
-
-    /* check types first, for efficiency */
-    cei->match = FALSE;
-    g_hash_table_foreach (changes->event_masks, match_type_helper, cei);
-    if (cei->match)
-        return TRUE;
+    GList *node;
 
-    if (g_hash_table_size (cei->entity_events) <=
-            g_hash_table_size (changes->entity_events))
-    {
-        smalltable = cei->entity_events;
-        big_cei = changes;
-    }
-    else
+    for (node = components; node; node = node->next)
     {
-        smalltable = changes->entity_events;
-        big_cei = cei;
+        ComponentInfo *ci = node->data;
+        ci->watch_info.match = FALSE;
     }
 
-    big_cei->match = FALSE;
-
-    g_hash_table_foreach (smalltable, match_helper, big_cei);
-
-    return big_cei->match;
+    g_hash_table_foreach (changes->event_masks, match_type_helper, NULL);
+    g_hash_table_foreach (changes->entity_events, match_helper, NULL);
 }
 
 static void
@@ -689,6 +858,9 @@ gnc_gui_refresh_internal (gboolean force)
     fprintf (stderr, "%srefresh!\n", force ? "forced " : "");
 #endif
 
+    if (!force)
+        mark_matching_components (&changes_backup);
+
     list = find_component_ids_by_class (NULL);
     // reverse the list so class GncPluginPageRegister is before register-single
     list = g_list_reverse (list);
@@ -718,7 +890,7 @@ gnc_gui_refresh_internal (gboolean force)
                 ci->refresh_handler (NULL, ci->user_data);
             }
         }
-        else if (changes_match (&ci->watch_info, &changes_backup))
+        else if (ci->watch_info.match)
         {
             if (ci->refresh_handler)
             {
@@ -1306,6 +1306,7 @@ gnc_sx_instance_model_effect_change(GncSxInstanceModel *model,
         return;
     }
 
+    qof_event_begin_batch ();
     for (iter = model->sx_instance_list; iter != NULL; iter = iter->next)
     {
         GList *instance_iter;
@@ -1395,6 +1396,7 @@ gnc_sx_instance_model_effect_change(GncSxInstanceModel *model,
         gnc_sx_set_instance_count(instances->sx, instance_count);
         xaccSchedXactionSetRemOccur(instances->sx, remain_occur_count);
     }
+    qof_event_end_batch ();
 }
 
 void
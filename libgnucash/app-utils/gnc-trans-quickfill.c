@@ -0,0 +1,434 @@
+/********************************************************************\
+ * gnc-trans-quickfill.c -- Create transaction text quick-fills     *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+\********************************************************************/
+
+#include <config.h>
+#include <string.h>
+#include "gnc-trans-quickfill.h"
+#include "gnc-engine.h"
+#include "Account.h"
+#include "SX-book.h"
+#include "Split.h"
+#include "Transaction.h"
+
+/* This static indicates the debugging module that this .o belongs to. */
+static QofLogModule log_module = GNC_MOD_REGISTER;
+
+#define TRANS_QF_KEY "gnc-trans-quickfill"
+
+/* How many transactions to add to the quickfills each time the main loop
+ * is idle while they are built. */
+#define TRANS_QF_BUILD_CHUNK 500
+
+/* The quickfill of one kind of text, with how many transactions or splits
+ * use each text so that a text leaves the quickfill with its last user.
+ * Lookups in the quickfill ignore case, so texts differing only in case
+ * share an entry, holding the one inserted last. */
+typedef struct
+{
+    QuickFill *qf;
+    GHashTable *uses;   /* upper-cased text -> TextUses */
+} SharedQF;
+
+typedef struct
+{
+    char *text;         /* from the string cache */
+    guint count;
+} TextUses;
+
+/* The texts a transaction added, so they can be taken out again when it
+ * changes or goes away. All strings are from the string cache. */
+typedef struct
+{
+    char *desc;
+    char *notes;
+    GList *memos;
+} TransTexts;
+
+typedef struct
+{
+    SharedQF desc;
+    SharedQF notes;
+    SharedQF memo;
+    GHashTable *trans_texts;  /* transaction GUID -> TransTexts */
+    QofBook *book;
+    gint  listener;
+
+    /* The transactions still to add, oldest first, and the next one. */
+    GArray *to_load;
+    guint next_load;
+    guint load_id;
+    /* Transactions committed while building, to be made most recent
+     * again once it's done. */
+    GList *committed;
+} TransQF;
+
+static gchar *
+fold_text (const char *text)
+{
+    gchar *normalized = g_utf8_normalize (text, -1, G_NORMALIZE_NFC);
+    GString *folded = g_string_sized_new (strlen (normalized));
+    const char *c;
+
+    for (c = normalized; *c; c = g_utf8_next_char (c))
+        g_string_append_unichar (folded, g_unichar_toupper (g_utf8_get_char (c)));
+    g_free (normalized);
+    return g_string_free (folded, FALSE);
+}
+
+static void
+text_uses_free (gpointer data)
+{
+    TextUses *uses = data;
+
+    CACHE_REMOVE (uses->text);
+    g_slice_free (TextUses, uses);
+}
+
+static void
+shared_qf_init (SharedQF *sqf)
+{
+    sqf->qf = gnc_quickfill_new ();
+    sqf->uses = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+                                       text_uses_free);
+}
+
+static void
+shared_qf_destroy (SharedQF *sqf)
+{
+    gnc_quickfill_destroy (sqf->qf);
+    g_hash_table_destroy (sqf->uses);
+}
+
+static void
+shared_qf_add (SharedQF *sqf, const char *text)
+{
+    gchar *key;
+    TextUses *uses;
+
+    if (!text || !*text)
+        return;
+
+    key = fold_text (text);
+    uses = g_hash_table_lookup (sqf->uses, key);
+    if (!uses)
+    {
+        uses = g_slice_new (TextUses);
+        uses->text = CACHE_INSERT (text);
+        uses->count = 0;
+        g_hash_table_insert (sqf->uses, key, uses);
+    }
+    else
+    {
+        if (g_strcmp0 (uses->text, text) != 0)
+            CACHE_REPLACE (uses->text, text);
+        g_free (key);
+    }
+    uses->count++;
+
+    gnc_quickfill_insert (sqf->qf, text, QUICKFILL_LIFO);
+}
+
+static void
+shared_qf_remove (SharedQF *sqf, const char *text)
+{
+    gchar *key;
+    TextUses *uses;
+
+    if (!text || !*text)
+        return;
+
+    key = fold_text (text);
+    uses = g_hash_table_lookup (sqf->uses, key);
+    if (uses && --uses->count == 0)
+    {
+        gnc_quickfill_remove (sqf->qf, uses->text, QUICKFILL_LIFO);
+        g_hash_table_remove (sqf->uses, key);
+    }
+    g_free (key);
+}
+
+static void
+trans_texts_free (gpointer data)
+{
+    TransTexts *texts = data;
+
+    CACHE_REMOVE (texts->desc);
+    CACHE_REMOVE (texts->notes);
+    g_list_free_full (texts->memos, (GDestroyNotify) qof_string_cache_remove);
+    g_slice_free (TransTexts, texts);
+}
+
+static gboolean
+is_template_trans (Transaction *trans, Account *template_root)
+{
+    Split *split = xaccTransGetSplit (trans, 0);
+    Account *account = split ? xaccSplitGetAccount (split) : NULL;
+
+    return account && template_root &&
+           gnc_account_get_root (account) == template_root;
+}
+
+/* Forget the texts the transaction added last time. */
+static void
+remove_trans (TransQF *qfb, const GncGUID *guid)
+{
+    TransTexts *texts = g_hash_table_lookup (qfb->trans_texts, guid);
+    GList *node;
+
+    if (!texts)
+        return;
+
+    shared_qf_remove (&qfb->desc, texts->desc);
+    shared_qf_remove (&qfb->notes, texts->notes);
+    for (node = texts->memos; node; node = node->next)
+        shared_qf_remove (&qfb->memo, node->data);
+
+    g_hash_table_remove (qfb->trans_texts, guid);
+}
+
+/* Add the transaction's texts, replacing those it added before. The new
+ * ones go in first, so that texts it still uses don't drop out. */
+static void
+add_trans (TransQF *qfb, Transaction *trans)
+{
+    TransTexts *texts = g_slice_new0 (TransTexts);
+    GncGUID *guid;
+    GList *node;
+
+    texts->desc = CACHE_INSERT (xaccTransGetDescription (trans));
+    texts->notes = CACHE_INSERT (xaccTransGetNotes (trans));
+    shared_qf_add (&qfb->desc, texts->desc);
+    shared_qf_add (&qfb->notes, texts->notes);
+
+    for (node = xaccTransGetSplitList (trans); node; node = node->next)
+    {
+        const char *memo = xaccSplitGetMemo (node->data);
+
+        if (!memo || !*memo)
+            continue;
+        texts->memos = g_list_prepend (texts->memos, CACHE_INSERT (memo));
+        shared_qf_add (&qfb->memo, memo);
+    }
+
+    remove_trans (qfb, xaccTransGetGUID (trans));
+    guid = guid_copy (xaccTransGetGUID (trans));
+    g_hash_table_insert (qfb->trans_texts, guid, texts);
+}
+
+static void
+listen_for_trans_events (QofInstance *entity, QofEventId event_type,
+                         gpointer user_data, gpointer event_data)
+{
+    TransQF *qfb = user_data;
+    Transaction *trans;
+
+    if (!GNC_IS_TRANSACTION (entity))
+        return;
+
+    trans = GNC_TRANSACTION (entity);
+    if (qof_instance_get_book (entity) != qfb->book)
+        return;
+
+    if ((event_type & QOF_EVENT_DESTROY) ||
+        qof_instance_get_destroying (entity))
+    {
+        remove_trans (qfb, xaccTransGetGUID (trans));
+        return;
+    }
+
+    if (is_template_trans (trans, gnc_book_get_template_root (qfb->book)))
+        return;
+
+    add_trans (qfb, trans);
+    if (qfb->load_id)
+        qfb->committed = g_list_prepend (qfb->committed,
+                                         guid_copy (xaccTransGetGUID (trans)));
+}
+
+static void
+collect_trans (QofInstance *inst, gpointer user_data)
+{
+    GList **transactions = user_data;
+
+    *transactions = g_list_prepend (*transactions, inst);
+}
+
+static gint
+trans_order (gconstpointer a, gconstpointer b)
+{
+    return xaccTransOrder (a, b);
+}
+
+/* Lists the book's transactions to add, oldest first, so that the most
+ * recent text with a given prefix is the one offered, as it is in a
+ * register. It keeps their GUIDs rather than pointers, as they may be
+ * destroyed before their turn. */
+static GArray *
+list_trans_to_load (QofBook *book)
+{
+    GList *transactions = NULL, *node;
+    GArray *to_load;
+
+    qof_collection_foreach (qof_book_get_collection (book, GNC_ID_TRANS),
+                            collect_trans, &transactions);
+    transactions = g_list_sort (transactions, trans_order);
+    to_load = g_array_sized_new (FALSE, FALSE, sizeof (GncGUID),
+                                 g_list_length (transactions));
+    for (node = transactions; node; node = node->next)
+        g_array_append_val (to_load, *xaccTransGetGUID (node->data));
+    g_list_free (transactions);
+    return to_load;
+}
+
+static gboolean
+load_trans_idle (gpointer user_data)
+{
+    TransQF *qfb = user_data;
+    Account *template_root = gnc_book_get_template_root (qfb->book);
+    guint last;
+    GList *node;
+
+    if (!qfb->to_load)
+    {
+        qfb->to_load = list_trans_to_load (qfb->book);
+        return G_SOURCE_CONTINUE;
+    }
+
+    last = MIN (qfb->next_load + TRANS_QF_BUILD_CHUNK, qfb->to_load->len);
+    for (; qfb->next_load < last; qfb->next_load++)
+    {
+        GncGUID *guid = &g_array_index (qfb->to_load, GncGUID, qfb->next_load);
+        Transaction *trans = xaccTransLookup (guid, qfb->book);
+
+        /* Gone since, or added when it was committed. */
+        if (!trans || g_hash_table_contains (qfb->trans_texts, guid) ||
+            is_template_trans (trans, template_root))
+            continue;
+
+        add_trans (qfb, trans);
+    }
+
+    if (qfb->next_load < qfb->to_load->len)
+        return G_SOURCE_CONTINUE;
+
+    /* Transactions committed during the build are the most recent. */
+    qfb->committed = g_list_reverse (qfb->committed);
+    for (node = qfb->committed; node; node = node->next)
+    {
+        Transaction *trans = xaccTransLookup (node->data, qfb->book);
+
+        if (trans && g_hash_table_contains (qfb->trans_texts, node->data))
+            add_trans (qfb, trans);
+    }
+    g_list_free_full (qfb->committed, (GDestroyNotify) guid_free);
+    qfb->committed = NULL;
+
+    g_array_free (qfb->to_load, TRUE);
+    qfb->to_load = NULL;
+    qfb->load_id = 0;
+    PINFO ("Loaded the texts of %u transactions",
+           g_hash_table_size (qfb->trans_texts));
+    return G_SOURCE_REMOVE;
+}
+
+static void
+shared_quickfill_destroy (QofBook *book, gpointer key, gpointer user_data)
+{
+    TransQF *qfb = user_data;
+
+    if (qfb->load_id)
+        g_source_remove (qfb->load_id);
+    if (qfb->to_load)
+        g_array_free (qfb->to_load, TRUE);
+    g_list_free_full (qfb->committed, (GDestroyNotify) guid_free);
+    qof_event_unregister_handler (qfb->listener);
+    g_hash_table_destroy (qfb->trans_texts);
+    shared_qf_destroy (&qfb->desc);
+    shared_qf_destroy (&qfb->notes);
+    shared_qf_destroy (&qfb->memo);
+    g_free (qfb);
+}
+
+/* Sets up empty quickfills and fills them from the main loop when it's
+ * idle, so that opening the first register doesn't wait for every
+ * transaction in the book to be read. */
+static TransQF *
+build_shared_quickfill (QofBook *book)
+{
+    TransQF *result;
+
+    ENTER("book=%p", book);
+
+    result = g_new0 (TransQF, 1);
+    shared_qf_init (&result->desc);
+    shared_qf_init (&result->notes);
+    shared_qf_init (&result->memo);
+    result->trans_texts = g_hash_table_new_full (guid_hash_to_guint,
+                                                 guid_g_hash_table_equal,
+                                                 (GDestroyNotify) guid_free,
+                                                 trans_texts_free);
+    result->book = book;
+    result->load_id = g_idle_add (load_trans_idle, result);
+
+    result->listener =
+        qof_event_register_typed_handler (listen_for_trans_events, result,
+                                          GNC_ID_TRANS,
+                                          QOF_EVENT_MODIFY | QOF_EVENT_DESTROY);
+
+    qof_book_set_data_fin (book, TRANS_QF_KEY, result,
+                           shared_quickfill_destroy);
+
+    LEAVE(" ");
+    return result;
+}
+
+static TransQF *
+get_shared_quickfill (QofBook *book)
+{
+    TransQF *qfb;
+
+    g_assert (book);
+
+    qfb = qof_book_get_data (book, TRANS_QF_KEY);
+    if (!qfb)
+        qfb = build_shared_quickfill (book);
+
+    return qfb;
+}
+
+QuickFill *
+gnc_get_shared_trans_desc_quickfill (QofBook *book)
+{
+    return get_shared_quickfill (book)->desc.qf;
+}
+
+QuickFill *
+gnc_get_shared_trans_notes_quickfill (QofBook *book)
+{
+    return get_shared_quickfill (book)->notes.qf;
+}
+
+QuickFill *
+gnc_get_shared_split_memo_quickfill (QofBook *book)
+{
+    return get_shared_quickfill (book)->memo.qf;
+}
@@ -0,0 +1,66 @@
+/********************************************************************\
+ * gnc-trans-quickfill.h -- Create transaction text quick-fills     *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+\********************************************************************/
+/** @addtogroup QuickFill Auto-complete typed user input.
+   @{
+*/
+/** Similar to the @ref Account_QuickFill account name quickfill, we
+ * create cached quickfills with the descriptions and notes of all
+ * transactions, and the memos of all splits, in a book.
+*/
+
+#ifndef GNC_TRANS_QUICKFILL_H
+#define GNC_TRANS_QUICKFILL_H
+
+#include "qof.h"
+#include "QuickFill.h"
+
+/** Fetch the quickfill of the descriptions of all the transactions in the
+ *  book, creating it the first time.
+ *
+ *  All registers of the book share the same quickfill instead of building
+ *  their own from the splits they load. It starts out empty and is filled
+ *  from the book's transactions while the main loop is idle, so it may not
+ *  offer every text right after it is created. This code listens to
+ *  transaction commits and adds the new texts to the quickfill, most recent
+ *  first. A text leaves the quickfill when no transaction uses it any more.
+ *
+ *  Scheduled transaction templates are left out.
+ *
+ * \param book The book
+ *
+ * \return The shared QuickFill object. It belongs to the book and must
+ * not be destroyed by the caller.
+ */
+QuickFill * gnc_get_shared_trans_desc_quickfill (QofBook *book);
+
+/** Fetch the shared quickfill of the notes of all the transactions in the
+ *  book. See gnc_get_shared_trans_desc_quickfill(). */
+QuickFill * gnc_get_shared_trans_notes_quickfill (QofBook *book);
+
+/** Fetch the shared quickfill of the memos of all the splits in the
+ *  book. See gnc_get_shared_trans_desc_quickfill(). */
+QuickFill * gnc_get_shared_split_memo_quickfill (QofBook *book);
+
+#endif
+
+/** @} */
+/** @} */
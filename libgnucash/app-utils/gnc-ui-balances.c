@@ -202,6 +202,8 @@ gnc_ui_account_get_balance_as_of_date (Account *account,
 
         children = gnc_account_get_descendants(account);
 
+        /* The sub-accounts are converted at the latest prices, not those
+         * of the date, and added without rounding. */
         for (node = children; node; node = node->next)
         {
             Account *child;
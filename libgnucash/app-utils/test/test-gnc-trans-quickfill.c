@@ -0,0 +1,216 @@
+/********************************************************************
+ * test-gnc-trans-quickfill.c: GLib g_test test suite for           *
+ * gnc-trans-quickfill.c.                                           *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, you can retrieve it from        *
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html            *
+ * or contact:                                                      *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ ********************************************************************/
+
+#include <config.h>
+#include <glib.h>
+#include <unittest-support.h>
+#include <qof.h>
+#include <Account.h>
+#include <Split.h>
+#include <Transaction.h>
+#include <gnc-commodity.h>
+
+#include "../gnc-trans-quickfill.h"
+
+static const gchar *suitename = "/app-utils/gnc-trans-quickfill";
+void test_suite_gnc_trans_quickfill (void);
+
+typedef struct
+{
+    QofBook *book;
+    Account *acct;
+    gnc_commodity *currency;
+} Fixture;
+
+static void
+setup (Fixture *fixture, gconstpointer pData)
+{
+    fixture->book = qof_book_new ();
+    fixture->currency = gnc_commodity_new (fixture->book, "US Dollar",
+                                           "CURRENCY", "USD", "", 100);
+    fixture->acct = xaccMallocAccount (fixture->book);
+    xaccAccountBeginEdit (fixture->acct);
+    xaccAccountSetName (fixture->acct, "Checking");
+    xaccAccountSetCommodity (fixture->acct, fixture->currency);
+    xaccAccountCommitEdit (fixture->acct);
+}
+
+static void
+teardown (Fixture *fixture, gconstpointer pData)
+{
+    /* Takes the quickfills and their idle build with it. */
+    qof_book_destroy (fixture->book);
+}
+
+static Transaction *
+make_trans (Fixture *fixture, const char *desc, int days_ago)
+{
+    Transaction *trans = xaccMallocTransaction (fixture->book);
+    Split *split = xaccMallocSplit (fixture->book);
+
+    xaccTransBeginEdit (trans);
+    xaccTransSetCurrency (trans, fixture->currency);
+    xaccTransSetDescription (trans, desc);
+    xaccTransSetDatePostedSecsNormalized (trans,
+                                          gnc_time (NULL) - days_ago * 86400);
+    xaccSplitSetAccount (split, fixture->acct);
+    xaccSplitSetParent (split, trans);
+    xaccTransCommitEdit (trans);
+    return trans;
+}
+
+static void
+set_description (Transaction *trans, const char *desc)
+{
+    xaccTransBeginEdit (trans);
+    xaccTransSetDescription (trans, desc);
+    xaccTransCommitEdit (trans);
+}
+
+static void
+destroy_trans (Transaction *trans)
+{
+    xaccTransBeginEdit (trans);
+    xaccTransDestroy (trans);
+    xaccTransCommitEdit (trans);
+}
+
+/* Run the idle build of the quickfills to its end. */
+static void
+finish_build (void)
+{
+    while (g_main_context_iteration (NULL, FALSE))
+        ;
+}
+
+static const char *
+match_text (QuickFill *qf, const char *str)
+{
+    return gnc_quickfill_string (gnc_quickfill_get_string_match (qf, str));
+}
+
+static void
+test_build (Fixture *fixture, gconstpointer pData)
+{
+    QuickFill *qf;
+
+    make_trans (fixture, "Groceries", 2);
+    make_trans (fixture, "Gas", 1);
+
+    /* Empty until the main loop is idle. */
+    qf = gnc_get_shared_trans_desc_quickfill (fixture->book);
+    g_assert (qf == gnc_get_shared_trans_desc_quickfill (fixture->book));
+    g_assert (gnc_quickfill_get_string_match (qf, "G") == NULL);
+
+    /* Then the most recent text with a prefix is offered for it. */
+    finish_build ();
+    g_assert_cmpstr (match_text (qf, "G"), == , "Gas");
+    g_assert_cmpstr (match_text (qf, "Gr"), == , "Groceries");
+}
+
+static void
+test_destroy (Fixture *fixture, gconstpointer pData)
+{
+    QuickFill *qf = gnc_get_shared_trans_desc_quickfill (fixture->book);
+    Transaction *first = make_trans (fixture, "Groceries", 2);
+    Transaction *second = make_trans (fixture, "Groceries", 1);
+
+    finish_build ();
+    g_assert_cmpstr (match_text (qf, "Gr"), == , "Groceries");
+
+    /* The text stays while a transaction still uses it... */
+    destroy_trans (first);
+    g_assert_cmpstr (match_text (qf, "Gr"), == , "Groceries");
+
+    /* ...and leaves with the last one. */
+    destroy_trans (second);
+    g_assert (gnc_quickfill_get_string_match (qf, "G") == NULL);
+}
+
+static void
+test_edit (Fixture *fixture, gconstpointer pData)
+{
+    QuickFill *qf = gnc_get_shared_trans_desc_quickfill (fixture->book);
+    Transaction *trans = make_trans (fixture, "Gas", 1);
+
+    finish_build ();
+    g_assert_cmpstr (match_text (qf, "G"), == , "Gas");
+
+    set_description (trans, "Bakery");
+    g_assert (gnc_quickfill_get_string_match (qf, "G") == NULL);
+    g_assert_cmpstr (match_text (qf, "B"), == , "Bakery");
+
+    /* Committing it again without a change keeps the text. */
+    set_description (trans, "Bakery");
+    g_assert_cmpstr (match_text (qf, "B"), == , "Bakery");
+}
+
+static void
+test_case_variants (Fixture *fixture, gconstpointer pData)
+{
+    QuickFill *qf = gnc_get_shared_trans_desc_quickfill (fixture->book);
+    Transaction *lower = make_trans (fixture, "apple", 2);
+    Transaction *upper = make_trans (fixture, "APPLE", 1);
+    const char *text;
+
+    finish_build ();
+    g_assert_cmpstr (match_text (qf, "a"), == , "APPLE");
+
+    /* The texts share an entry, which stays while either is used. */
+    destroy_trans (upper);
+    text = match_text (qf, "a");
+    g_assert (text != NULL);
+    g_assert_cmpint (g_ascii_strcasecmp (text, "apple"), == , 0);
+
+    destroy_trans (lower);
+    g_assert (gnc_quickfill_get_string_match (qf, "a") == NULL);
+}
+
+static void
+test_commit_during_build (Fixture *fixture, gconstpointer pData)
+{
+    QuickFill *qf;
+    Transaction *older = make_trans (fixture, "Groceries", 2);
+
+    make_trans (fixture, "Gas", 1);
+    qf = gnc_get_shared_trans_desc_quickfill (fixture->book);
+
+    /* The build adds the newer transaction after this one, but the
+     * commit makes this one the most recent. */
+    set_description (older, "Grocer's");
+    g_assert_cmpstr (match_text (qf, "G"), == , "Grocer's");
+    finish_build ();
+    g_assert_cmpstr (match_text (qf, "G"), == , "Grocer's");
+    g_assert_cmpstr (match_text (qf, "Ga"), == , "Gas");
+}
+
+void
+test_suite_gnc_trans_quickfill (void)
+{
+    GNC_TEST_ADD (suitename, "build", Fixture, NULL, setup, test_build, teardown);
+    GNC_TEST_ADD (suitename, "destroy", Fixture, NULL, setup, test_destroy, teardown);
+    GNC_TEST_ADD (suitename, "edit", Fixture, NULL, setup, test_edit, teardown);
+    GNC_TEST_ADD (suitename, "case variants", Fixture, NULL, setup, test_case_variants, teardown);
+    GNC_TEST_ADD (suitename, "commit during build", Fixture, NULL, setup, test_commit_during_build, teardown);
+}
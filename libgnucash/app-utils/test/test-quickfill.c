@@ -0,0 +1,206 @@
+/********************************************************************
+ * test-quickfill.c: GLib g_test test suite for QuickFill.c.        *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, you can retrieve it from        *
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html            *
+ * or contact:                                                      *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ ********************************************************************/
+
+#include <config.h>
+#include <glib.h>
+#include <unittest-support.h>
+#include <qof.h>
+
+#include "../QuickFill.h"
+
+static const gchar *suitename = "/app-utils/quickfill";
+void test_suite_quickfill (void);
+
+typedef struct
+{
+    QuickFill *qf;
+} Fixture;
+
+static void
+setup (Fixture *fixture, gconstpointer pData)
+{
+    fixture->qf = gnc_quickfill_new ();
+}
+
+static void
+teardown (Fixture *fixture, gconstpointer pData)
+{
+    gnc_quickfill_destroy (fixture->qf);
+}
+
+static const char *
+match_text (QuickFill *qf, const char *str)
+{
+    return gnc_quickfill_string (gnc_quickfill_get_string_match (qf, str));
+}
+
+static void
+test_insert (Fixture *fixture, gconstpointer pData)
+{
+    QuickFill *qf = fixture->qf;
+
+    gnc_quickfill_insert (qf, "Groceries", QUICKFILL_LIFO);
+    g_assert_cmpstr (match_text (qf, "G"), == , "Groceries");
+    g_assert_cmpstr (match_text (qf, "Groceries"), == , "Groceries");
+    g_assert (gnc_quickfill_get_string_match (qf, "Gx") == NULL);
+    g_assert (gnc_quickfill_get_string_match (qf, "Groceries!") == NULL);
+
+    /* The most recent text with a prefix is offered for it... */
+    gnc_quickfill_insert (qf, "Gas", QUICKFILL_LIFO);
+    g_assert_cmpstr (match_text (qf, "G"), == , "Gas");
+    g_assert_cmpstr (match_text (qf, "Gr"), == , "Groceries");
+
+    /* ...unless that text merely extends the one already there. */
+    gnc_quickfill_insert (qf, "Gasoline", QUICKFILL_LIFO);
+    g_assert_cmpstr (match_text (qf, "G"), == , "Gas");
+    g_assert_cmpstr (match_text (qf, "Gaso"), == , "Gasoline");
+
+    /* Alphabetical order keeps the first text in collation order. */
+    gnc_quickfill_insert (qf, "Bread", QUICKFILL_ALPHA);
+    gnc_quickfill_insert (qf, "Beer", QUICKFILL_ALPHA);
+    gnc_quickfill_insert (qf, "Butter", QUICKFILL_ALPHA);
+    g_assert_cmpstr (match_text (qf, "B"), == , "Beer");
+    g_assert_cmpstr (match_text (qf, "Br"), == , "Bread");
+}
+
+static void
+test_remove (Fixture *fixture, gconstpointer pData)
+{
+    QuickFill *qf = fixture->qf;
+
+    gnc_quickfill_insert (qf, "Groceries", QUICKFILL_LIFO);
+    gnc_quickfill_insert (qf, "Gas", QUICKFILL_LIFO);
+    gnc_quickfill_insert (qf, "Gasoline", QUICKFILL_LIFO);
+
+    /* Another text with the prefix takes the removed one's place. */
+    gnc_quickfill_remove (qf, "Gas", QUICKFILL_LIFO);
+    g_assert_cmpstr (match_text (qf, "Gr"), == , "Groceries");
+    g_assert_cmpstr (match_text (qf, "Ga"), == , "Gasoline");
+    g_assert (match_text (qf, "G") != NULL);
+
+    /* Nodes no text uses any more go away. */
+    gnc_quickfill_remove (qf, "Gasoline", QUICKFILL_LIFO);
+    g_assert (gnc_quickfill_get_string_match (qf, "Ga") == NULL);
+    g_assert_cmpstr (match_text (qf, "G"), == , "Groceries");
+
+    /* Removing a text that isn't there changes nothing. */
+    gnc_quickfill_remove (qf, "Gravy", QUICKFILL_LIFO);
+    g_assert_cmpstr (match_text (qf, "Gr"), == , "Groceries");
+
+    gnc_quickfill_remove (qf, "Groceries", QUICKFILL_LIFO);
+    g_assert (gnc_quickfill_get_string_match (qf, "G") == NULL);
+}
+
+static void
+test_get_char_match (Fixture *fixture, gconstpointer pData)
+{
+    QuickFill *qf = fixture->qf;
+    QuickFill *match;
+
+    gnc_quickfill_insert (qf, "Café", QUICKFILL_LIFO);
+
+    match = gnc_quickfill_get_char_match (qf, 'C');
+    g_assert (match != NULL);
+    g_assert (gnc_quickfill_get_char_match (qf, 'c') == match);
+    g_assert (gnc_quickfill_get_char_match (qf, 'x') == NULL);
+    g_assert (gnc_quickfill_get_char_match (NULL, 'C') == NULL);
+
+    /* Characters outside ASCII are keys too, in either case. */
+    match = gnc_quickfill_get_string_match (qf, "caf");
+    g_assert (match != NULL);
+    g_assert (gnc_quickfill_get_char_match (match, 0x00e9) ==
+              gnc_quickfill_get_char_match (match, 0x00c9));
+    g_assert_cmpstr (gnc_quickfill_string
+                     (gnc_quickfill_get_char_match (match, 0x00c9)), == , "Café");
+}
+
+static void
+test_get_unique_len_match (Fixture *fixture, gconstpointer pData)
+{
+    QuickFill *qf = fixture->qf;
+    QuickFill *match;
+    int len;
+
+    g_assert (gnc_quickfill_get_unique_len_match (NULL, &len) == NULL);
+    g_assert_cmpint (len, == , 0);
+
+    gnc_quickfill_insert (qf, "Groceries", QUICKFILL_LIFO);
+    gnc_quickfill_insert (qf, "Gas", QUICKFILL_LIFO);
+
+    /* Only the G is common to both. */
+    match = gnc_quickfill_get_unique_len_match (qf, &len);
+    g_assert_cmpint (len, == , 1);
+    g_assert (match == gnc_quickfill_get_string_match (qf, "G"));
+
+    /* After "Gr" only one text is left. */
+    match = gnc_quickfill_get_unique_len_match
+            (gnc_quickfill_get_string_match (qf, "Gr"), &len);
+    g_assert_cmpint (len, == , 7);
+    g_assert (match == gnc_quickfill_get_string_match (qf, "Groceries"));
+    g_assert_cmpstr (gnc_quickfill_string (match), == , "Groceries");
+
+    /* A NULL length is allowed. */
+    g_assert (gnc_quickfill_get_unique_len_match
+              (gnc_quickfill_get_string_match (qf, "Ga"), NULL) ==
+              gnc_quickfill_get_string_match (qf, "Gas"));
+}
+
+static void
+test_case_collisions (Fixture *fixture, gconstpointer pData)
+{
+    QuickFill *qf = fixture->qf;
+
+    /* Lookups ignore case. */
+    gnc_quickfill_insert (qf, "apple", QUICKFILL_LIFO);
+    g_assert_cmpstr (match_text (qf, "APP"), == , "apple");
+
+    /* A longer text starting with the same letters in another case leaves
+     * the shorter one in place... */
+    gnc_quickfill_insert (qf, "Apple Store", QUICKFILL_LIFO);
+    g_assert_cmpstr (match_text (qf, "appl"), == , "apple");
+    g_assert_cmpstr (match_text (qf, "apple "), == , "Apple Store");
+
+    /* ...so removing the longer one doesn't lose it. */
+    gnc_quickfill_remove (qf, "Apple Store", QUICKFILL_LIFO);
+    g_assert_cmpstr (match_text (qf, "appl"), == , "apple");
+    g_assert_cmpstr (match_text (qf, "apple"), == , "apple");
+    g_assert (gnc_quickfill_get_string_match (qf, "apple ") == NULL);
+
+    /* Texts differing only in case share their nodes, holding the one
+     * inserted last. */
+    gnc_quickfill_insert (qf, "APPLE", QUICKFILL_LIFO);
+    g_assert_cmpstr (match_text (qf, "a"), == , "APPLE");
+    g_assert_cmpstr (match_text (qf, "apple"), == , "APPLE");
+    gnc_quickfill_remove (qf, "APPLE", QUICKFILL_LIFO);
+    g_assert (gnc_quickfill_get_string_match (qf, "a") == NULL);
+}
+
+void
+test_suite_quickfill (void)
+{
+    GNC_TEST_ADD (suitename, "insert", Fixture, NULL, setup, test_insert, teardown);
+    GNC_TEST_ADD (suitename, "remove", Fixture, NULL, setup, test_remove, teardown);
+    GNC_TEST_ADD (suitename, "get char match", Fixture, NULL, setup, test_get_char_match, teardown);
+    GNC_TEST_ADD (suitename, "get unique len match", Fixture, NULL, setup, test_get_unique_len_match, teardown);
+    GNC_TEST_ADD (suitename, "case collisions", Fixture, NULL, setup, test_case_collisions, teardown);
+}
@@ -788,6 +788,8 @@ GncDbiBackend<Type>::session_end ()
 {
     ENTER (" ");
 
+    if (connected())
+        end_change_session ();
     finalize_version_info ();
     connect(nullptr);
 
@@ -47,6 +47,18 @@ public:
                                 const GncSqlColumnInfo& info) = 0;
     virtual StrVec get_index_list (dbi_conn conn) = 0;
     virtual void drop_index(dbi_conn conn, const std::string& index) = 0;
+    virtual std::string quote_binary(const std::string& hex) = 0;
+    virtual std::string hex_to_binary_expr(const std::string& col) = 0;
+    /** Returns the statement opening a server-side cursor over a select, or
+     * an empty string if the database has no cursors libdbi can use.
+     */
+    virtual std::string declare_cursor(const std::string& cursor,
+                                       const std::string& sql) = 0;
+    /** Returns the statement reading the next count rows from a cursor. */
+    virtual std::string fetch_batch(const std::string& cursor,
+                                    size_t count) = 0;
+    /** Returns the statement releasing a cursor, empty if there is none. */
+    virtual std::string close_cursor(const std::string& cursor) = 0;
 };
 
 using GncDbiProviderPtr = std::unique_ptr<GncDbiProvider>;
@@ -46,6 +46,12 @@ public:
     void append_col_def(std::string& ddl, const GncSqlColumnInfo& info);
     StrVec get_index_list (dbi_conn conn);
     void drop_index(dbi_conn conn, const std::string& index);
+    std::string quote_binary(const std::string& hex);
+    std::string hex_to_binary_expr(const std::string& col);
+    std::string declare_cursor(const std::string& cursor,
+                               const std::string& sql);
+    std::string fetch_batch(const std::string& cursor, size_t count);
+    std::string close_cursor(const std::string& cursor);
 };
 
 template <DbType T> GncDbiProviderPtr
@@ -77,13 +83,17 @@ GncDbiProviderImpl<DbType::DBI_SQLITE>::append_col_def(std::string& ddl,
     {
         type_name = "text";
     }
+    else if (info.m_type == BCT_GUID)
+    {
+        type_name = "blob";
+    }
     else
     {
         PERR ("Unknown column type: %d\n", info.m_type);
         type_name = "";
     }
     ddl += (info.m_name + " " + type_name);
-    if (info.m_size != 0)
+    if (info.m_size != 0 && info.m_type != BCT_GUID)
     {
         ddl += "(" + std::to_string(info.m_size) + ")";
     }
@@ -132,6 +142,10 @@ GncDbiProviderImpl<DbType::DBI_MYSQL>::append_col_def (std::string& ddl,
     {
         type_name = "DATETIME NULL DEFAULT '1970-01-01 00:00:00'";
     }
+    else if (info.m_type == BCT_GUID)
+    {
+        type_name = "binary(16)";
+    }
     else
     {
         PERR ("Unknown column type: %d\n", info.m_type);
@@ -142,7 +156,7 @@ GncDbiProviderImpl<DbType::DBI_MYSQL>::append_col_def (std::string& ddl,
     {
         ddl += "(" + std::to_string(info.m_size) + ")";
     }
-    if (info.m_unicode)
+    if (info.m_unicode && info.m_type != BCT_GUID)
     {
         ddl += " CHARACTER SET utf8";
     }
@@ -199,6 +213,10 @@ GncDbiProviderImpl<DbType::DBI_PGSQL>::append_col_def (std::string& ddl,
     {
         type_name = "timestamp without time zone";
     }
+    else if (info.m_type == BCT_GUID)
+    {
+        type_name = "bytea";
+    }
     else
     {
         PERR ("Unknown column type: %d\n", info.m_type);
@@ -376,4 +394,85 @@ GncDbiProviderImpl<DbType::DBI_MYSQL>::drop_index (dbi_conn conn, const std::str
     if (result)
         dbi_result_free (result);
 }
+
+/* SQLite and MySQL share the standard X'' blob literal, PostgreSQL's bytea
+ * needs decode().
+ */
+template <DbType P> std::string
+GncDbiProviderImpl<P>::quote_binary(const std::string& hex)
+{
+    return "X'" + hex + "'";
+}
+
+template<> std::string
+GncDbiProviderImpl<DbType::DBI_PGSQL>::quote_binary(const std::string& hex)
+{
+    return "decode('" + hex + "', 'hex')";
+}
+
+/* unhex() requires SQLite 3.41 or later; with an older library converting an
+ * existing database fails and it keeps the hex layout.
+ */
+template <DbType P> std::string
+GncDbiProviderImpl<P>::hex_to_binary_expr(const std::string& col)
+{
+    return "unhex(" + col + ")";
+}
+
+template<> std::string
+GncDbiProviderImpl<DbType::DBI_MYSQL>::hex_to_binary_expr(const std::string& col)
+{
+    return "UNHEX(" + col + ")";
+}
+
+template<> std::string
+GncDbiProviderImpl<DbType::DBI_PGSQL>::hex_to_binary_expr(const std::string& col)
+{
+    return "decode(" + col + ", 'hex')";
+}
+
+/* libdbi always buffers a complete result on the client and has no cursor
+ * API, so only PostgreSQL, whose cursors are plain SQL, can stream a select.
+ * Paging SQLite and MySQL with LIMIT/OFFSET instead would cost a sort, or
+ * risk skipping or repeating rows without one, and rescan the skipped rows
+ * for every page; they read the whole result in one query.
+ */
+template <DbType P> std::string
+GncDbiProviderImpl<P>::declare_cursor(const std::string& cursor,
+                                      const std::string& sql)
+{
+    return std::string{};
+}
+
+template<> std::string
+GncDbiProviderImpl<DbType::DBI_PGSQL>::declare_cursor(const std::string& cursor,
+                                                      const std::string& sql)
+{
+    return "DECLARE " + cursor + " NO SCROLL CURSOR FOR " + sql;
+}
+
+template <DbType P> std::string
+GncDbiProviderImpl<P>::fetch_batch(const std::string& cursor, size_t count)
+{
+    return std::string{};
+}
+
+template<> std::string
+GncDbiProviderImpl<DbType::DBI_PGSQL>::fetch_batch(const std::string& cursor,
+                                                   size_t count)
+{
+    return "FETCH FORWARD " + std::to_string(count) + " FROM " + cursor;
+}
+
+template <DbType P> std::string
+GncDbiProviderImpl<P>::close_cursor(const std::string& cursor)
+{
+    return std::string{};
+}
+
+template<> std::string
+GncDbiProviderImpl<DbType::DBI_PGSQL>::close_cursor(const std::string& cursor)
+{
+    return "CLOSE " + cursor;
+}
 #endif //__GNC_DBISQLPROVIDERIMPL_HPP__
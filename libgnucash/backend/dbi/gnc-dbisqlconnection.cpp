@@ -89,7 +89,7 @@ GncDbiSqlConnection::GncDbiSqlConnection (DbType type, QofBackend* qbe,
             make_dbi_provider<DbType::DBI_MYSQL>() :
             make_dbi_provider<DbType::DBI_PGSQL>()},
     m_conn_ok{true}, m_last_error{ERR_BACKEND_NO_ERR}, m_error_repeat{0},
-    m_retry{false}, m_sql_savepoint{0}
+    m_retry{false}, m_sql_savepoint{0}, m_cursor_count{0}
 {
     if (!lock_database(ignore_lock))
         throw std::runtime_error("Failed to lock database!");
@@ -265,6 +265,94 @@ GncDbiSqlConnection::execute_select_statement (const GncSqlStatementPtr& stmt)
     return GncSqlResultPtr(new GncDbiSqlResult (this, result));
 }
 
+/* Only a database with server-side cursors streams a select; the others run
+ * it as an ordinary buffered select. PostgreSQL cursors exist only inside a
+ * transaction, which is held until the result is deleted.
+ */
+GncSqlResultPtr
+GncDbiSqlConnection::execute_streaming_select_statement (const GncSqlStatementPtr& stmt,
+                                                         size_t batch_size)
+    noexcept
+{
+    std::ostringstream cursor;
+    cursor << "gnc_cursor_" << m_cursor_count;
+    auto declare = m_provider->declare_cursor (cursor.str(), stmt->to_sql());
+    if (batch_size == 0 || declare.empty() || !begin_transaction ())
+        return execute_select_statement (stmt);
+
+    ++m_cursor_count;
+    GncDbiSqlStreamPtr stream{new GncDbiSqlStream{stmt->to_sql(),
+                                                  cursor.str(), batch_size,
+                                                  false}};
+    DEBUG ("SQL: %s\n", declare.c_str());
+    gnc_push_locale (LC_NUMERIC, "C");
+    init_error ();
+    auto result = dbi_conn_query (m_conn, declare.c_str());
+    gnc_pop_locale (LC_NUMERIC);
+    if (result == nullptr)
+    {
+        PERR ("Error declaring cursor for SQL %s\n", stmt->to_sql());
+        rollback_transaction ();
+        return execute_select_statement (stmt);
+    }
+    dbi_result_free (result);
+    result = fetch_batch (*stream);
+    if (result == nullptr)
+    {
+        close_stream (*stream);
+        return nullptr;
+    }
+    return GncSqlResultPtr(new GncDbiSqlResult (this, result, std::move(stream)));
+}
+
+/* A failed fetch marks the stream as failed; the caller must treat that as an
+ * error rather than as the end of the rows.
+ */
+dbi_result
+GncDbiSqlConnection::fetch_batch (GncDbiSqlStream& stream) noexcept
+{
+    auto sql = m_provider->fetch_batch (stream.cursor, stream.batch_size);
+    dbi_result result;
+
+    DEBUG ("SQL: %s\n", sql.c_str());
+    gnc_push_locale (LC_NUMERIC, "C");
+    do
+    {
+        init_error ();
+        result = dbi_conn_query (m_conn, sql.c_str());
+    }
+    while (m_retry);
+    if (result == nullptr)
+    {
+        PERR ("Error executing SQL %s\n", sql.c_str());
+        stream.failed = true;
+    }
+    gnc_pop_locale (LC_NUMERIC);
+    return result;
+}
+
+void
+GncDbiSqlConnection::close_stream (const GncDbiSqlStream& stream) noexcept
+{
+    /* The failed statement has aborted the transaction, cursor and all. */
+    if (stream.failed)
+    {
+        rollback_transaction ();
+        return;
+    }
+    auto close = m_provider->close_cursor (stream.cursor);
+    if (!close.empty())
+    {
+        DEBUG ("SQL: %s\n", close.c_str());
+        auto result = dbi_conn_query (m_conn, close.c_str());
+        if (result == nullptr)
+            PERR ("Error closing cursor %s\n", stream.cursor.c_str());
+        else
+            dbi_result_free (result);
+    }
+    commit_transaction ();
+}
+
 int
 GncDbiSqlConnection::execute_nonselect_statement (const GncSqlStatementPtr& stmt)
     noexcept
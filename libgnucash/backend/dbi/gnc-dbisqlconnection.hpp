@@ -46,6 +46,9 @@ public:
     ~GncDbiSqlConnection() override;
     GncSqlResultPtr execute_select_statement (const GncSqlStatementPtr&)
         noexcept override;
+    GncSqlResultPtr execute_streaming_select_statement (const GncSqlStatementPtr&,
+                                                        size_t batch_size)
+        noexcept override;
     int execute_nonselect_statement (const GncSqlStatementPtr&)
         noexcept override;
     GncSqlStatementPtr create_statement_from_sql (const std::string&)
@@ -60,6 +63,11 @@ public:
     bool add_columns_to_table (const std::string&, const ColVec&)
         const noexcept override;
     std::string quote_string (const std::string&) const noexcept override;
+    std::string quote_binary (const std::string& hex) const noexcept override {
+        return m_provider->quote_binary (hex); }
+    std::string hex_to_binary_expr (const std::string& col)
+        const noexcept override {
+        return m_provider->hex_to_binary_expr (col); }
     int dberror() const noexcept override {
         return dbi_conn_error(m_conn, nullptr); }
     QofBackend* qbe () const noexcept { return m_qbe; }
@@ -85,6 +93,10 @@ public:
     std::string add_columns_ddl(const std::string& table_name,
                                 const ColVec& info_vec) const noexcept;
     bool drop_indexes() noexcept;
+    /** Reads the next batch of a streaming select and advances it. */
+    dbi_result fetch_batch(GncDbiSqlStream& stream) noexcept;
+    /** Releases the cursor and the transaction held by a streaming select. */
+    void close_stream(const GncDbiSqlStream& stream) noexcept;
 private:
     QofBackend* m_qbe;
     dbi_conn m_conn;
@@ -108,6 +120,8 @@ private:
      */
     bool m_retry;
     unsigned int m_sql_savepoint;
+    /** Numbers the cursors of streaming selects so that they can nest. */
+    unsigned int m_cursor_count;
     bool lock_database(bool ignore_lock);
     void unlock_database();
     bool check_and_rollback_failed_save();
@@ -30,6 +30,7 @@ extern "C"
 /* For direct access to dbi data structs, sadly needed for datetime */
 #include <dbi/dbi-dev.h>
 }
+#include <cstring>
 #include <gnc-datetime.hpp>
 #include "gnc-dbisqlresult.hpp"
 #include "gnc-dbisqlconnection.hpp"
@@ -44,13 +45,15 @@ static QofLogModule log_module = G_LOG_DOMAIN;
 
 GncDbiSqlResult::~GncDbiSqlResult()
 {
-    int status = dbi_result_free (m_dbi_result);
+    int status = m_dbi_result ? dbi_result_free (m_dbi_result) : 0;
 
-    if (status == 0)
-        return;
-
-    PERR ("Error %d in dbi_result_free() result.", m_conn->dberror() );
-    qof_backend_set_error (m_conn->qbe(), ERR_BACKEND_SERVER_ERR);
+    if (status != 0)
+    {
+        PERR ("Error %d in dbi_result_free() result.", m_conn->dberror() );
+        qof_backend_set_error (m_conn->qbe(), ERR_BACKEND_SERVER_ERR);
+    }
+    if (m_stream)
+        m_conn->close_stream (*m_stream);
 }
 
 int
@@ -84,6 +87,29 @@ GncDbiSqlResult::size() const noexcept
 {
     return dbi_result_get_numrows(m_dbi_result);
 }
+
+GncSqlRow&
+GncDbiSqlResult::next_batch()
+{
+    /* A short batch is the last one; don't ask the server for more. */
+    if (!m_stream || m_dbi_result == nullptr ||
+        dbi_result_get_numrows (m_dbi_result) < m_stream->batch_size)
+        return m_sentinel;
+    if (dbi_result_free (m_dbi_result) != 0)
+    {
+        PERR ("Error %d in dbi_result_free() result.", dberror());
+        qof_backend_set_error (m_conn->qbe(), ERR_BACKEND_SERVER_ERR);
+    }
+    m_dbi_result = m_conn->fetch_batch (*m_stream);
+    /* Rows are missing, so the load that's reading them must fail. */
+    if (m_dbi_result == nullptr)
+    {
+        PERR ("Error fetching the next rows of %s", m_stream->sql.c_str());
+        qof_backend_set_error (m_conn->qbe(), ERR_BACKEND_SERVER_ERR);
+        return m_sentinel;
+    }
+    return begin();
+}
 /* --------------------------------------------------------- */
 
 GncSqlRow&
@@ -94,7 +120,7 @@ GncDbiSqlResult::IteratorImpl::operator++()
         return m_inst->m_row;
     int error = m_inst->dberror();
     if (error == DBI_ERROR_BADIDX || error == 0) //ran off the end of the results
-        return m_inst->m_sentinel;
+        return m_inst->next_batch();
     PERR("Error %d incrementing results iterator.", error);
     qof_backend_set_error (m_inst->m_conn->qbe(), ERR_BACKEND_SERVER_ERR);
     return m_inst->m_sentinel;
@@ -186,6 +212,28 @@ GncDbiSqlResult::IteratorImpl::get_time64_at_col (const char* col) const
     return retval;
 }
 
+GncGUID
+GncDbiSqlResult::IteratorImpl::get_guid_at_col (const char* col) const
+{
+    auto type = dbi_result_get_field_type (m_inst->m_dbi_result, col);
+    GncGUID guid;
+    if (type == DBI_TYPE_BINARY)
+    {
+        if (dbi_result_get_field_length (m_inst->m_dbi_result, col) !=
+            GUID_DATA_SIZE)
+            throw (std::invalid_argument{"Binary GUID column has the wrong size."});
+        auto data = dbi_result_get_binary (m_inst->m_dbi_result, col);
+        memcpy (guid.reserved, data, GUID_DATA_SIZE);
+        return guid;
+    }
+    if (type != DBI_TYPE_STRING)
+        throw (std::invalid_argument{"Requested GUID from non-GUID column."});
+    auto strval = dbi_result_get_string (m_inst->m_dbi_result, col);
+    if (strval == nullptr || !string_to_guid (strval, &guid))
+        throw (std::invalid_argument{"Column doesn't contain a GUID."});
+    return guid;
+}
+
 
 /* --------------------------------------------------------- */
 
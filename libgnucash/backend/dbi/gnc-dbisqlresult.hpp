@@ -28,18 +28,44 @@
 #include "gnc-backend-dbi.h"
 #include <gnc-sql-result.hpp>
 
+#include <memory>
+
 class GncDbiSqlConnection;
 
+/**
+ * State of a streaming select: sql is read batch_size rows at a time from the
+ * named server-side cursor. failed is set when a fetch fails.
+ */
+struct GncDbiSqlStream
+{
+    std::string sql;
+    std::string cursor;
+    size_t batch_size;
+    bool failed;
+};
+
+using GncDbiSqlStreamPtr = std::unique_ptr<GncDbiSqlStream>;
+
 /**
  * An iterable wrapper for dbi_result; allows using C++11 range for.
+ *
+ * A streaming result holds only the current batch of rows; the iterator fetches
+ * the next batch when it runs off the end of the current one. It can therefore
+ * be iterated only once: begin() returns to the start of the current batch.
  */
 class GncDbiSqlResult : public GncSqlResult
 {
 public:
-    GncDbiSqlResult(const GncDbiSqlConnection* conn, dbi_result result) :
+    GncDbiSqlResult(GncDbiSqlConnection* conn, dbi_result result) :
         m_conn{conn}, m_dbi_result{result}, m_iter{this}, m_row{&m_iter},
         m_sentinel{nullptr} {}
+    GncDbiSqlResult(GncDbiSqlConnection* conn, dbi_result result,
+                    GncDbiSqlStreamPtr stream) :
+        m_conn{conn}, m_dbi_result{result}, m_stream{std::move(stream)},
+        m_iter{this}, m_row{&m_iter}, m_sentinel{nullptr} {}
     ~GncDbiSqlResult();
+    /** For a streaming result, the number of rows in the current batch: use
+     * it only as a hint or to test for an empty result. */
     uint64_t size() const noexcept;
     int dberror() const noexcept;
     GncSqlRow& begin();
@@ -58,6 +84,7 @@ protected:
         virtual double get_double_at_col (const char* col) const;
         virtual std::string get_string_at_col (const char* col)const;
         virtual time64 get_time64_at_col (const char* col) const;
+        virtual GncGUID get_guid_at_col (const char* col) const;
         virtual bool is_col_null(const char* col) const noexcept
         {
             return dbi_result_field_is_null(m_inst->m_dbi_result, col);
@@ -67,8 +94,10 @@ protected:
     };
 
 private:
-    const GncDbiSqlConnection* m_conn;
+    GncSqlRow& next_batch();
+    GncDbiSqlConnection* m_conn;
     dbi_result m_dbi_result;
+    GncDbiSqlStreamPtr m_stream;
     IteratorImpl m_iter;
     GncSqlRow m_row;
     GncSqlRow m_sentinel;
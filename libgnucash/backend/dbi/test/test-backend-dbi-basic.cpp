@@ -50,9 +50,12 @@ extern "C"
 #include "gncInvoice.h"
     /* For version_control */
 #include <gnc-prefs.h>
+    /* For the binary GncGUID tests */
+#include <gnc-prefs-p.h>
 }
 /* For test_conn_index_functions */
 #include "../gnc-backend-dbi.hpp"
+#include <gnc-sql-column-table-entry.hpp>
 extern "C"
 {
 #include <unittest-support.h>
@@ -564,6 +567,363 @@ cleanup:
     qof_session_destroy (sess);
 }
 
+/* The binary GncGUID layout is chosen by a preference, so stand in for the
+ * preferences backend while the binary layout tests run.
+ */
+static gboolean
+get_bool_binary_guids (const gchar* group, const gchar* pref_name)
+{
+    return g_strcmp0 (pref_name, "sql-binary-guids") == 0;
+}
+
+static void
+set_binary_guids_pref (gboolean binary)
+{
+    static PrefsBackend backend;
+    backend.get_bool = get_bool_binary_guids;
+    prefsbackend = binary ? &backend : nullptr;
+}
+
+static GncSqlBackend*
+session_sql_backend (QofSession* session)
+{
+    return reinterpret_cast<GncSqlBackend*>(qof_session_get_backend (session));
+}
+
+/* Save a new database with binary GncGUID columns, load it back and
+ * compare. */
+static void
+test_dbi_binary_guids (Fixture* fixture, gconstpointer pData)
+{
+    auto url = (const gchar*)pData;
+
+    auto msg = "[GncDbiSqlConnection::unlock_database()] There was no lock entry in the Lock table";
+    auto log_domain = nullptr;
+    auto loglevel = static_cast<GLogLevelFlags> (G_LOG_LEVEL_WARNING |
+                                                 G_LOG_FLAG_FATAL);
+    TestErrorStruct* check = test_error_struct_new (log_domain, loglevel, msg);
+    fixture->hdlrs = test_log_set_fatal_handler (fixture->hdlrs, check,
+                                                 (GLogFunc)test_checked_handler);
+    if (fixture->filename)
+        url = fixture->filename;
+
+    set_binary_guids_pref (TRUE);
+    auto session_2 = qof_session_new ();
+    qof_session_begin (session_2, url, FALSE, TRUE, TRUE);
+    g_assert_cmpint (qof_session_get_error (session_2), == , ERR_BACKEND_NO_ERR);
+    qof_session_swap_data (fixture->session, session_2);
+    qof_session_save (session_2, NULL);
+    g_assert_cmpint (qof_session_get_error (session_2), == , ERR_BACKEND_NO_ERR);
+    g_assert (session_sql_backend (session_2)->binary_guids ());
+
+    /* The layout is read from the database, not from the preference. */
+    set_binary_guids_pref (FALSE);
+    auto session_3 = qof_session_new ();
+    qof_session_begin (session_3, url, TRUE, FALSE, FALSE);
+    g_assert_cmpint (qof_session_get_error (session_3), == , ERR_BACKEND_NO_ERR);
+    qof_session_load (session_3, NULL);
+    g_assert_cmpint (qof_session_get_error (session_3), == , ERR_BACKEND_NO_ERR);
+    auto sql_be = session_sql_backend (session_3);
+    g_assert (sql_be->binary_guids ());
+    g_assert_cmpint (sql_be->get_table_version ("Gnucash-Guid-Format"), == , 2);
+    compare_books (qof_session_get_book (session_2),
+                   qof_session_get_book (session_3));
+    qof_session_end (session_2);
+    qof_session_destroy (session_2);
+    qof_session_end (session_3);
+    qof_session_destroy (session_3);
+}
+
+/* Save a database with hex GncGUID columns and a GncGUID that isn't valid
+ * hex, then open it with the binary layout preferred: it must be left in the
+ * hex layout. Remove the bad GncGUID and open it again, and this time it must
+ * be converted. */
+static void
+test_dbi_convert_guids (Fixture* fixture, gconstpointer pData)
+{
+    auto url = (const gchar*)pData;
+
+    auto msg = "[GncDbiSqlConnection::unlock_database()] There was no lock entry in the Lock table";
+    auto log_domain = nullptr;
+    auto loglevel = static_cast<GLogLevelFlags> (G_LOG_LEVEL_WARNING |
+                                                 G_LOG_FLAG_FATAL);
+    TestErrorStruct* check = test_error_struct_new (log_domain, loglevel, msg);
+    fixture->hdlrs = test_log_set_fatal_handler (fixture->hdlrs, check,
+                                                 (GLogFunc)test_checked_handler);
+    if (fixture->filename)
+        url = fixture->filename;
+
+    set_binary_guids_pref (FALSE);
+    auto session_2 = qof_session_new ();
+    qof_session_begin (session_2, url, FALSE, TRUE, TRUE);
+    qof_session_swap_data (fixture->session, session_2);
+    qof_session_save (session_2, NULL);
+    g_assert_cmpint (qof_session_get_error (session_2), == , ERR_BACKEND_NO_ERR);
+    auto sql_be = session_sql_backend (session_2);
+    g_assert (!sql_be->binary_guids ());
+    /* Nothing loads a slot whose owner doesn't exist. */
+    auto stmt = sql_be->create_statement_from_sql (
+        "INSERT INTO slots (obj_guid, name, slot_type) VALUES "
+        "('not a hex guid, not a hex guid!!', 'bogus', 1)");
+    g_assert_cmpint (sql_be->execute_nonselect_statement (stmt), != , -1);
+    qof_session_end (session_2);
+
+    /* The conversion's complaints depend on the database. */
+    TestErrorStruct* quiet = test_error_struct_new (nullptr, loglevel, nullptr);
+    fixture->hdlrs = test_log_set_fatal_handler (fixture->hdlrs, quiet,
+                                                 (GLogFunc)test_null_handler);
+    set_binary_guids_pref (TRUE);
+    auto session_3 = qof_session_new ();
+    qof_session_begin (session_3, url, TRUE, FALSE, FALSE);
+    qof_session_load (session_3, NULL);
+    sql_be = session_sql_backend (session_3);
+    g_assert (!sql_be->binary_guids ());
+    g_assert_cmpint (sql_be->get_table_version ("Gnucash-Guid-Format"), == , 1);
+    compare_books (qof_session_get_book (session_2),
+                   qof_session_get_book (session_3));
+    stmt = sql_be->create_statement_from_sql (
+        "DELETE FROM slots WHERE name = 'bogus'");
+    g_assert_cmpint (sql_be->execute_nonselect_statement (stmt), != , -1);
+    qof_session_end (session_3);
+    qof_session_destroy (session_3);
+
+    session_3 = qof_session_new ();
+    qof_session_begin (session_3, url, TRUE, FALSE, FALSE);
+    qof_session_load (session_3, NULL);
+    g_assert_cmpint (qof_session_get_error (session_3), == , ERR_BACKEND_NO_ERR);
+    sql_be = session_sql_backend (session_3);
+    g_assert (sql_be->binary_guids ());
+    g_assert_cmpint (sql_be->get_table_version ("Gnucash-Guid-Format"), == , 2);
+    compare_books (qof_session_get_book (session_2),
+                   qof_session_get_book (session_3));
+    set_binary_guids_pref (FALSE);
+    qof_session_destroy (session_2);
+    qof_session_end (session_3);
+    qof_session_destroy (session_3);
+}
+
+/* Read the slots a couple of rows at a time and check that every row is read
+ * exactly once. On PostgreSQL, which reads them through a cursor, a fetch
+ * that fails part way must be reported as an error rather than end the rows
+ * early. */
+static void
+test_dbi_streaming_select (Fixture* fixture, gconstpointer pData)
+{
+    auto url = (const gchar*)pData;
+    auto is_pgsql = g_strcmp0 (url, TEST_PGSQL_URL) == 0;
+
+    auto msg = "[GncDbiSqlConnection::unlock_database()] There was no lock entry in the Lock table";
+    auto log_domain = nullptr;
+    auto loglevel = static_cast<GLogLevelFlags> (G_LOG_LEVEL_WARNING |
+                                                 G_LOG_FLAG_FATAL);
+    TestErrorStruct* check = test_error_struct_new (log_domain, loglevel, msg);
+    fixture->hdlrs = test_log_set_fatal_handler (fixture->hdlrs, check,
+                                                 (GLogFunc)test_checked_handler);
+    if (fixture->filename)
+        url = fixture->filename;
+
+    auto session_2 = qof_session_new ();
+    qof_session_begin (session_2, url, FALSE, TRUE, TRUE);
+    qof_session_swap_data (fixture->session, session_2);
+    qof_session_save (session_2, NULL);
+    g_assert_cmpint (qof_session_get_error (session_2), == , ERR_BACKEND_NO_ERR);
+    auto sql_be = session_sql_backend (session_2);
+
+    auto stmt = sql_be->create_statement_from_sql ("SELECT id FROM slots");
+    std::vector<int64_t> expected, found;
+    auto result = sql_be->execute_select_statement (stmt);
+    for (auto row : *result)
+        expected.push_back (row.get_int_at_col ("id"));
+    delete result;
+    g_assert_cmpint (expected.size (), > , 2);
+
+    result = sql_be->execute_streaming_select_statement (stmt, 2);
+    for (auto row : *result)
+        found.push_back (row.get_int_at_col ("id"));
+    delete result;
+    g_assert (!sql_be->check_error ());
+    std::sort (expected.begin (), expected.end ());
+    std::sort (found.begin (), found.end ());
+    g_assert (found == expected);
+
+    if (is_pgsql)
+    {
+        /* A failed statement aborts the transaction holding the cursor. */
+        TestErrorStruct* quiet = test_error_struct_new (nullptr, loglevel,
+                                                        nullptr);
+        fixture->hdlrs = test_log_set_fatal_handler (fixture->hdlrs, quiet,
+                                                     (GLogFunc)test_null_handler);
+        auto bad = sql_be->create_statement_from_sql ("SELECT * FROM no_such_table");
+        found.clear ();
+        result = sql_be->execute_streaming_select_statement (stmt, 2);
+        for (auto row : *result)
+        {
+            found.push_back (row.get_int_at_col ("id"));
+            if (found.size () == 1)
+            {
+                (void)sql_be->execute_nonselect_statement (bad);
+                (void)qof_backend_get_error (sql_be);
+            }
+        }
+        delete result;
+        g_assert_cmpint (found.size (), < , expected.size ());
+        g_assert_cmpint (qof_backend_get_error (sql_be), == ,
+                         ERR_BACKEND_SERVER_ERR);
+    }
+    qof_session_end (session_2);
+    qof_session_destroy (session_2);
+}
+
+static size_t
+count_changes (GncSqlBackend* sql_be)
+{
+    auto stmt = sql_be->create_statement_from_sql ("SELECT id FROM changes");
+    auto result = sql_be->execute_select_statement (stmt);
+    g_assert (result != nullptr);
+    auto count = result->size ();
+    delete result;
+    return count;
+}
+
+/* Open the database in two sessions. A session alone doesn't log its
+ * commits; once another has joined, an edit to an object that the other
+ * session has changed meanwhile must be refused, and the other session's
+ * change reloaded. The log is emptied once only one session is left. */
+static void
+test_dbi_conflicts (Fixture* fixture, gconstpointer pData)
+{
+    auto url = (const gchar*)pData;
+
+    auto msg = "[GncDbiSqlConnection::unlock_database()] There was no lock entry in the Lock table";
+    auto log_domain = nullptr;
+    auto loglevel = static_cast<GLogLevelFlags> (G_LOG_LEVEL_WARNING |
+                                                 G_LOG_FLAG_FATAL);
+    TestErrorStruct* check = test_error_struct_new (log_domain, loglevel, msg);
+    fixture->hdlrs = test_log_set_fatal_handler (fixture->hdlrs, check,
+                                                 (GLogFunc)test_checked_handler);
+    if (fixture->filename)
+        url = fixture->filename;
+
+    auto session_1 = qof_session_new ();
+    qof_session_begin (session_1, url, FALSE, TRUE, TRUE);
+    qof_session_swap_data (fixture->session, session_1);
+    qof_session_save (session_1, NULL);
+    g_assert_cmpint (qof_session_get_error (session_1), == , ERR_BACKEND_NO_ERR);
+    auto sql_be_1 = session_sql_backend (session_1);
+    auto root_1 = gnc_book_get_root_account (qof_session_get_book (session_1));
+    auto acct_1 = gnc_account_lookup_by_name (root_1, "Bank 1");
+    g_assert (acct_1 != nullptr);
+
+    xaccAccountBeginEdit (acct_1);
+    xaccAccountSetDescription (acct_1, "Alone");
+    xaccAccountCommitEdit (acct_1);
+    g_assert_cmpint (count_changes (sql_be_1), == , 0);
+
+    auto session_2 = qof_session_new ();
+    qof_session_begin (session_2, url, TRUE, FALSE, FALSE);
+    qof_session_load (session_2, NULL);
+    g_assert_cmpint (qof_session_get_error (session_2), == , ERR_BACKEND_NO_ERR);
+    auto sql_be_2 = session_sql_backend (session_2);
+    auto acct_2 = xaccAccountLookup (qof_entity_get_guid (acct_1),
+                                     qof_session_get_book (session_2));
+    g_assert (acct_2 != nullptr);
+    g_assert_cmpstr (xaccAccountGetDescription (acct_2), == , "Alone");
+
+    xaccAccountBeginEdit (acct_1);
+    xaccAccountSetDescription (acct_1, "First");
+    xaccAccountCommitEdit (acct_1);
+    g_assert_cmpint (count_changes (sql_be_1), == , 1);
+
+    /* The engine reports the refused commit. */
+    TestErrorStruct* quiet = test_error_struct_new (nullptr, loglevel, nullptr);
+    fixture->hdlrs = test_log_set_fatal_handler (fixture->hdlrs, quiet,
+                                                 (GLogFunc)test_null_handler);
+    xaccAccountBeginEdit (acct_2);
+    xaccAccountSetDescription (acct_2, "Second");
+    xaccAccountCommitEdit (acct_2);
+    g_assert_cmpint (qof_backend_get_error (sql_be_2), == ,
+                     ERR_BACKEND_MODIFIED);
+    g_assert_cmpint (count_changes (sql_be_2), == , 1);
+
+    g_assert (sql_be_2->events_pending ());
+    sql_be_2->process_events ();
+    g_assert_cmpstr (xaccAccountGetDescription (acct_2), == , "First");
+    g_assert (!sql_be_2->events_pending ());
+
+    qof_session_end (session_2);
+    qof_session_destroy (session_2);
+    g_assert_cmpint (count_changes (sql_be_1), == , 0);
+    qof_session_end (session_1);
+    qof_session_destroy (session_1);
+}
+
+/* object_in_db() remembers the rows it has found so that saving a
+ * transaction doesn't look its currency up again each time, and
+ * do_db_operation() keeps what it remembers in step with the rows it
+ * writes. */
+static void
+test_dbi_known_rows (Fixture* fixture, gconstpointer pData)
+{
+    auto url = (const gchar*)pData;
+
+    auto msg = "[GncDbiSqlConnection::unlock_database()] There was no lock entry in the Lock table";
+    auto log_domain = nullptr;
+    auto loglevel = static_cast<GLogLevelFlags> (G_LOG_LEVEL_WARNING |
+                                                 G_LOG_FLAG_FATAL);
+    TestErrorStruct* check = test_error_struct_new (log_domain, loglevel, msg);
+    fixture->hdlrs = test_log_set_fatal_handler (fixture->hdlrs, check,
+                                                 (GLogFunc)test_checked_handler);
+    if (fixture->filename)
+        url = fixture->filename;
+
+    auto session_2 = qof_session_new ();
+    qof_session_begin (session_2, url, FALSE, TRUE, TRUE);
+    qof_session_swap_data (fixture->session, session_2);
+    qof_session_save (session_2, NULL);
+    g_assert_cmpint (qof_session_get_error (session_2), == , ERR_BACKEND_NO_ERR);
+    auto sql_be = session_sql_backend (session_2);
+    auto root = gnc_book_get_root_account (qof_session_get_book (session_2));
+    auto acct = gnc_account_lookup_by_name (root, "Bank 1");
+    g_assert (acct != nullptr);
+    auto comm = xaccAccountGetCommodity (acct);
+    auto guid = sql_be->quote_guid (qof_entity_get_guid (comm));
+
+    EntryVec guid_table
+    {
+        gnc_sql_make_table_entry<CT_GUID>("guid", 0, COL_NNUL | COL_PKEY, "guid"),
+    };
+    auto delete_stmt = sql_be->create_statement_from_sql
+        ("DELETE FROM commodities WHERE guid = " + guid);
+    auto select_stmt = sql_be->create_statement_from_sql
+        ("SELECT guid FROM commodities WHERE guid = " + guid);
+
+    g_assert (sql_be->object_in_db ("commodities", GNC_ID_COMMODITY, comm,
+                                    guid_table));
+    /* Found once, the row isn't looked up again. */
+    g_assert_cmpint (sql_be->execute_nonselect_statement (delete_stmt), == , 1);
+    g_assert (sql_be->object_in_db ("commodities", GNC_ID_COMMODITY, comm,
+                                    guid_table));
+    /* Deleting it through the backend forgets it. */
+    g_assert (sql_be->do_db_operation (OP_DB_DELETE, "commodities",
+                                       GNC_ID_COMMODITY, comm, guid_table));
+    g_assert (!sql_be->object_in_db ("commodities", GNC_ID_COMMODITY, comm,
+                                     guid_table));
+
+    /* Saving the commodity now inserts it again, and the insert is
+     * remembered. */
+    g_assert (sql_be->save_commodity (comm));
+    auto result = sql_be->execute_select_statement (select_stmt);
+    g_assert (result != nullptr);
+    g_assert_cmpint (result->size (), == , 1);
+    delete result;
+    g_assert_cmpint (sql_be->execute_nonselect_statement (delete_stmt), == , 1);
+    g_assert (sql_be->object_in_db ("commodities", GNC_ID_COMMODITY, comm,
+                                    guid_table));
+
+    qof_session_end (session_2);
+    qof_session_destroy (session_2);
+}
+
 static void
 test_dbi_business_store_and_reload (Fixture* fixture, gconstpointer pData)
 {
@@ -646,6 +1006,16 @@ create_dbi_test_suite (const char* dbm_name, const char* url)
                   test_dbi_version_control, teardown);
     GNC_TEST_ADD (subsuite, "business_store_and_reload", Fixture, url,
                   setup_business, test_dbi_version_control, teardown);
+    GNC_TEST_ADD (subsuite, "binary_guids", Fixture, url, setup_memory,
+                  test_dbi_binary_guids, teardown);
+    GNC_TEST_ADD (subsuite, "convert_guids", Fixture, url, setup_memory,
+                  test_dbi_convert_guids, teardown);
+    GNC_TEST_ADD (subsuite, "streaming_select", Fixture, url, setup_memory,
+                  test_dbi_streaming_select, teardown);
+    GNC_TEST_ADD (subsuite, "conflicts", Fixture, url, setup_memory,
+                  test_dbi_conflicts, teardown);
+    GNC_TEST_ADD (subsuite, "known_rows", Fixture, url, setup_memory,
+                  test_dbi_known_rows, teardown);
     g_free (subsuite);
 
 }
@@ -390,12 +390,13 @@ GncSqlColumnTableEntryImpl<CT_ACCOUNTREF>::add_to_table(ColVec& vec) const noexc
 }
 
 template<> void
-GncSqlColumnTableEntryImpl<CT_ACCOUNTREF>::add_to_query(QofIdTypeConst obj_name,
+GncSqlColumnTableEntryImpl<CT_ACCOUNTREF>::add_to_query(const GncSqlBackend* sql_be,
+                                                        QofIdTypeConst obj_name,
                                                         const gpointer pObject,
                                                         PairVec& vec)
     const noexcept
 {
-    add_objectref_guid_to_query(obj_name, pObject, vec);
+    add_objectref_guid_to_query(sql_be, obj_name, pObject, vec);
 }
 
 /* ========================== END OF FILE ===================== */
@@ -199,15 +199,12 @@ set_amount (gpointer pObj, gnc_numeric value)
 static void
 load_budget_amounts (GncSqlBackend* sql_be, GncBudget* budget)
 {
-    gchar guid_buf[GUID_ENCODING_LENGTH + 1];
-
     g_return_if_fail (sql_be != NULL);
     g_return_if_fail (budget != NULL);
 
-    (void)guid_to_string_buff (qof_instance_get_guid (QOF_INSTANCE (budget)),
-                               guid_buf);
-    auto sql = g_strdup_printf ("SELECT * FROM %s WHERE budget_guid='%s'",
-                                AMOUNTS_TABLE, guid_buf);
+    auto guid_str = sql_be->quote_guid (qof_instance_get_guid (QOF_INSTANCE (budget)));
+    auto sql = g_strdup_printf ("SELECT * FROM %s WHERE budget_guid=%s",
+                                AMOUNTS_TABLE, guid_str.c_str());
     auto stmt = sql_be->create_statement_from_sql(sql);
     g_free (sql);
     if (stmt != nullptr)
@@ -229,16 +226,12 @@ load_budget_amounts (GncSqlBackend* sql_be, GncBudget* budget)
 static gboolean
 delete_budget_amounts (GncSqlBackend* sql_be, GncBudget* budget)
 {
-    gchar guid_buf[GUID_ENCODING_LENGTH + 1];
-
     g_return_val_if_fail (sql_be != NULL, FALSE);
     g_return_val_if_fail (budget != NULL, FALSE);
 
-    (void)guid_to_string_buff (qof_instance_get_guid (QOF_INSTANCE (budget)),
-                               guid_buf);
     std::stringstream sql;
-    sql << "DELETE FROM " << AMOUNTS_TABLE << " WHERE budget_guid='"<<
-        guid_buf << "'";
+    sql << "DELETE FROM " << AMOUNTS_TABLE << " WHERE budget_guid=" <<
+        sql_be->quote_guid (qof_instance_get_guid (QOF_INSTANCE (budget)));
     auto stmt = sql_be->create_statement_from_sql(sql.str());
     sql_be->execute_nonselect_statement(stmt);
 
@@ -367,6 +360,15 @@ GncSqlBudgetBackend::create_tables (GncSqlBackend* sql_be)
     }
 }
 
+bool
+GncSqlBudgetBackend::upgrade_guid_columns (GncSqlBackend* sql_be)
+{
+    g_return_val_if_fail (sql_be != NULL, false);
+
+    return sql_be->upgrade_guid_columns (BUDGET_TABLE, col_table) &&
+        sql_be->upgrade_guid_columns (AMOUNTS_TABLE, budget_amounts_col_table);
+}
+
 /* ================================================================= */
 bool
 GncSqlBudgetBackend::commit (GncSqlBackend* sql_be, QofInstance* inst)
@@ -478,11 +480,12 @@ GncSqlColumnTableEntryImpl<CT_BUDGETREF>::add_to_table(ColVec& vec) const noexce
 }
 
 template<> void
-GncSqlColumnTableEntryImpl<CT_BUDGETREF>::add_to_query(QofIdTypeConst obj_name,
+GncSqlColumnTableEntryImpl<CT_BUDGETREF>::add_to_query(const GncSqlBackend* sql_be,
+                                                    QofIdTypeConst obj_name,
                                                     const gpointer pObject,
                                                     PairVec& vec) const noexcept
 {
-    add_objectref_guid_to_query(obj_name, pObject, vec);
+    add_objectref_guid_to_query(sql_be, obj_name, pObject, vec);
 }
 
 /* ========================== END OF FILE ===================== */
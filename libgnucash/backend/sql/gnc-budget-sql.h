@@ -37,6 +37,7 @@ public:
     GncSqlBudgetBackend();
     void load_all(GncSqlBackend*) override;
     void create_tables(GncSqlBackend*) override;
+    bool upgrade_guid_columns(GncSqlBackend*) override;
     bool commit (GncSqlBackend* sql_be, QofInstance* inst) override;
     bool write(GncSqlBackend*) override;
 private:
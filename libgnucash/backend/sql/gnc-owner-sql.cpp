@@ -69,9 +69,8 @@ GncSqlColumnTableEntryImpl<CT_OWNERREF>::load (const GncSqlBackend* sql_be,
     {
         type = static_cast<decltype(type)>(row.get_int_at_col (buf.c_str()));
         buf = std::string{m_col_name} + "_guid";
-        auto val = row.get_string_at_col (buf.c_str());
-        if (string_to_guid (val.c_str(), &guid))
-            pGuid = &guid;
+        guid = row.get_guid_at_col (buf.c_str());
+        pGuid = &guid;
     }
     catch (std::invalid_argument)
     {
@@ -165,13 +164,14 @@ GncSqlColumnTableEntryImpl<CT_OWNERREF>::add_to_table(ColVec& vec) const noexcep
     vec.emplace_back(std::move(info));
 /* Buf isn't leaking, it belongs to ColVec now. */
     buf = g_strdup_printf ("%s_guid", m_col_name);
-    GncSqlColumnInfo info2(buf, BCT_STRING, GUID_ENCODING_LENGTH, false, false,
+    GncSqlColumnInfo info2(buf, BCT_GUID, GUID_ENCODING_LENGTH, false, false,
                            m_flags & COL_PKEY, m_flags & COL_NNUL);
     vec.emplace_back(std::move(info2));
 }
 
 template<> void
-GncSqlColumnTableEntryImpl<CT_OWNERREF>::add_to_query(QofIdTypeConst obj_name,
+GncSqlColumnTableEntryImpl<CT_OWNERREF>::add_to_query(const GncSqlBackend* sql_be,
+                                                      QofIdTypeConst obj_name,
                                                       const gpointer pObject,
                                                       PairVec& vec) const noexcept
 {
@@ -225,11 +225,9 @@ GncSqlColumnTableEntryImpl<CT_OWNERREF>::add_to_query(QofIdTypeConst obj_name,
 
     buf << type;
     vec.emplace_back(std::make_pair(type_hdr, quote_string(buf.str())));
-    buf.str("");
     auto guid = qof_instance_get_guid(inst);
     if (guid != nullptr)
-        buf << guid_to_string(guid);
+        vec.emplace_back(std::make_pair(guid_hdr, sql_be->quote_guid(guid)));
     else
-        buf << "NULL";
-    vec.emplace_back(std::make_pair(guid_hdr, quote_string(buf.str())));
+        vec.emplace_back(std::make_pair(guid_hdr, std::string{"NULL"}));
 }
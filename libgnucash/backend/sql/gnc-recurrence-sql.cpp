@@ -308,14 +308,13 @@ static  GncSqlResultPtr
 gnc_sql_set_recurrences_from_db (GncSqlBackend* sql_be, const GncGUID* guid)
 {
     gchar* buf;
-    gchar guid_buf[GUID_ENCODING_LENGTH + 1];
 
     g_return_val_if_fail (sql_be != NULL, NULL);
     g_return_val_if_fail (guid != NULL, NULL);
 
-    (void)guid_to_string_buff (guid, guid_buf);
-    buf = g_strdup_printf ("SELECT * FROM %s WHERE obj_guid='%s'", TABLE_NAME,
-                           guid_buf);
+    auto guid_str = sql_be->quote_guid (guid);
+    buf = g_strdup_printf ("SELECT * FROM %s WHERE obj_guid=%s", TABLE_NAME,
+                           guid_str.c_str());
     auto stmt = sql_be->create_statement_from_sql (buf);
     g_free (buf);
     auto result = sql_be->execute_select_statement(stmt);
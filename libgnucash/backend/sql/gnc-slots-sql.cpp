@@ -683,17 +683,15 @@ gboolean
 gnc_sql_slots_delete (GncSqlBackend* sql_be, const GncGUID* guid)
 {
     gchar* buf;
-    gchar guid_buf[GUID_ENCODING_LENGTH + 1];
     slot_info_t slot_info = { NULL, NULL, TRUE, NULL, KvpValue::Type::INVALID,
                               NULL, FRAME, NULL, "" };
 
     g_return_val_if_fail (sql_be != NULL, FALSE);
     g_return_val_if_fail (guid != NULL, FALSE);
 
-    (void)guid_to_string_buff (guid, guid_buf);
-
-    buf = g_strdup_printf ("SELECT * FROM %s WHERE obj_guid='%s' and slot_type in ('%d', '%d') and not guid_val is null",
-                           TABLE_NAME, guid_buf, KvpValue::Type::FRAME, KvpValue::Type::GLIST);
+    auto guid_str = sql_be->quote_guid (guid);
+    buf = g_strdup_printf ("SELECT * FROM %s WHERE obj_guid=%s and slot_type in ('%d', '%d') and not guid_val is null",
+                           TABLE_NAME, guid_str.c_str(), KvpValue::Type::FRAME, KvpValue::Type::GLIST);
     auto stmt = sql_be->create_statement_from_sql(buf);
     g_free (buf);
     if (stmt != nullptr)
@@ -705,10 +703,8 @@ gnc_sql_slots_delete (GncSqlBackend* sql_be, const GncGUID* guid)
             {
                 const GncSqlColumnTableEntryPtr table_row =
                     col_table[guid_val_col];
-                GncGUID child_guid;
-                auto val = row.get_string_at_col (table_row->name());
-                if (string_to_guid (val.c_str(), &child_guid))
-                    gnc_sql_slots_delete (sql_be, &child_guid);
+                auto child_guid = row.get_guid_at_col (table_row->name());
+                gnc_sql_slots_delete (sql_be, &child_guid);
             }
             catch (std::invalid_argument)
             {
@@ -773,18 +769,14 @@ gnc_sql_slots_load (GncSqlBackend* sql_be, QofInstance* inst)
 static void
 slots_load_info (slot_info_t* pInfo)
 {
-    gchar guid_buf[GUID_ENCODING_LENGTH + 1];
-
     g_return_if_fail (pInfo != NULL);
     g_return_if_fail (pInfo->be != NULL);
     g_return_if_fail (pInfo->guid != NULL);
     g_return_if_fail (pInfo->pKvpFrame != NULL);
 
-    (void)guid_to_string_buff (pInfo->guid, guid_buf);
-
     std::stringstream buf;
     buf << "SELECT * FROM " << TABLE_NAME <<
-        " WHERE obj_guid='" << guid_buf << "'";
+        " WHERE obj_guid=" << pInfo->be->quote_guid (pInfo->guid);
     auto stmt = pInfo->be->create_statement_from_sql (buf.str());
     if (stmt != nullptr)
     {
@@ -854,7 +846,7 @@ gnc_sql_slots_load_for_instancevec (GncSqlBackend* sql_be, InstanceVec& instance
     else
         sql << " = ";
 
-    gnc_sql_append_guids_to_sql (sql, instances);
+    gnc_sql_append_guids_to_sql (sql_be, sql, instances);
     if (instances.size() > 1)
         sql << ")";
 
@@ -865,9 +857,12 @@ gnc_sql_slots_load_for_instancevec (GncSqlBackend* sql_be, InstanceVec& instance
         PERR ("stmt == NULL, SQL = '%s'\n", sql.str().c_str());
         return;
     }
-    auto result = sql_be->execute_select_statement (stmt);
+    auto result = sql_be->execute_streaming_select_statement (stmt);
+    if (result == nullptr)
+        return;
     for (auto row : *result)
         load_slot_for_list_item (sql_be, row, coll);
+    delete result;
 }
 
 static void
@@ -927,7 +922,9 @@ void gnc_sql_slots_load_for_sql_subquery (GncSqlBackend* sql_be,
         return;
     }
     g_free (sql);
-    auto result = sql_be->execute_select_statement(stmt);
+    auto result = sql_be->execute_streaming_select_statement(stmt);
+    if (result == nullptr)
+        return;
     for (auto row : *result)
         load_slot_for_book_object (sql_be, row, lookup_fn);
     delete result;
@@ -989,4 +986,14 @@ GncSqlSlotsBackend::create_tables (GncSqlBackend* sql_be)
     }
 }
 
+bool
+GncSqlSlotsBackend::upgrade_guid_columns (GncSqlBackend* sql_be)
+{
+    g_return_val_if_fail (sql_be != NULL, false);
+
+    return sql_be->upgrade_guid_columns (TABLE_NAME, col_table,
+                                         {{"slots_guid_index",
+                                           obj_guid_col_table}});
+}
+
 /* ========================== END OF FILE ===================== */
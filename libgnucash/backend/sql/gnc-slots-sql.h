@@ -46,6 +46,7 @@ public:
     GncSqlSlotsBackend();
     void load_all(GncSqlBackend*) override { return; }
     void create_tables(GncSqlBackend*) override;
+    bool upgrade_guid_columns(GncSqlBackend*) override;
     bool commit(GncSqlBackend*, QofInstance*) override { return false; }
 };
 
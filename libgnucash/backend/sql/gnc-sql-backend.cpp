@@ -32,10 +32,13 @@ extern "C"
 #include <gncTaxTable.h>
 #include <gncInvoice.h>
 #include <gnc-pricedb.h>
+#include <Split.h>
+#include <Transaction.h>
 }
 
 #include <algorithm>
 #include <cassert>
+#include <stdexcept>
 
 #include "gnc-sql-connection.hpp"
 #include "gnc-sql-backend.hpp"
@@ -69,6 +72,32 @@ static QofLogModule log_module = G_LOG_DOMAIN;
 #define MAX_TABLE_NAME_LEN 50
 #define TABLE_COL_NAME "table_name"
 #define VERSION_COL_NAME "table_version"
+/* The GncGUID layout is recorded in the versions table like a table version:
+ * 1 is the 32-character hex string layout, 2 the 16-byte binary one.
+ */
+#define GUID_FORMAT_NAME "Gnucash-Guid-Format"
+#define GUID_FORMAT_TEXT 1
+#define GUID_FORMAT_BINARY 2
+#define GNC_PREF_SQL_BINARY_GUIDS "sql-binary-guids"
+/* While more than one session has the database open, every commit appends a
+ * row to the changes table so that the other sessions can find out what to
+ * reload and detect conflicting edits. The sessions are listed in the
+ * change_sessions table with the newest change each has applied; rows that
+ * every other session has applied are deleted.
+ */
+#define CHANGES_TABLE_NAME "changes"
+#define CHANGES_TABLE_VERSION 1
+#define CHANGE_ID_COL "id"
+#define CHANGE_SESSION_COL "session_guid"
+#define CHANGE_TYPE_COL "obj_type"
+#define CHANGE_GUID_COL "obj_guid"
+#define CHANGE_SESSIONS_TABLE_NAME "change_sessions"
+#define CHANGE_SESSIONS_TABLE_VERSION 1
+#define CHANGE_LAST_ID_COL "last_change"
+#define CHANGE_LAST_SEEN_COL "last_seen"
+/* A session that hasn't been seen for a week is presumed to have crashed. */
+#define CHANGE_SESSION_TIMEOUT (7 * 24 * 60 * 60)
+#define CHANGE_SESSION_REFRESH (60 * 60)
 
 using StrVec = std::vector<std::string>;
 
@@ -79,10 +108,31 @@ static EntryVec version_table
     gnc_sql_make_table_entry<CT_INT>(VERSION_COL_NAME, 0, COL_NNUL)
 };
 
+static EntryVec changes_table
+{
+    gnc_sql_make_table_entry<CT_INT>(
+        CHANGE_ID_COL, 0, COL_PKEY | COL_NNUL | COL_AUTOINC),
+    gnc_sql_make_table_entry<CT_GUID>(CHANGE_SESSION_COL, 0, COL_NNUL),
+    gnc_sql_make_table_entry<CT_STRING>(
+        CHANGE_TYPE_COL, MAX_TABLE_NAME_LEN, COL_NNUL),
+    gnc_sql_make_table_entry<CT_GUID>(CHANGE_GUID_COL, 0, COL_NNUL)
+};
+
+static EntryVec change_sessions_table
+{
+    gnc_sql_make_table_entry<CT_GUID>(
+        CHANGE_SESSION_COL, 0, COL_PKEY | COL_NNUL),
+    gnc_sql_make_table_entry<CT_INT64>(CHANGE_LAST_ID_COL, 0, COL_NNUL),
+    gnc_sql_make_table_entry<CT_INT64>(CHANGE_LAST_SEEN_COL, 0, COL_NNUL)
+};
+
 GncSqlBackend::GncSqlBackend(GncSqlConnection *conn, QofBook* book) :
     QofBackend {}, m_conn{conn}, m_book{book}, m_loading{false},
-    m_in_query{false}, m_is_pristine_db{false}
+    m_in_query{false}, m_is_pristine_db{false}, m_binary_guids{false},
+    m_change_log{false}, m_change_session{false}, m_last_change{0},
+    m_session_seen{0}
 {
+    guid_replace (&m_session_guid);
     if (conn != nullptr)
         connect (conn);
 }
@@ -93,6 +143,7 @@ GncSqlBackend::connect(GncSqlConnection *conn) noexcept
     if (m_conn != nullptr && m_conn != conn)
         delete m_conn;
     finalize_version_info();
+    m_known_rows.clear();
     m_conn = conn;
 }
 
@@ -120,6 +171,19 @@ GncSqlBackend::execute_select_statement(const GncSqlStatementPtr& stmt) const no
     return result;
 }
 
+GncSqlResultPtr
+GncSqlBackend::execute_streaming_select_statement(const GncSqlStatementPtr& stmt,
+                                                  size_t batch_size) const noexcept
+{
+    auto result = m_conn->execute_streaming_select_statement(stmt, batch_size);
+    if (result == nullptr)
+    {
+        PERR ("SQL error: %s\n", stmt->to_sql());
+        qof_backend_set_error ((QofBackend*)this, ERR_BACKEND_SERVER_ERR);
+    }
+    return result;
+}
+
 int
 GncSqlBackend::execute_nonselect_statement(const GncSqlStatementPtr& stmt) const noexcept
 {
@@ -138,19 +202,42 @@ GncSqlBackend::quote_string(const std::string& str) const noexcept
     return m_conn->quote_string(str);
 }
 
-bool
-GncSqlBackend::create_table(const std::string& table_name,
-                            const EntryVec& col_table) const noexcept
+std::string
+GncSqlBackend::quote_guid(const GncGUID* guid) const noexcept
+{
+    if (guid == nullptr)
+        return "NULL";
+    char guid_buf[GUID_ENCODING_LENGTH + 1];
+    (void)guid_to_string_buff (guid, guid_buf);
+    if (m_binary_guids)
+        return m_conn->quote_binary (guid_buf);
+    return std::string{"'"} + guid_buf + "'";
+}
+
+/* The column tables describe GncGUIDs as BCT_GUID; databases still using the
+ * hex layout get the same varchar columns they've always had.
+ */
+ColVec
+GncSqlBackend::make_col_vec(const EntryVec& col_table) const noexcept
 {
     ColVec info_vec;
-    gboolean ok = FALSE;
 
     for (auto const& table_row : col_table)
     {
         table_row->add_to_table (info_vec);
     }
-    return m_conn->create_table (table_name, info_vec);
+    if (!m_binary_guids)
+        for (auto& info : info_vec)
+            if (info.m_type == BCT_GUID)
+                info.m_type = BCT_STRING;
+    return info_vec;
+}
 
+bool
+GncSqlBackend::create_table(const std::string& table_name,
+                            const EntryVec& col_table) const noexcept
+{
+    return m_conn->create_table (table_name, make_col_vec(col_table));
 }
 
 bool
@@ -174,13 +261,7 @@ bool
 GncSqlBackend::add_columns_to_table(const std::string& table_name,
                                     const EntryVec& col_table) const noexcept
 {
-    ColVec info_vec;
-
-    for (auto const& table_row : col_table)
-    {
-        table_row->add_to_table (info_vec);
-    }
-    return m_conn->add_columns_to_table(table_name, info_vec);
+    return m_conn->add_columns_to_table(table_name, make_col_vec(col_table));
 }
 
 void
@@ -205,6 +286,101 @@ GncSqlBackend::create_tables() noexcept
         update_progress();
         std::get<1>(entry)->create_tables(this);
     }
+    if (!m_binary_guids &&
+        gnc_prefs_get_bool (GNC_PREFS_GROUP_GENERAL, GNC_PREF_SQL_BINARY_GUIDS))
+        convert_guid_format();
+    m_change_log = (m_conn->does_table_exist (CHANGES_TABLE_NAME) ||
+                    create_table (CHANGES_TABLE_NAME, CHANGES_TABLE_VERSION,
+                                  changes_table)) &&
+        (m_conn->does_table_exist (CHANGE_SESSIONS_TABLE_NAME) ||
+         create_table (CHANGE_SESSIONS_TABLE_NAME,
+                       CHANGE_SESSIONS_TABLE_VERSION, change_sessions_table));
+}
+
+/* Converts every table to the binary GncGUID layout. The object backends'
+ * upgrade_guid_columns() only build and check a converted copy of each table,
+ * so nothing has been changed if any of them fails. The copies then replace
+ * the originals, which are kept as <table>_hex until the new format version
+ * has been committed: MySQL commits DDL implicitly, so rolling back the
+ * transaction isn't enough to undo the renames there.
+ */
+void
+GncSqlBackend::convert_guid_format() noexcept
+{
+    if (get_table_version(GUID_FORMAT_NAME) >= GUID_FORMAT_BINARY)
+        return;
+
+    ENTER (" ");
+    if (!m_conn->begin_transaction())
+    {
+        LEAVE ("begin_transaction failed");
+        return;
+    }
+    m_binary_guids = true;
+    m_guid_tables.clear();
+    bool is_ok = true;
+    for (auto entry : m_backend_registry)
+    {
+        update_progress();
+        is_ok = std::get<1>(entry)->upgrade_guid_columns(this);
+        if (!is_ok)
+            break;
+    }
+    size_t swapped = 0;
+    for (; is_ok && swapped < m_guid_tables.size(); ++swapped)
+    {
+        auto& table = m_guid_tables[swapped].first;
+        is_ok = rename_table (table, table + "_hex");
+        if (is_ok && !rename_table (table + "_new", table))
+        {
+            (void)rename_table (table + "_hex", table);
+            is_ok = false;
+        }
+    }
+    /* The change log only matters to sessions that are open now, and they
+     * can't read the new layout anyway, so it's recreated empty.
+     */
+    if (is_ok && m_conn->does_table_exist (CHANGES_TABLE_NAME))
+        is_ok = drop_table (CHANGES_TABLE_NAME);
+    if (is_ok && m_conn->does_table_exist (CHANGE_SESSIONS_TABLE_NAME))
+        is_ok = drop_table (CHANGE_SESSIONS_TABLE_NAME);
+    if (is_ok)
+        is_ok = set_table_version (GUID_FORMAT_NAME, GUID_FORMAT_BINARY);
+    if (is_ok)
+        is_ok = m_conn->commit_transaction();
+    if (is_ok)
+    {
+        for (auto& table : m_guid_tables)
+        {
+            (void)drop_table (table.first + "_hex");
+            for (auto& index : table.second)
+                if (!create_index (index.first, table.first, index.second))
+                    PERR ("Unable to create index %s\n", index.first.c_str());
+        }
+    }
+    else
+    {
+        PWARN ("Conversion to binary GUIDs failed, keeping hex GUIDs.");
+        (void)m_conn->rollback_transaction();
+        /* Where the rollback didn't undo the DDL, put the tables back. */
+        for (size_t i = 0; i < m_guid_tables.size(); ++i)
+        {
+            auto& table = m_guid_tables[i].first;
+            if (i < swapped && m_conn->does_table_exist (table + "_hex"))
+            {
+                (void)drop_table (table);
+                (void)rename_table (table + "_hex", table);
+            }
+            else if (m_conn->does_table_exist (table + "_new"))
+                (void)drop_table (table + "_new");
+        }
+        for (auto& version : m_versions)
+            if (version.first == GUID_FORMAT_NAME)
+                version.second = GUID_FORMAT_TEXT;
+        m_binary_guids = false;
+    }
+    m_guid_tables.clear();
+    LEAVE ("is_ok=%d", is_ok);
 }
 
 /* Main object load order */
@@ -272,6 +448,8 @@ GncSqlBackend::load (QofBook* book, QofBackendLoadType loadType)
     {
         assert (m_book == nullptr);
         m_book = book;
+        /* Anything committed from here on may be missing from the load. */
+        begin_change_session();
 
         /* Load any initial stuff. Some of this needs to happen in a certain order */
         for (auto type : fixed_load_order)
@@ -443,6 +621,7 @@ GncSqlBackend::sync(QofBook* book)
     g_return_if_fail (book != NULL);
 
     reset_version_info();
+    m_known_rows.clear();
     ENTER ("book=%p, sql_be->book=%p", book, m_book);
     update_progress();
 
@@ -489,6 +668,9 @@ GncSqlBackend::sync(QofBook* book)
     if (is_ok)
     {
         m_is_pristine_db = false;
+        /* The tables, and with them any list of sessions, are new. */
+        m_change_session = false;
+        begin_change_session();
 
         /* Mark the session as clean -- though it shouldn't ever get
          * marked dirty with this backend
@@ -499,6 +681,7 @@ GncSqlBackend::sync(QofBook* book)
     {
         set_error (ERR_BACKEND_SERVER_ERR);
         is_ok = m_conn->rollback_transaction ();
+        m_known_rows.clear();
     }
     finish_progress();
     LEAVE ("book=%p", book);
@@ -596,11 +779,29 @@ GncSqlBackend::commit (QofInstance* inst)
         return;
     }
 
+    /* Hold the change log until this commit is done, so that another
+     * session can't pass the same check for the same object meanwhile. */
+    if (m_change_log && !lock_change_log ())
+    {
+        (void)m_conn->rollback_transaction ();
+        LEAVE ("Rolled back - change log lock error");
+        return;
+    }
+
+    if (!is_infant && changed_elsewhere (inst))
+    {
+        (void)m_conn->rollback_transaction ();
+        set_error (ERR_BACKEND_MODIFIED);
+        LEAVE ("Rolled back - modified by another session");
+        return;
+    }
+
     bool is_ok = true;
 
     auto obe = m_backend_registry.get_object_backend(std::string{inst->e_type});
     if (obe != nullptr)
-        is_ok = obe->commit(this, inst);
+        is_ok = obe->commit(this, inst) &&
+            (!shared_session () || record_change (inst));
     else
     {
         PERR ("Unknown object type '%s'\n", inst->e_type);
@@ -616,6 +817,8 @@ GncSqlBackend::commit (QofInstance* inst)
     {
         // Error - roll it back
         (void)m_conn->rollback_transaction();
+        // Forget the rows written inside the rolled back transaction
+        m_known_rows.clear();
 
         // This *should* leave things marked dirty
         LEAVE ("Rolled back - database error");
@@ -630,6 +833,318 @@ GncSqlBackend::commit (QofInstance* inst)
     LEAVE ("");
 }
 
+/* A split is reloaded with its transaction, so that is what gets logged. */
+static QofInstance*
+change_owner (QofInstance* inst)
+{
+    if (GNC_IS_SPLIT (inst))
+    {
+        auto trans = xaccSplitGetParent (GNC_SPLIT (inst));
+        if (trans != nullptr)
+            return QOF_INSTANCE (trans);
+    }
+    return inst;
+}
+
+int64_t
+GncSqlBackend::latest_change() const noexcept
+{
+    if (!m_change_log)
+        return 0;
+    std::string sql{"SELECT " CHANGE_ID_COL " FROM " CHANGES_TABLE_NAME
+            " ORDER BY " CHANGE_ID_COL " DESC LIMIT 1"};
+    auto stmt = create_statement_from_sql (sql);
+    auto result = execute_select_statement (stmt);
+    if (result == nullptr)
+        return 0;
+    int64_t latest = 0;
+    for (const auto& row : *result)
+        latest = row.get_int_at_col (CHANGE_ID_COL);
+    delete result;
+    return latest;
+}
+
+/* A failed query counts as a change, so that the commit is refused rather
+ * than possibly overwriting someone else's edit.
+ */
+bool
+GncSqlBackend::changed_elsewhere(QofInstance* inst) const noexcept
+{
+    if (!m_change_log)
+        return false;
+    std::stringstream sql;
+    sql << "SELECT " << CHANGE_ID_COL << " FROM " << CHANGES_TABLE_NAME <<
+        " WHERE " << CHANGE_GUID_COL << "=" <<
+        quote_guid (qof_instance_get_guid (change_owner (inst))) << " AND " <<
+        CHANGE_ID_COL << ">" << m_last_change << " AND " <<
+        CHANGE_SESSION_COL << "<>" << quote_guid (&m_session_guid) <<
+        " LIMIT 1";
+    auto stmt = create_statement_from_sql (sql.str());
+    auto result = execute_select_statement (stmt);
+    if (result == nullptr)
+        return true;
+    auto changed = result->size() > 0;
+    delete result;
+    return changed;
+}
+
+/* Writing to the changes table's row in the versions table takes a lock
+ * that the other sessions' commits and registrations wait for until this
+ * transaction ends: a row lock on MySQL and PostgreSQL, and the database
+ * write lock on SQLite. Whatever they read afterwards includes this
+ * transaction's work.
+ */
+bool
+GncSqlBackend::lock_change_log() const noexcept
+{
+    std::string sql{"UPDATE " VERSION_TABLE_NAME " SET " VERSION_COL_NAME "="
+            VERSION_COL_NAME " WHERE " TABLE_COL_NAME "='" CHANGES_TABLE_NAME
+            "'"};
+    auto stmt = create_statement_from_sql (sql);
+    return execute_nonselect_statement (stmt) != -1;
+}
+
+/* Whether another session has the database open. If that can't be found
+ * out, assume that one has. */
+bool
+GncSqlBackend::shared_session() const noexcept
+{
+    if (!m_change_log)
+        return false;
+    std::stringstream sql;
+    sql << "SELECT " << CHANGE_SESSION_COL << " FROM " <<
+        CHANGE_SESSIONS_TABLE_NAME << " WHERE " << CHANGE_SESSION_COL <<
+        "<>" << quote_guid (&m_session_guid) << " LIMIT 1";
+    auto stmt = create_statement_from_sql (sql.str());
+    auto result = execute_select_statement (stmt);
+    if (result == nullptr)
+        return true;
+    auto shared = result->size() > 0;
+    delete result;
+    return shared;
+}
+
+/* A row can go once every session other than the one that wrote it has
+ * applied it. Once no session is left, that's all of them.
+ */
+void
+GncSqlBackend::prune_change_log() const noexcept
+{
+    std::stringstream sql;
+    sql << "DELETE FROM " << CHANGES_TABLE_NAME << " WHERE NOT EXISTS " <<
+        "(SELECT " << CHANGE_SESSION_COL << " FROM " <<
+        CHANGE_SESSIONS_TABLE_NAME << " WHERE " << CHANGE_SESSIONS_TABLE_NAME <<
+        "." << CHANGE_LAST_ID_COL << "<" << CHANGES_TABLE_NAME << "." <<
+        CHANGE_ID_COL << " AND " << CHANGE_SESSIONS_TABLE_NAME << "." <<
+        CHANGE_SESSION_COL << "<>" << CHANGES_TABLE_NAME << "." <<
+        CHANGE_SESSION_COL << ")";
+    auto stmt = create_statement_from_sql (sql.str());
+    (void)execute_nonselect_statement (stmt);
+}
+
+bool
+GncSqlBackend::write_change_session() const noexcept
+{
+    std::stringstream sql;
+    sql << "INSERT INTO " << CHANGE_SESSIONS_TABLE_NAME << " VALUES (" <<
+        quote_guid (&m_session_guid) << "," << m_last_change << "," <<
+        m_session_seen << ")";
+    auto stmt = create_statement_from_sql (sql.str());
+    return execute_nonselect_statement (stmt) != -1;
+}
+
+/* Adds this session to the list, dropping sessions that have been gone
+ * long enough to be presumed dead, and sets the newest change that the
+ * load about to start will include.
+ */
+void
+GncSqlBackend::begin_change_session() noexcept
+{
+    if (!m_change_log || m_change_session)
+        return;
+    if (!m_conn->begin_transaction ())
+        return;
+    m_session_seen = gnc_time (nullptr);
+    std::stringstream sql;
+    sql << "DELETE FROM " << CHANGE_SESSIONS_TABLE_NAME << " WHERE " <<
+        CHANGE_LAST_SEEN_COL << "<" <<
+        m_session_seen - CHANGE_SESSION_TIMEOUT << " OR " <<
+        CHANGE_SESSION_COL << "=" << quote_guid (&m_session_guid);
+    auto stmt = create_statement_from_sql (sql.str());
+    auto is_ok = lock_change_log () &&
+        execute_nonselect_statement (stmt) != -1;
+    if (is_ok)
+    {
+        m_last_change = latest_change ();
+        is_ok = write_change_session ();
+    }
+    if (is_ok)
+        prune_change_log ();
+    if (is_ok && m_conn->commit_transaction ())
+        m_change_session = true;
+    else
+        (void)m_conn->rollback_transaction ();
+}
+
+void
+GncSqlBackend::end_change_session() noexcept
+{
+    if (!m_change_session)
+        return;
+    m_change_session = false;
+    if (!m_conn->begin_transaction ())
+        return;
+    std::stringstream sql;
+    sql << "DELETE FROM " << CHANGE_SESSIONS_TABLE_NAME << " WHERE " <<
+        CHANGE_SESSION_COL << "=" << quote_guid (&m_session_guid);
+    auto stmt = create_statement_from_sql (sql.str());
+    if (lock_change_log () && execute_nonselect_statement (stmt) != -1)
+    {
+        prune_change_log ();
+        (void)m_conn->commit_transaction ();
+    }
+    else
+        (void)m_conn->rollback_transaction ();
+}
+
+/* Records the newest change this session has applied and that it's still
+ * alive. If it was taken for dead meanwhile, other sessions' changes may
+ * have been pruned before it saw them.
+ */
+void
+GncSqlBackend::touch_change_session() noexcept
+{
+    if (!m_change_session)
+        return;
+    m_session_seen = gnc_time (nullptr);
+    std::stringstream sql;
+    sql << "UPDATE " << CHANGE_SESSIONS_TABLE_NAME << " SET " <<
+        CHANGE_LAST_ID_COL << "=" << m_last_change << "," <<
+        CHANGE_LAST_SEEN_COL << "=" << m_session_seen << " WHERE " <<
+        CHANGE_SESSION_COL << "=" << quote_guid (&m_session_guid);
+    auto stmt = create_statement_from_sql (sql.str());
+    auto updated = execute_nonselect_statement (stmt);
+    if (updated == 0)
+    {
+        PWARN ("This session was presumed dead; changes made by other "
+               "sessions may be missing until the book is reopened.");
+        (void)write_change_session ();
+    }
+    if (updated != -1)
+        prune_change_log ();
+}
+
+bool
+GncSqlBackend::record_change(QofInstance* inst) const noexcept
+{
+    if (!m_change_log)
+        return true;
+    auto owner = change_owner (inst);
+    std::stringstream sql;
+    sql << "INSERT INTO " << CHANGES_TABLE_NAME << " (" << CHANGE_SESSION_COL <<
+        ", " << CHANGE_TYPE_COL << ", " << CHANGE_GUID_COL << ") VALUES (" <<
+        quote_guid (&m_session_guid) << ", " << quote_string (owner->e_type) <<
+        ", " << quote_guid (qof_instance_get_guid (owner)) << ")";
+    auto stmt = create_statement_from_sql (sql.str());
+    return execute_nonselect_statement (stmt) != -1;
+}
+
+bool
+GncSqlBackend::events_pending()
+{
+    if (!m_change_log || m_book == nullptr || m_loading)
+        return false;
+    if (gnc_time (nullptr) - m_session_seen > CHANGE_SESSION_REFRESH)
+        touch_change_session();
+    std::stringstream sql;
+    sql << "SELECT " << CHANGE_ID_COL << " FROM " << CHANGES_TABLE_NAME <<
+        " WHERE " << CHANGE_ID_COL << ">" << m_last_change << " AND " <<
+        CHANGE_SESSION_COL << "<>" << quote_guid (&m_session_guid) <<
+        " LIMIT 1";
+    auto stmt = create_statement_from_sql (sql.str());
+    auto result = execute_select_statement (stmt);
+    if (result == nullptr)
+        return false;
+    auto pending = result->size() > 0;
+    delete result;
+    return pending;
+}
+
+/* Objects that are open for editing here are left alone, and so is every
+ * later change, so that they're picked up by the next poll once the edit is
+ * over; committing the edit in the meantime fails as a conflict.
+ */
+bool
+GncSqlBackend::process_events()
+{
+    if (!m_change_log || m_book == nullptr || m_loading)
+        return false;
+    ENTER (" ");
+    std::stringstream sql;
+    sql << "SELECT * FROM " << CHANGES_TABLE_NAME << " WHERE " <<
+        CHANGE_ID_COL << ">" << m_last_change << " ORDER BY " << CHANGE_ID_COL;
+    auto stmt = create_statement_from_sql (sql.str());
+    auto result = execute_select_statement (stmt);
+    if (result == nullptr)
+    {
+        LEAVE ("query failed");
+        return false;
+    }
+
+    using Change = std::pair<std::string, GncGUID>;
+    std::vector<Change> changes;
+    auto last_change = m_last_change;
+    for (const auto& row : *result)
+    {
+        try
+        {
+            auto session = row.get_guid_at_col (CHANGE_SESSION_COL);
+            auto type = row.get_string_at_col (CHANGE_TYPE_COL);
+            auto guid = row.get_guid_at_col (CHANGE_GUID_COL);
+            auto coll = qof_book_get_collection (m_book, type.c_str());
+            auto inst = QOF_INSTANCE (qof_collection_lookup_entity (coll, &guid));
+            if (inst != nullptr && qof_instance_get_editlevel (inst) > 0)
+                break;
+            last_change = row.get_int_at_col (CHANGE_ID_COL);
+            if (guid_equal (&session, &m_session_guid))
+                continue;
+            auto seen = std::find_if (changes.begin(), changes.end(),
+                                      [&type, &guid](const Change& c) {
+                                          return c.first == type &&
+                                              guid_equal (&c.second, &guid);
+                                      });
+            if (seen == changes.end())
+                changes.push_back (Change{type, guid});
+        }
+        catch (std::invalid_argument&)
+        {
+            continue;
+        }
+    }
+    delete result;
+
+    bool changed = false;
+    m_loading = true;
+    qof_event_suspend ();
+    for (const auto& change : changes)
+    {
+        auto obe = m_backend_registry.get_object_backend (change.first);
+        if (obe != nullptr && obe->reload_object (this, change.second))
+            changed = true;
+    }
+    qof_event_resume ();
+    m_loading = false;
+    if (last_change != m_last_change)
+    {
+        m_last_change = last_change;
+        touch_change_session();
+    }
+    /* Other sessions may also have deleted rows this one had seen. */
+    if (!changes.empty())
+        m_known_rows.clear();
+    LEAVE ("changed=%d", changed);
+    return changed;
+}
 
 /**
  * Sees if the version table exists, and if it does, loads the info into
@@ -653,15 +1168,28 @@ GncSqlBackend::init_version_info() noexcept
             unsigned int version = row.get_int_at_col (VERSION_COL_NAME);
             m_versions.push_back(std::make_pair(name, version));
         }
+        m_binary_guids =
+            get_table_version (GUID_FORMAT_NAME) >= GUID_FORMAT_BINARY;
     }
     else
     {
         create_table (VERSION_TABLE_NAME, version_table);
         set_table_version("Gnucash", gnc_prefs_get_long_version ());
         set_table_version("Gnucash-Resave", GNUCASH_RESAVE_VERSION);
+        init_guid_format();
     }
 }
 
+/* A new database gets the layout selected in the preferences. */
+void
+GncSqlBackend::init_guid_format() noexcept
+{
+    m_binary_guids = gnc_prefs_get_bool (GNC_PREFS_GROUP_GENERAL,
+                                         GNC_PREF_SQL_BINARY_GUIDS);
+    set_table_version (GUID_FORMAT_NAME, m_binary_guids ? GUID_FORMAT_BINARY :
+                       GUID_FORMAT_TEXT);
+}
+
 /**
  * Resets the version table information by removing all version table info.
  * It also recreates the version table in the db.
@@ -676,6 +1204,7 @@ GncSqlBackend::reset_version_info() noexcept
     m_versions.clear();
     set_table_version ("Gnucash", gnc_prefs_get_long_version ());
     set_table_version ("Gnucash-Resave", GNUCASH_RESAVE_VERSION);
+    init_guid_format();
     return ok;
 }
 
@@ -779,8 +1308,100 @@ GncSqlBackend::upgrade_table (const std::string& table_name,
     execute_nonselect_statement(stmt);
 }
 
+bool
+GncSqlBackend::upgrade_guid_columns (const std::string& table_name,
+                                     const EntryVec& col_table,
+                                     const IndexVec& indexes) noexcept
+{
+    g_return_val_if_fail (m_binary_guids, false);
+    DEBUG ("Converting GUIDs in %s table\n", table_name.c_str());
+
+    auto info_vec = make_col_vec (col_table);
+    if (!guid_columns_convertible (table_name, info_vec))
+        return false;
+    auto temp_table_name = table_name + "_new";
+    /* Left over from an earlier conversion that failed part way. */
+    if (m_conn->does_table_exist (temp_table_name) &&
+        !drop_table (temp_table_name))
+        return false;
+    if (!m_conn->create_table (temp_table_name, info_vec))
+        return false;
+
+    std::stringstream sql;
+    std::stringstream cols;
+    std::stringstream values;
+    for (auto const& info : info_vec)
+    {
+        if (&info != &info_vec.front())
+        {
+            cols << ",";
+            values << ",";
+        }
+        cols << info.m_name;
+        if (info.m_type == BCT_GUID)
+            values << m_conn->hex_to_binary_expr (info.m_name);
+        else
+            values << info.m_name;
+    }
+    sql << "INSERT INTO " << temp_table_name << "(" << cols.str() <<
+        ") SELECT " << values.str() << " FROM " << table_name;
+    auto stmt = create_statement_from_sql(sql.str());
+    if (execute_nonselect_statement(stmt) == -1)
+    {
+        (void)drop_table (temp_table_name);
+        return false;
+    }
+    m_guid_tables.emplace_back (table_name, indexes);
+    return true;
+}
+
+/* The hex-to-binary functions return NULL for a value that isn't valid hex
+ * rather than failing, and MySQL may then store a default in a NOT NULL
+ * column, so look for values that won't convert before copying the table.
+ */
+bool
+GncSqlBackend::guid_columns_convertible (const std::string& table_name,
+                                         const ColVec& info_vec) noexcept
+{
+    std::stringstream sql;
+    sql << "SELECT 1 AS bad FROM " << table_name << " WHERE 1=0";
+    for (auto const& info : info_vec)
+        if (info.m_type == BCT_GUID)
+            sql << " OR (" << info.m_name << " IS NOT NULL AND (LENGTH(" <<
+                info.m_name << ")<>" << GUID_ENCODING_LENGTH << " OR " <<
+                m_conn->hex_to_binary_expr (info.m_name) << " IS NULL))";
+    sql << " LIMIT 1";
+    auto stmt = create_statement_from_sql (sql.str());
+    auto result = execute_select_statement (stmt);
+    if (result == nullptr)
+        return false;
+    auto convertible = result->size() == 0;
+    delete result;
+    if (!convertible)
+        PWARN ("Table %s has GUIDs that can't be converted.",
+               table_name.c_str());
+    return convertible;
+}
+
+bool
+GncSqlBackend::rename_table (const std::string& from,
+                             const std::string& to) noexcept
+{
+    std::string sql{"ALTER TABLE " + from + " RENAME TO " + to};
+    auto stmt = create_statement_from_sql (sql);
+    return execute_nonselect_statement (stmt) != -1;
+}
+
+bool
+GncSqlBackend::drop_table (const std::string& table_name) noexcept
+{
+    std::string sql{"DROP TABLE " + table_name};
+    auto stmt = create_statement_from_sql (sql);
+    return execute_nonselect_statement (stmt) != -1;
+}
+
 static inline PairVec
-get_object_values (QofIdTypeConst obj_name,
+get_object_values (const GncSqlBackend* sql_be, QofIdTypeConst obj_name,
                    gpointer pObject, const EntryVec& table)
 {
     PairVec vec;
@@ -789,7 +1410,7 @@ get_object_values (QofIdTypeConst obj_name,
     {
         if (!(table_row->is_autoincr()))
         {
-            table_row->add_to_query (obj_name, pObject, vec);
+            table_row->add_to_query (sql_be, obj_name, pObject, vec);
         }
     }
     return vec;
@@ -804,18 +1425,38 @@ GncSqlBackend::object_in_db (const char* table_name, QofIdTypeConst obj_name,
     g_return_val_if_fail (obj_name != nullptr, false);
     g_return_val_if_fail (pObject != nullptr, false);
 
+    /* Committing a transaction checks its currency every time, so rows that
+     * are already known to exist aren't looked up again.
+     */
+    auto& known = m_known_rows[table_name];
+    auto key = primary_key (obj_name, pObject, table);
+    if (known.count (key))
+        return true;
+
     /* SELECT * FROM */
     auto sql = std::string{"SELECT "} + table[0]->name() + " FROM " + table_name;
     auto stmt = create_statement_from_sql(sql.c_str());
     assert (stmt != nullptr);
 
     /* WHERE */
-    PairVec values{get_object_values(obj_name, pObject, table)};
-    /* We want only the first item in the table, which should be the PK. */
-    values.resize(1);
+    PairVec values{std::make_pair (std::string{table[0]->name()}, key)};
     stmt->add_where_cond(obj_name, values);
     auto result = execute_select_statement (stmt);
-    return (result != nullptr && result->size() > 0);
+    auto in_db = (result != nullptr && result->size() > 0);
+    delete result;
+    if (in_db)
+        known.insert (key);
+    return in_db;
+}
+
+std::string
+GncSqlBackend::primary_key (QofIdTypeConst obj_name, gpointer pObject,
+                            const EntryVec& table) const noexcept
+{
+    /* The first column in the table is the PK. */
+    PairVec values;
+    table[0]->add_to_query (this, obj_name, pObject, values);
+    return values.empty() ? std::string{} : values[0].second;
 }
 
 bool
@@ -843,7 +1484,19 @@ GncSqlBackend::do_db_operation (E_DB_OPERATION op, const char* table_name,
     }
     if (stmt == nullptr)
         return false;
-    return (execute_nonselect_statement(stmt) != -1);
+    if (execute_nonselect_statement(stmt) == -1)
+        return false;
+
+    auto known = m_known_rows.find (table_name);
+    if (known != m_known_rows.end())
+    {
+        auto key = primary_key (obj_name, pObject, table);
+        if (op == OP_DB_DELETE)
+            known->second.erase (key);
+        else
+            known->second.insert (key);
+    }
+    return true;
 }
 
 bool
@@ -870,7 +1523,7 @@ GncSqlBackend::build_insert_statement (const char* table_name,
     g_return_val_if_fail (table_name != nullptr, nullptr);
     g_return_val_if_fail (obj_name != nullptr, nullptr);
     g_return_val_if_fail (pObject != nullptr, nullptr);
-    PairVec values{get_object_values(obj_name, pObject, table)};
+    PairVec values{get_object_values(this, obj_name, pObject, table)};
 
     sql << "INSERT INTO " << table_name <<"(";
     for (auto const& col_value : values)
@@ -906,7 +1559,7 @@ GncSqlBackend::build_update_statement(const gchar* table_name,
     g_return_val_if_fail (pObject != nullptr, nullptr);
 
 
-    PairVec values{get_object_values (obj_name, pObject, table)};
+    PairVec values{get_object_values (this, obj_name, pObject, table)};
 
     // Create the SQL statement
     sql <<  "UPDATE " << table_name << " SET ";
@@ -945,7 +1598,7 @@ GncSqlBackend::build_delete_statement(const gchar* table_name,
 
     /* WHERE */
     PairVec values;
-    table[0]->add_to_query (obj_name, pObject, values);
+    table[0]->add_to_query (this, obj_name, pObject, values);
     PairVec col_values{values[0]};
     stmt->add_where_cond (obj_name, col_values);
 
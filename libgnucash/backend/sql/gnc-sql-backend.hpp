@@ -32,6 +32,8 @@ extern "C"
 #include <memory>
 #include <exception>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <qof-backend.hpp>
 
@@ -49,6 +51,13 @@ class GncSqlResult;
 using GncSqlResultPtr = GncSqlResult*;
 using VersionPair = std::pair<const std::string, unsigned int>;
 using VersionVec = std::vector<VersionPair>;
+/** Primary key literals of the rows known to be in each table. */
+using KeyCache = std::unordered_map<std::string, std::unordered_set<std::string>>;
+struct GncSqlColumnInfo;
+using ColVec = std::vector<GncSqlColumnInfo>;
+/** Index name and indexed columns. */
+using IndexPair = std::pair<std::string, EntryVec>;
+using IndexVec = std::vector<IndexPair>;
 using uint_t = unsigned int;
 
 typedef enum
@@ -97,6 +106,18 @@ public:
      * @param inst Object being edited
      */
     void rollback(QofInstance*) override;
+    /**
+     * Check whether another session has committed changes since this one last
+     * read the database.
+     */
+    bool events_pending() override;
+    /**
+     * Reload the objects that other sessions have changed since this one last
+     * read the database.
+     *
+     * @return true if the engine was changed.
+     */
+    bool process_events() override;
     /** Connect the backend to a GncSqlConnection.
      * Sets up version info. Calling with nullptr clears the connection and
      * destroys the version info.
@@ -111,6 +132,10 @@ public:
      * Finalizes DB table version information.
      */
     void finalize_version_info() noexcept;
+    /**
+     * Removes this session from the sessions sharing the change log.
+     */
+    void end_change_session() noexcept;
     /* FIXME: These are just pass-throughs of m_conn functions. */
     GncSqlStatementPtr create_statement_from_sql(const std::string& str) const noexcept;
     /** Executes an SQL SELECT statement and returns the result rows.  If an
@@ -121,6 +146,17 @@ public:
      * @return Results, or nullptr if an error has occurred
      */
     GncSqlResultPtr execute_select_statement(const GncSqlStatementPtr& stmt) const noexcept;
+    /** Executes an SQL SELECT statement whose result may be too large to hold
+     * in memory at once; where the database has cursors the rows are fetched
+     * batch_size at a time. The result can be iterated only once and must be
+     * deleted after use. A failure to fetch a batch sets a backend error.
+     *
+     * @param statement Statement
+     * @param batch_size Number of rows fetched from the database at once
+     * @return Results, or nullptr if an error has occurred
+     */
+    GncSqlResultPtr execute_streaming_select_statement(const GncSqlStatementPtr& stmt,
+                                                       size_t batch_size = 10000) const noexcept;
     int execute_nonselect_statement(const GncSqlStatementPtr& stmt) const noexcept;
     std::string quote_string(const std::string&) const noexcept;
     /**
@@ -179,6 +215,23 @@ public:
      */
     void upgrade_table (const std::string& table_name,
                         const EntryVec& col_table) noexcept;
+    /**
+     * Converts the GncGUID columns of a table from the 32-character hex
+     * layout to the 16-byte binary layout.
+     *
+     * Checks that every GncGUID in the table can be converted, then copies
+     * the table into table_name_new, converting the GncGUID columns while
+     * they're copied. The original table is left alone; the copies replace
+     * the originals only once every table has been copied.
+     *
+     * @param table_name SQL table name
+     * @param col_table Column table
+     * @param indexes Indexes to create on the converted table
+     * @return true if the copy was made and checked, false otherwise.
+     */
+    bool upgrade_guid_columns (const std::string& table_name,
+                               const EntryVec& col_table,
+                               const IndexVec& indexes = {}) noexcept;
     /**
      * Returns the version number for a DB table.
      *
@@ -187,6 +240,19 @@ public:
      */
     uint_t get_table_version(const std::string& table_name) const noexcept;
     bool set_table_version (const std::string& table_name, uint_t version) noexcept;
+    /**
+     * Quote a GncGUID for use in an SQL statement, either as a quoted
+     * 32-character hex string or as a binary literal depending on the layout
+     * used by the database.
+     *
+     * @param guid The GncGUID to quote
+     * @return The SQL literal, or "NULL" if guid is nullptr.
+     */
+    std::string quote_guid (const GncGUID* guid) const noexcept;
+    /**
+     * Report whether the database stores GncGUIDs as 16-byte binary values.
+     */
+    bool binary_guids() const noexcept { return m_binary_guids; }
     /**
      * Register a commodity to be committed after loading is complete.
      *
@@ -246,9 +312,39 @@ protected:
     bool m_loading;        /**< We are performing an initial load */
     bool m_in_query;       /**< We are processing a query */
     bool m_is_pristine_db; /**< Are we saving to a new pristine db? */
+    bool m_binary_guids;   /**< GncGUID columns are 16-byte binary */
+    bool m_change_log;     /**< The database has a changes table */
+    bool m_change_session; /**< This session is listed as sharing it */
+    GncGUID m_session_guid; /**< Identifies our rows in the changes table */
+    int64_t m_last_change; /**< Newest changes row applied to the engine */
+    time64 m_session_seen; /**< When this session's listing was refreshed */
     const char* m_timespec_format; /**< Server-specific date-time string format */
     VersionVec m_versions;    /**< Version number for each table */
+    /** Rows object_in_db() has found or this session has since written. Only
+     * tables that object_in_db() has been asked about are tracked. */
+    mutable KeyCache m_known_rows;
 private:
+    /** Tables upgrade_guid_columns() has made converted copies of, with the
+     * indexes to create once the copies have replaced them. */
+    std::vector<std::pair<std::string, IndexVec>> m_guid_tables;
+    void init_guid_format() noexcept;
+    int64_t latest_change() const noexcept;
+    bool changed_elsewhere(QofInstance* inst) const noexcept;
+    bool record_change(QofInstance* inst) const noexcept;
+    bool lock_change_log() const noexcept;
+    bool shared_session() const noexcept;
+    void prune_change_log() const noexcept;
+    bool write_change_session() const noexcept;
+    void begin_change_session() noexcept;
+    void touch_change_session() noexcept;
+    void convert_guid_format() noexcept;
+    bool rename_table(const std::string& from, const std::string& to) noexcept;
+    bool drop_table(const std::string& table_name) noexcept;
+    bool guid_columns_convertible(const std::string& table_name,
+                                  const ColVec& info_vec) noexcept;
+    ColVec make_col_vec(const EntryVec& col_table) const noexcept;
+    std::string primary_key(QofIdTypeConst obj_name, gpointer pObject,
+                            const EntryVec& table) const noexcept;
     bool write_account_tree(Account*);
     bool write_accounts();
     bool write_transactions();
@@ -95,7 +95,8 @@ GncSqlColumnTableEntry::get_setter(QofIdTypeConst obj_name) const noexcept
 }
 
 void
-GncSqlColumnTableEntry::add_objectref_guid_to_query (QofIdTypeConst obj_name,
+GncSqlColumnTableEntry::add_objectref_guid_to_query (const GncSqlBackend* sql_be,
+                                                     QofIdTypeConst obj_name,
                                                      const void* pObject,
                                                      PairVec& vec) const noexcept
 {
@@ -104,13 +105,13 @@ GncSqlColumnTableEntry::add_objectref_guid_to_query (QofIdTypeConst obj_name,
     auto guid = qof_instance_get_guid (inst);
     if (guid != nullptr)
         vec.emplace_back (std::make_pair (std::string{m_col_name},
-                                          quote_string(guid_to_string(guid))));
+                                          sql_be->quote_guid(guid)));
 }
 
 void
 GncSqlColumnTableEntry::add_objectref_guid_to_table (ColVec& vec) const noexcept
 {
-    GncSqlColumnInfo info{*this, BCT_STRING, GUID_ENCODING_LENGTH, FALSE};
+    GncSqlColumnInfo info{*this, BCT_GUID, GUID_ENCODING_LENGTH, FALSE};
     vec.emplace_back(std::move(info));
 }
 
@@ -144,7 +145,8 @@ GncSqlColumnTableEntryImpl<CT_STRING>::add_to_table(ColVec& vec) const noexcept
  * it to operator<<().
  */
 template<> void
-GncSqlColumnTableEntryImpl<CT_STRING>::add_to_query(QofIdTypeConst obj_name,
+GncSqlColumnTableEntryImpl<CT_STRING>::add_to_query(const GncSqlBackend* sql_be,
+                                                    QofIdTypeConst obj_name,
                                                     const gpointer pObject,
                                                     PairVec& vec) const noexcept
 {
@@ -187,7 +189,8 @@ GncSqlColumnTableEntryImpl<CT_INT>::add_to_table(ColVec& vec) const noexcept
 }
 
 template<> void
-GncSqlColumnTableEntryImpl<CT_INT>::add_to_query(QofIdTypeConst obj_name,
+GncSqlColumnTableEntryImpl<CT_INT>::add_to_query(const GncSqlBackend* sql_be,
+                                                 QofIdTypeConst obj_name,
                                                  const gpointer pObject,
                                                  PairVec& vec) const noexcept
 {
@@ -222,7 +225,8 @@ GncSqlColumnTableEntryImpl<CT_BOOLEAN>::add_to_table(ColVec& vec) const noexcept
 }
 
 template<> void
-GncSqlColumnTableEntryImpl<CT_BOOLEAN>::add_to_query(QofIdTypeConst obj_name,
+GncSqlColumnTableEntryImpl<CT_BOOLEAN>::add_to_query(const GncSqlBackend* sql_be,
+                                                    QofIdTypeConst obj_name,
                                                     const gpointer pObject,
                                                     PairVec& vec) const noexcept
 {
@@ -257,7 +261,8 @@ GncSqlColumnTableEntryImpl<CT_INT64>::add_to_table(ColVec& vec) const noexcept
 }
 
 template<> void
-GncSqlColumnTableEntryImpl<CT_INT64>::add_to_query(QofIdTypeConst obj_name,
+GncSqlColumnTableEntryImpl<CT_INT64>::add_to_query(const GncSqlBackend* sql_be,
+                                                   QofIdTypeConst obj_name,
                                                    const gpointer pObject,
                                                    PairVec& vec) const noexcept
 {
@@ -308,7 +313,8 @@ GncSqlColumnTableEntryImpl<CT_DOUBLE>::add_to_table(ColVec& vec) const noexcept
 }
 
 template<> void
-GncSqlColumnTableEntryImpl<CT_DOUBLE>::add_to_query(QofIdTypeConst obj_name,
+GncSqlColumnTableEntryImpl<CT_DOUBLE>::add_to_query(const GncSqlBackend* sql_be,
+                                                    QofIdTypeConst obj_name,
                                                     const gpointer pObject,
                                                     PairVec& vec) const noexcept
 {
@@ -326,33 +332,31 @@ GncSqlColumnTableEntryImpl<CT_GUID>::load (const GncSqlBackend* sql_be,
 {
 
     GncGUID guid;
-    const GncGUID* pGuid;
 
     g_return_if_fail (pObject != NULL);
     g_return_if_fail (m_gobj_param_name != nullptr || get_setter(obj_name) != nullptr);
 
-    std::string str;
     try
     {
-        str = row.get_string_at_col(m_col_name);
+        guid = row.get_guid_at_col(m_col_name);
     }
     catch (std::invalid_argument)
     {
         return;
     }
-    if (string_to_guid (str.c_str(), &guid))
-        set_parameter(pObject, &guid, get_setter(obj_name), m_gobj_param_name);
+    set_parameter(pObject, &guid, get_setter(obj_name), m_gobj_param_name);
 }
 
 template<> void
 GncSqlColumnTableEntryImpl<CT_GUID>::add_to_table(ColVec& vec) const noexcept
 {
-    GncSqlColumnInfo info{*this, BCT_STRING, GUID_ENCODING_LENGTH, FALSE};
+    GncSqlColumnInfo info{*this, BCT_GUID, GUID_ENCODING_LENGTH, FALSE};
     vec.emplace_back(std::move(info));
 }
 
 template<> void
-GncSqlColumnTableEntryImpl<CT_GUID>::add_to_query(QofIdTypeConst obj_name,
+GncSqlColumnTableEntryImpl<CT_GUID>::add_to_query(const GncSqlBackend* sql_be,
+                                                  QofIdTypeConst obj_name,
                                                   const gpointer pObject,
                                                   PairVec& vec) const noexcept
 {
@@ -362,7 +366,7 @@ GncSqlColumnTableEntryImpl<CT_GUID>::add_to_query(QofIdTypeConst obj_name,
     {
 
         vec.emplace_back (std::make_pair (std::string{m_col_name},
-                                          quote_string(guid_to_string(s))));
+                                          sql_be->quote_guid(s)));
         return;
     }
 }
@@ -417,7 +421,8 @@ GncSqlColumnTableEntryImpl<CT_TIMESPEC>::add_to_table(ColVec& vec) const noexcep
 }
 
 template<> void
-GncSqlColumnTableEntryImpl<CT_TIMESPEC>::add_to_query(QofIdTypeConst obj_name,
+GncSqlColumnTableEntryImpl<CT_TIMESPEC>::add_to_query(const GncSqlBackend* sql_be,
+                                                      QofIdTypeConst obj_name,
                                                       const gpointer pObject,
                                                       PairVec& vec) const noexcept
 {
@@ -498,7 +503,8 @@ GncSqlColumnTableEntryImpl<CT_TIME64>::add_to_table(ColVec& vec) const noexcept
 }
 
 template<> void
-GncSqlColumnTableEntryImpl<CT_TIME64>::add_to_query(QofIdTypeConst obj_name,
+GncSqlColumnTableEntryImpl<CT_TIME64>::add_to_query(const GncSqlBackend* sql_be,
+                                                   QofIdTypeConst obj_name,
                                                    const gpointer pObject,
                                                    PairVec& vec) const noexcept
 {
@@ -573,7 +579,8 @@ GncSqlColumnTableEntryImpl<CT_GDATE>::add_to_table(ColVec& vec) const noexcept
 }
 
 template<> void
-GncSqlColumnTableEntryImpl<CT_GDATE>::add_to_query(QofIdTypeConst obj_name,
+GncSqlColumnTableEntryImpl<CT_GDATE>::add_to_query(const GncSqlBackend* sql_be,
+                                                   QofIdTypeConst obj_name,
                                                    const gpointer pObject,
                                                    PairVec& vec) const noexcept
 {
@@ -647,7 +654,8 @@ GncSqlColumnTableEntryImpl<CT_NUMERIC>::add_to_table(ColVec& vec) const noexcept
 }
 
 template<> void
-GncSqlColumnTableEntryImpl<CT_NUMERIC>::add_to_query(QofIdTypeConst obj_name,
+GncSqlColumnTableEntryImpl<CT_NUMERIC>::add_to_query(const GncSqlBackend* sql_be,
+                                                     QofIdTypeConst obj_name,
                                                      const gpointer pObject,
                                                      PairVec& vec) const noexcept
 {
@@ -736,20 +744,17 @@ gnc_sql_load_object (const GncSqlBackend* sql_be, GncSqlRow& row,
 }
 
 uint_t
-gnc_sql_append_guids_to_sql (std::stringstream& sql,
+gnc_sql_append_guids_to_sql (const GncSqlBackend* sql_be,
+                             std::stringstream& sql,
                              const InstanceVec& instances)
 {
-    char guid_buf[GUID_ENCODING_LENGTH + 1];
-
     for (auto inst : instances)
     {
-        (void)guid_to_string_buff (qof_instance_get_guid (inst), guid_buf);
-
         if (inst != *(instances.begin()))
         {
             sql << ",";
         }
-        sql << "'" << guid_buf << "'";
+        sql << sql_be->quote_guid (qof_instance_get_guid (inst));
     }
 
     return instances.size();
@@ -50,7 +50,8 @@ typedef enum
     BCT_INT64,
     BCT_DATE,
     BCT_DOUBLE,
-    BCT_DATETIME
+    BCT_DATETIME,
+    BCT_GUID        /**< A GncGUID: 32-char hex string or 16-byte binary */
 } GncSqlBasicColumnType;
 
 enum ColumnFlags : int
@@ -152,9 +153,11 @@ public:
     /**
      * Add a pair of the table column heading and object's value's string
      * representation to a PairVec; used for constructing WHERE clauses and
-     * UPDATE statements.
+     * UPDATE statements. The backend supplies the quoting for columns whose
+     * representation depends on the database schema, e.g. GncGUIDs.
      */
-    virtual void add_to_query(QofIdTypeConst obj_name,
+    virtual void add_to_query(const GncSqlBackend* sql_be,
+                              QofIdTypeConst obj_name,
                               void* pObject, PairVec& vec) const noexcept = 0;
     /**
      * Retrieve the getter function depending on whether it's an auto-increment
@@ -189,15 +192,11 @@ public:
 
             try
             {
-                GncGUID guid;
-                auto val = row.get_string_at_col (m_col_name);
-                if (string_to_guid (val.c_str(), &guid))
-                {
-                    auto target = get_ref(&guid);
-                    if (target != nullptr)
-                        set_parameter (pObject, target, get_setter(obj_name),
-                                       m_gobj_param_name);
-                }
+                GncGUID guid = row.get_guid_at_col (m_col_name);
+                auto target = get_ref(&guid);
+                if (target != nullptr)
+                    set_parameter (pObject, target, get_setter(obj_name),
+                                   m_gobj_param_name);
             }
             catch (std::invalid_argument) {}
         }
@@ -217,7 +216,8 @@ protected:
  * @param pObject Object
  * @param pList List
  */
-    void add_objectref_guid_to_query (QofIdTypeConst obj_name,
+    void add_objectref_guid_to_query (const GncSqlBackend* sql_be,
+                                      QofIdTypeConst obj_name,
                                       const void* pObject,
                                       PairVec& vec) const noexcept;
 /**
@@ -266,8 +266,8 @@ public:
     void load(const GncSqlBackend* sql_be, GncSqlRow& row,  QofIdTypeConst obj_name,
               void* pObject) const noexcept override;
     void add_to_table(ColVec& vec) const noexcept override;
-    void add_to_query(QofIdTypeConst obj_name, void* pObject, PairVec& vec)
-        const noexcept override;
+    void add_to_query(const GncSqlBackend* sql_be, QofIdTypeConst obj_name,
+                      void* pObject, PairVec& vec) const noexcept override;
 };
 
 using GncSqlColumnTableEntryPtr = std::shared_ptr<GncSqlColumnTableEntry>;
@@ -421,11 +421,13 @@ gnc_sql_load_guid (const GncSqlBackend* sql_be, GncSqlRow& row);
 /**
  * Append the GUIDs of QofInstances to a SQL query.
  *
+ * @param sql_be: The active GncSqlBackend, which knows how GUIDs are stored.
  * @param sql: The SQL Query in progress to which the GncGUIDS should be appended.
  * @param instances: The QofInstances
  * @return The number of instances
  */
-uint_t gnc_sql_append_guids_to_sql (std::stringstream& sql,
+uint_t gnc_sql_append_guids_to_sql (const GncSqlBackend* sql_be,
+                                    std::stringstream& sql,
                                     const InstanceVec& instances);
 
 /**
@@ -65,6 +65,14 @@ public:
     virtual ~GncSqlConnection() = default;
     virtual GncSqlResultPtr execute_select_statement (const GncSqlStatementPtr&)
         noexcept = 0;
+    /** Like execute_select_statement, but holds at most batch_size rows in
+     * memory at a time if the database has cursors. The result can be
+     * iterated only once and must be deleted when done, as it may hold a
+     * transaction open until then.
+     */
+    virtual GncSqlResultPtr execute_streaming_select_statement (const GncSqlStatementPtr&,
+                                                                size_t batch_size)
+        noexcept = 0;
     /** Returns false if error */
     virtual int execute_nonselect_statement (const GncSqlStatementPtr&)
         noexcept = 0;
@@ -89,6 +97,12 @@ public:
         const noexcept = 0;
     virtual std::string quote_string (const std::string&)
         const noexcept = 0;
+    /** Returns a binary literal for the bytes encoded in a hex string. */
+    virtual std::string quote_binary (const std::string&)
+        const noexcept = 0;
+    /** Returns an expression converting a hex string column to binary. */
+    virtual std::string hex_to_binary_expr (const std::string&)
+        const noexcept = 0;
     /** Get the connection error value.
      * If not 0 will normally be meaningless outside of implementation code.
      */
@@ -25,6 +25,7 @@ extern "C"
 {
 #include <config.h>
 }
+#include <sstream>
 #include "gnc-sql-object-backend.hpp"
 #include "gnc-sql-backend.hpp"
 #include "gnc-sql-column-table-entry.hpp"
@@ -88,6 +89,59 @@ GncSqlObjectBackend::create_tables (GncSqlBackend* sql_be)
              "Table creation aborted.", m_table_name.c_str(), m_version, version);
 }
 
+bool
+GncSqlObjectBackend::upgrade_guid_columns (GncSqlBackend* sql_be)
+{
+    g_return_val_if_fail (sql_be != nullptr, false);
+    if (sql_be->get_table_version (m_table_name) == 0)
+        return true;
+    return sql_be->upgrade_guid_columns (m_table_name, m_col_table);
+}
+
+bool
+GncSqlObjectBackend::reload_object (GncSqlBackend* sql_be, const GncGUID& guid)
+{
+    g_return_val_if_fail (sql_be != nullptr, false);
+
+    auto coll = qof_book_get_collection (sql_be->book(), m_type_name.c_str());
+    auto inst = QOF_INSTANCE (qof_collection_lookup_entity (coll, &guid));
+    std::stringstream sql;
+    sql << "SELECT * FROM " << m_table_name << " WHERE " <<
+        m_col_table[0]->name() << "=" << sql_be->quote_guid (&guid);
+    auto stmt = sql_be->create_statement_from_sql (sql.str());
+    if (stmt == nullptr)
+        return false;
+    auto result = sql_be->execute_select_statement (stmt);
+    auto& row = result->begin();
+    if (row == result->end())
+    {
+        delete result;
+        if (inst != nullptr)
+            PWARN ("A %s was deleted by another session; it stays in this one "
+                   "until the book is reopened.", m_type_name.c_str());
+        return false;
+    }
+
+    if (inst == nullptr)
+    {
+        inst = QOF_INSTANCE (qof_object_new_instance (m_type_name.c_str(),
+                                                      sql_be->book()));
+        if (inst == nullptr)
+        {
+            delete result;
+            return false;
+        }
+    }
+    qof_begin_edit (inst);
+    gnc_sql_load_object (sql_be, row, m_type_name.c_str(), inst, m_col_table);
+    delete result;
+    gnc_sql_slots_load (sql_be, inst);
+    if (qof_commit_edit (inst))
+        qof_commit_edit_part2 (inst, nullptr, nullptr, nullptr);
+    qof_event_gen (inst, QOF_EVENT_MODIFY, nullptr);
+    return true;
+}
+
 bool
 GncSqlObjectBackend::instance_in_db(const GncSqlBackend* sql_be,
                                     QofInstance* inst) const noexcept
@@ -70,6 +70,14 @@ public:
      * @param sql_be The GncSqlBackend containing the database connection.
      */
     virtual void create_tables (GncSqlBackend* sql_be);
+    /**
+     * Make copies of the object's tables with the GncGUID columns converted
+     * from the 32-character hex layout to the 16-byte binary layout, naming
+     * the indexes to recreate once the copies replace the tables.
+     * @param sql_be The GncSqlBackend containing the database connection.
+     * @return true if all tables were copied, false otherwise.
+     */
+    virtual bool upgrade_guid_columns (GncSqlBackend* sql_be);
     /**
      * UPDATE/INSERT a single instance of m_type_name into the database.
      * @param sql_be The GncSqlBackend containing the database.
@@ -82,6 +90,15 @@ public:
      * @return true if the objects were successfully written, false otherwise.
      */
     virtual bool write (GncSqlBackend* sql_be) { return true; }
+    /**
+     * Re-read a single object of m_type_name after another session changed
+     * it, creating it if it isn't in the engine yet. The default can't remove
+     * an object that another session deleted; types that can override it.
+     * @param sql_be The GncSqlBackend containing the database.
+     * @param guid The GncGUID of the changed object.
+     * @return true if the engine was changed, false otherwise.
+     */
+    virtual bool reload_object (GncSqlBackend* sql_be, const GncGUID& guid);
     /**
      * Return the m_type_name for the class. This value is created at
      * compilation time and is called QofIdType or QofIdTypeConst in other parts
@@ -41,6 +41,8 @@ class GncSqlResult
 {
 public:
     virtual ~GncSqlResult() = default;
+    /** The number of rows in the result; for a streaming result only the
+     * number in the batch currently held. */
     virtual uint64_t size() const noexcept = 0;
     virtual GncSqlRow& begin() = 0;
     virtual GncSqlRow& end() = 0;
@@ -56,6 +58,8 @@ protected:
         virtual double get_double_at_col (const char* col) const = 0;
         virtual std::string get_string_at_col (const char* col) const = 0;
         virtual time64 get_time64_at_col (const char* col) const = 0;
+        /* Reads either the 32-character hex or the 16-byte binary layout. */
+        virtual GncGUID get_guid_at_col (const char* col) const = 0;
         virtual bool is_col_null (const char* col) const noexcept = 0;
     };
 };
@@ -96,6 +100,8 @@ public:
         return m_iter->get_string_at_col (col); }
     time64 get_time64_at_col (const char* col) const {
         return m_iter->get_time64_at_col (col); }
+    GncGUID get_guid_at_col (const char* col) const {
+        return m_iter->get_guid_at_col (col); }
     bool is_col_null (const char* col) const noexcept {
         return m_iter->is_col_null (col); }
 private:
@@ -224,19 +224,14 @@ load_single_ttentry (GncSqlBackend* sql_be, GncSqlRow& row, GncTaxTable* tt)
 static void
 load_taxtable_entries (GncSqlBackend* sql_be, GncTaxTable* tt)
 {
-    gchar guid_buf[GUID_ENCODING_LENGTH + 1];
-    GValue value;
     gchar* buf;
 
     g_return_if_fail (sql_be != NULL);
     g_return_if_fail (tt != NULL);
 
-    guid_to_string_buff (qof_instance_get_guid (QOF_INSTANCE (tt)), guid_buf);
-    memset (&value, 0, sizeof (GValue));
-    g_value_init (&value, G_TYPE_STRING);
-    g_value_set_string (&value, guid_buf);
-    buf = g_strdup_printf ("SELECT * FROM %s WHERE taxtable='%s'",
-                           TTENTRIES_TABLE_NAME, guid_buf);
+    auto guid_str = sql_be->quote_guid (qof_instance_get_guid (QOF_INSTANCE (tt)));
+    buf = g_strdup_printf ("SELECT * FROM %s WHERE taxtable=%s",
+                           TTENTRIES_TABLE_NAME, guid_str.c_str());
     auto stmt = sql_be->create_statement_from_sql (buf);
     g_free (buf);
     auto result = sql_be->execute_select_statement(stmt);
@@ -370,6 +365,16 @@ GncSqlTaxTableBackend::create_tables (GncSqlBackend* sql_be)
     }
 }
 
+bool
+GncSqlTaxTableBackend::upgrade_guid_columns (GncSqlBackend* sql_be)
+{
+    g_return_val_if_fail (sql_be != NULL, false);
+
+    return sql_be->upgrade_guid_columns (TT_TABLE_NAME, tt_col_table) &&
+        sql_be->upgrade_guid_columns (TTENTRIES_TABLE_NAME,
+                                      ttentries_col_table);
+}
+
 /* ================================================================= */
 static gboolean
 delete_all_tt_entries (GncSqlBackend* sql_be, const GncGUID* guid)
@@ -507,11 +512,12 @@ GncSqlColumnTableEntryImpl<CT_TAXTABLEREF>::add_to_table(ColVec& vec) const noex
 }
 
 template<> void
-GncSqlColumnTableEntryImpl<CT_TAXTABLEREF>::add_to_query(QofIdTypeConst obj_name,
+GncSqlColumnTableEntryImpl<CT_TAXTABLEREF>::add_to_query(const GncSqlBackend* sql_be,
+                                                         QofIdTypeConst obj_name,
                                                          const gpointer pObject,
                                                          PairVec& vec) const noexcept
 {
-    add_objectref_guid_to_query(obj_name, pObject, vec);
+    add_objectref_guid_to_query(sql_be, obj_name, pObject, vec);
 }
 
 /* ========================== END OF FILE ===================== */
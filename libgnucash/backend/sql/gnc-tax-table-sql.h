@@ -38,6 +38,7 @@ public:
     GncSqlTaxTableBackend();
     void load_all(GncSqlBackend*) override;
     void create_tables(GncSqlBackend*) override;
+    bool upgrade_guid_columns(GncSqlBackend*) override;
     bool commit (GncSqlBackend* sql_be, QofInstance* inst) override;
     bool write(GncSqlBackend*) override;
 };
@@ -258,12 +258,18 @@ load_splits_for_tx_list (GncSqlBackend* sql_be, InstanceVec& transactions)
 
     sql << "SELECT * FROM " << SPLIT_TABLE << " WHERE " <<
         tx_guid_col_table[0]->name() << " IN (";
-    gnc_sql_append_guids_to_sql (sql, transactions);
+    gnc_sql_append_guids_to_sql (sql_be, sql, transactions);
     sql << ")";
 
+    // Every transaction has at least two splits.
+    auto col = qof_book_get_collection (sql_be->book(), GNC_ID_SPLIT);
+    qof_collection_reserve (col, qof_collection_count (col) + 2 * transactions.size());
+
     // Execute the query and load the splits
     auto stmt = sql_be->create_statement_from_sql(sql.str());
-    auto result = sql_be->execute_select_statement (stmt);
+    auto result = sql_be->execute_streaming_select_statement (stmt);
+    if (result == nullptr)
+        return;
     InstanceVec instances;
 
     for (auto row : *result)
@@ -272,6 +278,7 @@ load_splits_for_tx_list (GncSqlBackend* sql_be, InstanceVec& transactions)
         if (s != nullptr)
             instances.push_back(QOF_INSTANCE(s));
     }
+    delete result;
 
     if (!instances.empty())
         gnc_sql_slots_load_for_instancevec (sql_be, instances);
@@ -343,9 +350,19 @@ query_transactions (GncSqlBackend* sql_be, const GncSqlStatementPtr& stmt)
     g_return_if_fail (sql_be != NULL);
     g_return_if_fail (stmt != NULL);
 
-    auto result = sql_be->execute_select_statement(stmt);
+    auto result = sql_be->execute_streaming_select_statement(stmt);
+    if (result == nullptr)
+        return;
     if (result->begin() == result->end())
+    {
+        delete result;
         return;
+    }
+
+    /* A streaming result only knows the size of its first batch, so this
+     * may be an underestimate; the collection will grow as needed. */
+    auto col = qof_book_get_collection (sql_be->book(), GNC_ID_TRANS);
+    qof_collection_reserve (col, qof_collection_count (col) + result->size());
 
     Transaction* tx;
 #if LOAD_TRANSACTIONS_AS_NEEDED
@@ -373,6 +390,7 @@ query_transactions (GncSqlBackend* sql_be, const GncSqlStatementPtr& stmt)
             instances.push_back(QOF_INSTANCE(tx));
         }
     }
+    delete result;
 
     // Load all splits and slots for the transactions
     if (!instances.empty())
@@ -527,6 +545,28 @@ GncSqlSplitBackend::create_tables (GncSqlBackend* sql_be)
                m_version);
     }
 }
+
+bool
+GncSqlTransBackend::upgrade_guid_columns (GncSqlBackend* sql_be)
+{
+    g_return_val_if_fail (sql_be != nullptr, false);
+
+    return sql_be->upgrade_guid_columns (m_table_name, tx_col_table,
+                                         {{"tx_post_date_index",
+                                           post_date_col_table}});
+}
+
+bool
+GncSqlSplitBackend::upgrade_guid_columns (GncSqlBackend* sql_be)
+{
+    g_return_val_if_fail (sql_be != nullptr, false);
+
+    return sql_be->upgrade_guid_columns (m_table_name, split_col_table,
+                                         {{"splits_tx_guid_index",
+                                           tx_guid_col_table},
+                                          {"splits_account_guid_index",
+                                           account_guid_col_table}});
+}
 /* ================================================================= */
 /**
  * Callback function to delete slots for a split
@@ -741,17 +781,16 @@ void gnc_sql_transaction_load_tx_for_account (GncSqlBackend* sql_be,
                                               Account* account)
 {
     const GncGUID* guid;
-    gchar guid_buf[GUID_ENCODING_LENGTH + 1];
     gchar* query_sql;
 
     g_return_if_fail (sql_be != NULL);
     g_return_if_fail (account != NULL);
 
     guid = qof_instance_get_guid (QOF_INSTANCE (account));
-    (void)guid_to_string_buff (guid, guid_buf);
+    auto guid_str = sql_be->quote_guid (guid);
     query_sql = g_strdup_printf (
-                    "SELECT DISTINCT t.* FROM %s AS t, %s AS s WHERE s.tx_guid=t.guid AND s.account_guid ='%s'",
-                    TRANSACTION_TABLE, SPLIT_TABLE, guid_buf);
+                    "SELECT DISTINCT t.* FROM %s AS t, %s AS s WHERE s.tx_guid=t.guid AND s.account_guid =%s",
+                    TRANSACTION_TABLE, SPLIT_TABLE, guid_str.c_str());
     auto stmt = sql_be->create_statement_from_sql(query_sql);
     g_free (query_sql);
     if (stmt != nullptr)
@@ -780,6 +819,37 @@ GncSqlTransBackend::load_all (GncSqlBackend* sql_be)
     }
 }
 
+/* The splits of a transaction can't be matched up with the database one at a
+ * time, so the transaction is thrown away and loaded afresh.
+ */
+bool
+GncSqlTransBackend::reload_object (GncSqlBackend* sql_be, const GncGUID& guid)
+{
+    g_return_val_if_fail (sql_be != NULL, false);
+
+    auto pTx = xaccTransLookup (&guid, sql_be->book());
+    if (pTx != nullptr)
+    {
+        xaccTransBeginEdit (pTx);
+        xaccTransDestroy (pTx);
+        xaccTransCommitEdit (pTx);
+        if (xaccTransLookup (&guid, sql_be->book()) != nullptr)
+        {
+            PWARN ("Read-only transaction changed by another session wasn't "
+                   "reloaded.");
+            return false;
+        }
+    }
+
+    std::stringstream sql;
+    sql << "SELECT * FROM " << TRANSACTION_TABLE << " WHERE " <<
+        tx_col_table[0]->name() << "=" << sql_be->quote_guid (&guid);
+    auto stmt = sql_be->create_statement_from_sql (sql.str());
+    if (stmt != nullptr)
+        query_transactions (sql_be, stmt);
+    return true;
+}
+
 static void
 convert_query_comparison_to_sql (QofQueryPredData* pPredData,
                                  gboolean isInverted, std::stringstream& sql)
@@ -844,12 +914,8 @@ convert_query_term_to_sql (const GncSqlBackend* sql_be, const gchar* fieldName,
         for (guid_entry = guid_data->guids; guid_entry != NULL;
              guid_entry = guid_entry->next)
         {
-            gchar guid_buf[GUID_ENCODING_LENGTH + 1];
-
             if (guid_entry != guid_data->guids) sql << ",";
-            (void)guid_to_string_buff (static_cast<GncGUID*> (guid_entry->data),
-                                       guid_buf);
-            sql << guid_buf;
+            sql << sql_be->quote_guid (static_cast<GncGUID*> (guid_entry->data));
         }
         sql << "))";
 
@@ -1300,24 +1366,19 @@ GncSqlColumnTableEntryImpl<CT_TXREF>::load (const GncSqlBackend* sql_be,
                                             QofIdTypeConst obj_name,
                                             gpointer pObject) const noexcept
 {
-    const gchar* guid_str;
-
     g_return_if_fail (sql_be != NULL);
     g_return_if_fail (pObject != NULL);
 
     try
     {
-        auto val = row.get_string_at_col (m_col_name);
-        GncGUID guid;
-        Transaction *tx = nullptr;
-        if (string_to_guid (val.c_str(), &guid))
-            tx = xaccTransLookup (&guid, sql_be->book());
+        auto guid = row.get_guid_at_col (m_col_name);
+        auto tx = xaccTransLookup (&guid, sql_be->book());
 
         // If the transaction is not found, try loading it
         if (tx == nullptr)
         {
             auto buf = std::string{"SELECT * FROM "} + TRANSACTION_TABLE +
-                                       " WHERE guid='" + val + "'";
+                                       " WHERE guid=" + sql_be->quote_guid(&guid);
             auto stmt = sql_be->create_statement_from_sql (buf);
             query_transactions ((GncSqlBackend*)sql_be, stmt);
             tx = xaccTransLookup (&guid, sql_be->book());
@@ -1336,11 +1397,12 @@ GncSqlColumnTableEntryImpl<CT_TXREF>::add_to_table(ColVec& vec) const noexcept
 }
 
 template<> void
-GncSqlColumnTableEntryImpl<CT_TXREF>::add_to_query(QofIdTypeConst obj_name,
+GncSqlColumnTableEntryImpl<CT_TXREF>::add_to_query(const GncSqlBackend* sql_be,
+                                                   QofIdTypeConst obj_name,
                                                    const gpointer pObject,
                                                    PairVec& vec) const noexcept
 {
-    add_objectref_guid_to_query(obj_name, pObject, vec);
+    add_objectref_guid_to_query(sql_be, obj_name, pObject, vec);
 }
 
 /* ========================== END OF FILE ===================== */
@@ -41,7 +41,9 @@ public:
     GncSqlTransBackend();
     void load_all(GncSqlBackend*) override;
     void create_tables(GncSqlBackend*) override;
+    bool upgrade_guid_columns(GncSqlBackend*) override;
     bool commit (GncSqlBackend* sql_be, QofInstance* inst) override;
+    bool reload_object (GncSqlBackend* sql_be, const GncGUID& guid) override;
 };
 
 class GncSqlSplitBackend : public GncSqlObjectBackend
@@ -50,6 +52,7 @@ public:
     GncSqlSplitBackend();
     void load_all(GncSqlBackend*) override { return; } // loaded by transaction.
     void create_tables(GncSqlBackend*) override;
+    bool upgrade_guid_columns(GncSqlBackend*) override;
     bool commit (GncSqlBackend* sql_be, QofInstance* inst) override;
 };
 
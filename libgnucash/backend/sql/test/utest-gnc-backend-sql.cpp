@@ -74,6 +74,8 @@ protected:
             { return std::string{"foo"}; }
             virtual time64 get_time64_at_col (const char* col) const
             { return 1466270857LL; }
+            virtual GncGUID get_guid_at_col (const char* col) const
+            { return *guid_null(); }
             virtual bool is_col_null(const char* col) const noexcept
             { return false; }
         private:
@@ -99,6 +101,9 @@ public:
     GncMockSqlConnection() : m_result{this} {}
     GncSqlResultPtr execute_select_statement (const GncSqlStatementPtr&)
         noexcept override { return &m_result; }
+    GncSqlResultPtr execute_streaming_select_statement (const GncSqlStatementPtr&,
+                                                        size_t)
+        noexcept override { return &m_result; }
     int execute_nonselect_statement (const GncSqlStatementPtr&)
         noexcept override { return 1; }
     GncSqlStatementPtr create_statement_from_sql (const std::string&)
@@ -117,6 +122,10 @@ public:
         const noexcept override { return false; }
     virtual std::string quote_string (const std::string& str)
         const noexcept override { return std::string{str}; }
+    std::string quote_binary (const std::string& hex)
+        const noexcept override { return hex; }
+    std::string hex_to_binary_expr (const std::string& col)
+        const noexcept override { return col; }
     int dberror() const noexcept override { return 0; }
     void set_error(int error, unsigned int repeat, bool retry) noexcept override { return; }
     bool verify() noexcept override { return true; }
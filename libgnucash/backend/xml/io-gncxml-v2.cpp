@@ -376,6 +376,17 @@ counter (const GncXmlDataType_t& data, file_backend* be_data)
     /* XXX: should we do anything with this counter? */
 }
 
+/* The count-data come before the elements they count, so the book's
+ * collections can be sized for them before any are loaded. */
+static void
+reserve_collection (QofBook* book, QofIdType type, gint64 count)
+{
+    if (count <= 0 || count > G_MAXUINT)
+        return;
+    auto col = qof_book_get_collection (book, type);
+    qof_collection_reserve (col, qof_collection_count (col) + count);
+}
+
 static gboolean
 gnc_counter_end_handler (gpointer data_for_children,
                          GSList* data_from_children, GSList* sibling_data,
@@ -415,10 +426,14 @@ gnc_counter_end_handler (gpointer data_for_children,
     else if (g_strcmp0 (type, "transaction") == 0)
     {
         sixdata->counter.transactions_total = val;
+        reserve_collection (sixdata->book, GNC_ID_TRANS, val);
+        /* Every transaction has at least two splits. */
+        reserve_collection (sixdata->book, GNC_ID_SPLIT, 2 * val);
     }
     else if (g_strcmp0 (type, "account") == 0)
     {
         sixdata->counter.accounts_total = val;
+        reserve_collection (sixdata->book, GNC_ID_ACCOUNT, val);
     }
     else if (g_strcmp0 (type, "book") == 0)
     {
@@ -439,6 +454,7 @@ gnc_counter_end_handler (gpointer data_for_children,
     else if (g_strcmp0 (type, "price") == 0)
     {
         sixdata->counter.prices_total = val;
+        reserve_collection (sixdata->book, GNC_ID_PRICE, val);
     }
     else
     {
@@ -40,16 +40,25 @@
 #include "gnc-lot.h"
 #include "gnc-pricedb.h"
 #include "qofinstance-p.h"
+extern "C"
+{
+#include "gnc-pricedb-p.h"
+}
 #include "gnc-features.h"
 #include "guid.hpp"
 
 #include <numeric>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 static QofLogModule log_module = GNC_MOD_ACCOUNT;
 
 /* The Canonical Account Separator.  Pre-Initialized. */
 static gchar account_separator[8] = ".";
 static gunichar account_uc_separator = ':';
+/* Bumped when the separator changes to expire all cached full names. */
+static guint account_separator_generation = 1;
 /* Predefined KVP paths */
 static const char *KEY_ASSOC_INCOME_ACCOUNT = "ofx/associated-income-account";
 #define AB_KEY "hbci"
@@ -153,6 +162,7 @@ gnc_set_account_separator (const gchar *separator)
     gunichar uc;
     gint count;
 
+    ++account_separator_generation;
     uc = g_utf8_get_char_validated(separator, -1);
     if ((uc == (gunichar) - 2) || (uc == (gunichar) - 1) || g_unichar_isalnum(uc))
     {
@@ -261,6 +271,8 @@ gnc_account_init(Account* acc)
     priv->accountName = static_cast<char*>(qof_string_cache_insert(""));
     priv->accountCode = static_cast<char*>(qof_string_cache_insert(""));
     priv->description = static_cast<char*>(qof_string_cache_insert(""));
+    priv->full_name = NULL;
+    priv->full_name_generation = 0;
 
     priv->type = ACCT_TYPE_NONE;
 
@@ -280,9 +292,13 @@ gnc_account_init(Account* acc)
     priv->starting_cleared_balance = gnc_numeric_zero();
     priv->starting_reconciled_balance = gnc_numeric_zero();
     priv->balance_dirty = FALSE;
+    priv->balance_cache = NULL;
+    g_queue_init (&priv->balance_lru);
+    priv->balance_cache_generation = 0;
 
     priv->splits = NULL;
     priv->sort_dirty = FALSE;
+    priv->split_index = NULL;
 }
 
 static void
@@ -995,6 +1011,304 @@ gnc_account_class_init (AccountClass *klass)
 
 }
 
+/* Drop the cached full names of acc and all of its descendants. */
+static void
+account_invalidate_full_names (Account *acc)
+{
+    auto priv = GET_PRIVATE(acc);
+    if (priv->full_name)
+    {
+        qof_string_cache_remove (priv->full_name);
+        priv->full_name = NULL;
+    }
+    for (auto node = priv->children; node; node = g_list_next (node))
+        account_invalidate_full_names (static_cast<Account*>(node->data));
+}
+
+/********************************************************************\
+ * Cache of balances including the sub-accounts.  An account's      *
+ * entry is the sum of its own balance and its children's entries,  *
+ * so a change only has to clear the entries of the account and of  *
+ * its ancestors; the rest of the tree keeps its totals.  Entries   *
+ * are keyed by balance function, report commodity and date, so the *
+ * two ends of a period, or all the periods of a budget, stay       *
+ * cached side by side.  Each account keeps at most                 *
+ * BALANCE_CACHE_SIZE of them and drops the least recently used     *
+ * first, however many dates a report walks through.                *
+\********************************************************************/
+
+static guint
+balance_cache_hash (gconstpointer key)
+{
+    auto entry = static_cast<const BalanceCacheEntry*>(key);
+    return g_direct_hash (entry->fn) ^ g_direct_hash (entry->commodity) ^
+           g_int64_hash (&entry->date);
+}
+
+static gboolean
+balance_cache_equal (gconstpointer a, gconstpointer b)
+{
+    auto ea = static_cast<const BalanceCacheEntry*>(a);
+    auto eb = static_cast<const BalanceCacheEntry*>(b);
+    return ea->fn == eb->fn && ea->commodity == eb->commodity &&
+           ea->date == eb->date;
+}
+
+static void
+account_clear_balances (AccountPrivate *priv)
+{
+    if (priv->balance_cache)
+        g_hash_table_remove_all (priv->balance_cache);
+    g_queue_clear (&priv->balance_lru);
+}
+
+/* Drop the cached balances of acc and all of its ancestors. */
+static void
+account_invalidate_balances (Account *acc)
+{
+    for (; acc; acc = GET_PRIVATE(acc)->parent)
+        account_clear_balances (GET_PRIVATE(acc));
+}
+
+/* Drop the array of splits used to look balances up by date. */
+static void
+account_invalidate_split_index (AccountPrivate *priv)
+{
+    if (priv->split_index)
+        g_ptr_array_free (priv->split_index, TRUE);
+    priv->split_index = NULL;
+}
+
+static BalanceCacheEntry *
+account_lookup_balance (Account *acc, const BalanceCacheEntry *key)
+{
+    auto priv = GET_PRIVATE(acc);
+
+    if (!priv->balance_cache)
+        return NULL;
+    /* Converted balances follow the price database.  Its generation
+     * moves on with every price change, even one made while events are
+     * suspended, as when a book is loaded. */
+    if (priv->balance_cache_generation != gnc_pricedb_get_generation ())
+    {
+        account_clear_balances (priv);
+        priv->balance_cache_generation = gnc_pricedb_get_generation ();
+        return NULL;
+    }
+    auto entry = static_cast<BalanceCacheEntry*>(g_hash_table_lookup (priv->balance_cache,
+                                                                      key));
+    if (entry)
+    {
+        g_queue_unlink (&priv->balance_lru, entry->lru);
+        g_queue_push_head_link (&priv->balance_lru, entry->lru);
+    }
+    return entry;
+}
+
+static void
+account_store_balance (Account *acc, const BalanceCacheEntry *key,
+                       gnc_numeric balance)
+{
+    auto priv = GET_PRIVATE(acc);
+
+    if (!priv->balance_cache)
+    {
+        priv->balance_cache = g_hash_table_new_full (balance_cache_hash,
+                                                     balance_cache_equal,
+                                                     g_free, NULL);
+        priv->balance_cache_generation = gnc_pricedb_get_generation ();
+    }
+
+    auto old = static_cast<BalanceCacheEntry*>(g_hash_table_lookup (priv->balance_cache,
+                                                                    key));
+    if (old)
+    {
+        old->balance = balance;
+        return;
+    }
+
+    while (priv->balance_lru.length >= BALANCE_CACHE_SIZE)
+    {
+        auto link = g_queue_pop_tail_link (&priv->balance_lru);
+        g_hash_table_remove (priv->balance_cache, link->data);
+        g_list_free_1 (link);
+    }
+
+    auto entry = g_new (BalanceCacheEntry, 1);
+    *entry = *key;
+    entry->balance = balance;
+    entry->lru = g_list_alloc ();
+    entry->lru->data = entry;
+    g_queue_push_head_link (&priv->balance_lru, entry->lru);
+    g_hash_table_insert (priv->balance_cache, entry, entry);
+}
+
+/********************************************************************\
+ * Book-level index of account names, codes and full names, so that *
+ * the gnc_account_lookup_by_* functions don't have to walk the     *
+ * whole tree.  Names and codes are kept up to date as they change; *
+ * full names depend on every ancestor and on the separator, so     *
+ * they're rebuilt on demand after anything moves or is renamed.    *
+\********************************************************************/
+
+#define ACCOUNT_INDEX_KEY "gnc-account-index"
+
+using AccountSet = std::unordered_set<Account*>;
+using AccountKeyMap = std::unordered_map<std::string, AccountSet>;
+
+struct AccountIndex
+{
+    AccountKeyMap by_name;
+    AccountKeyMap by_code;
+    AccountKeyMap by_full_name;
+    std::string full_name_separator;
+    bool full_names_valid = false;
+};
+
+static void
+account_index_free (QofBook *book, gpointer key, gpointer data)
+{
+    delete static_cast<AccountIndex*>(data);
+    /* Accounts are freed after the book's finalizers have run. */
+    qof_book_set_data (book, static_cast<const char*>(key), NULL);
+}
+
+static AccountIndex*
+account_index (const Account *acc)
+{
+    auto book = qof_instance_get_book (acc);
+    if (!book || qof_book_shutting_down (book))
+        return nullptr;
+    return static_cast<AccountIndex*>(qof_book_get_data (book,
+                                                         ACCOUNT_INDEX_KEY));
+}
+
+static AccountIndex*
+account_index_get_or_create (const Account *acc)
+{
+    auto book = qof_instance_get_book (acc);
+    if (!book || qof_book_shutting_down (book))
+        return nullptr;
+    auto index = static_cast<AccountIndex*>(qof_book_get_data (book,
+                                                               ACCOUNT_INDEX_KEY));
+    if (!index)
+    {
+        index = new AccountIndex;
+        qof_book_set_data_fin (book, ACCOUNT_INDEX_KEY, index,
+                               account_index_free);
+    }
+    return index;
+}
+
+static void
+account_key_map_add (AccountKeyMap& map, const char *key, Account *acc)
+{
+    if (key && *key)
+        map[key].insert (acc);
+}
+
+static void
+account_key_map_remove (AccountKeyMap& map, const char *key, Account *acc)
+{
+    if (!key || !*key)
+        return;
+    auto iter = map.find (key);
+    if (iter == map.end ())
+        return;
+    iter->second.erase (acc);
+    if (iter->second.empty ())
+        map.erase (iter);
+}
+
+static void
+account_index_add (Account *acc)
+{
+    auto index = account_index_get_or_create (acc);
+    if (!index)
+        return;
+    auto priv = GET_PRIVATE(acc);
+    account_key_map_add (index->by_name, priv->accountName, acc);
+    account_key_map_add (index->by_code, priv->accountCode, acc);
+    index->full_names_valid = false;
+}
+
+static void
+account_index_remove (Account *acc)
+{
+    auto index = account_index (acc);
+    if (!index)
+        return;
+    auto priv = GET_PRIVATE(acc);
+    account_key_map_remove (index->by_name, priv->accountName, acc);
+    account_key_map_remove (index->by_code, priv->accountCode, acc);
+    index->full_names_valid = false;
+}
+
+static void
+account_index_invalidate_full_names (const Account *acc)
+{
+    auto index = account_index (acc);
+    if (index)
+        index->full_names_valid = false;
+}
+
+static void
+account_index_add_full_name (QofInstance *inst, gpointer data)
+{
+    auto index = static_cast<AccountIndex*>(data);
+    auto acc = GNC_ACCOUNT (inst);
+    account_key_map_add (index->by_full_name, xaccAccountGetFullName (acc), acc);
+}
+
+static const AccountKeyMap&
+account_index_full_names (AccountIndex *index, QofBook *book)
+{
+    if (index->full_names_valid &&
+        index->full_name_separator == account_separator)
+        return index->by_full_name;
+
+    index->by_full_name.clear ();
+    qof_collection_foreach (qof_book_get_collection (book, GNC_ID_ACCOUNT),
+                            account_index_add_full_name, index);
+    index->full_name_separator = account_separator;
+    index->full_names_valid = true;
+    return index->by_full_name;
+}
+
+static bool
+account_is_descendant (const Account *acc, const Account *ancestor)
+{
+    for (auto parent = GET_PRIVATE(acc)->parent; parent;
+         parent = GET_PRIVATE(parent)->parent)
+        if (parent == ancestor)
+            return true;
+    return false;
+}
+
+/* Look up key in an index map among the descendants of parent.  Returns
+ * TRUE when the answer is known: *result is then the only match, or NULL
+ * if there is none.  Returns FALSE when several accounts match, in which
+ * case the caller walks the tree to pick the same one it always has.
+ */
+static gboolean
+account_index_lookup (const AccountKeyMap& map, const char *key,
+                      const Account *parent, Account **result)
+{
+    *result = nullptr;
+    auto iter = map.find (key);
+    if (iter == map.end ())
+        return TRUE;
+    for (auto acc : iter->second)
+    {
+        if (!account_is_descendant (acc, parent))
+            continue;
+        if (*result)
+            return FALSE;
+        *result = acc;
+    }
+    return TRUE;
+}
+
 static void
 xaccInitAccount (Account * acc, QofBook *book)
 {
@@ -1110,7 +1424,9 @@ gnc_account_create_root (QofBook *book)
     rpriv = GET_PRIVATE(root);
     xaccAccountBeginEdit(root);
     rpriv->type = ACCT_TYPE_ROOT;
+    account_index_remove (root);
     rpriv->accountName = qof_string_cache_replace(rpriv->accountName, "Root Account");
+    account_index_add (root);
     mark_account (root);
     xaccAccountCommitEdit(root);
     gnc_book_set_root_account(book, root);
@@ -1142,6 +1458,7 @@ xaccCloneAccount(const Account *from, QofBook *book)
     priv->accountName = static_cast<char*>(qof_string_cache_insert(from_priv->accountName));
     priv->accountCode = static_cast<char*>(qof_string_cache_insert(from_priv->accountCode));
     priv->description = static_cast<char*>(qof_string_cache_insert(from_priv->description));
+    account_index_add (ret);
 
     qof_instance_copy_kvp (QOF_INSTANCE (ret), QOF_INSTANCE (from));
 
@@ -1253,6 +1570,15 @@ xaccFreeAccount (Account *acc)
 */
     }
 
+    account_index_remove (acc);
+    account_invalidate_split_index (priv);
+    g_queue_clear (&priv->balance_lru);
+    if (priv->balance_cache)
+        g_hash_table_destroy (priv->balance_cache);
+    priv->balance_cache = nullptr;
+    if (priv->full_name)
+        qof_string_cache_remove(priv->full_name);
+    priv->full_name = nullptr;
     qof_string_cache_remove(priv->accountName);
     qof_string_cache_remove(priv->accountCode);
     qof_string_cache_remove(priv->description);
@@ -1367,6 +1693,7 @@ xaccAccountCommitEdit (Account *acc)
         {
             g_list_free(priv->splits);
             priv->splits = NULL;
+            account_invalidate_split_index (priv);
         }
 
         /* It turns out there's a case where this assertion does not hold:
@@ -1718,6 +2045,7 @@ gnc_account_set_balance_dirty (Account *acc)
 
     priv = GET_PRIVATE(acc);
     priv->balance_dirty = TRUE;
+    account_invalidate_balances (acc);
 }
 
 /********************************************************************\
@@ -1747,6 +2075,7 @@ gnc_account_insert_split (Account *acc, Split *s)
         priv->splits = g_list_prepend(priv->splits, s);
         priv->sort_dirty = TRUE;
     }
+    account_invalidate_split_index (priv);
 
     //FIXME: find better event
     qof_event_gen (&acc->inst, QOF_EVENT_MODIFY, NULL);
@@ -1754,6 +2083,7 @@ gnc_account_insert_split (Account *acc, Split *s)
     qof_event_gen(&acc->inst, GNC_EVENT_ITEM_ADDED, s);
 
     priv->balance_dirty = TRUE;
+    account_invalidate_balances (acc);
 //  DRH: Should the below be added? It is present in the delete path.
 //  xaccAccountRecomputeBalance(acc);
     return TRUE;
@@ -1774,12 +2104,14 @@ gnc_account_remove_split (Account *acc, Split *s)
         return FALSE;
 
     priv->splits = g_list_delete_link(priv->splits, node);
+    account_invalidate_split_index (priv);
     //FIXME: find better event type
     qof_event_gen(&acc->inst, QOF_EVENT_MODIFY, NULL);
     // And send the account-based event, too
     qof_event_gen(&acc->inst, GNC_EVENT_ITEM_REMOVED, s);
 
     priv->balance_dirty = TRUE;
+    account_invalidate_balances (acc);
     xaccAccountRecomputeBalance(acc);
     return TRUE;
 }
@@ -1795,8 +2127,10 @@ xaccAccountSortSplits (Account *acc, gboolean force)
     if (!priv->sort_dirty || (!force && qof_instance_get_editlevel(acc) > 0))
         return;
     priv->splits = g_list_sort(priv->splits, (GCompareFunc)xaccSplitOrder);
+    account_invalidate_split_index (priv);
     priv->sort_dirty = FALSE;
     priv->balance_dirty = TRUE;
+    account_invalidate_balances (acc);
 }
 
 static void
@@ -2112,6 +2446,7 @@ xaccAccountRecomputeBalance (Account * acc)
     priv->balance = balance;
     priv->cleared_balance = cleared_balance;
     priv->reconciled_balance = reconciled_balance;
+    account_invalidate_balances (acc);
     priv->balance_dirty = FALSE;
 }
 
@@ -2228,6 +2563,7 @@ xaccAccountSetType (Account *acc, GNCAccountType tip)
     xaccAccountBeginEdit(acc);
     priv->type = tip;
     priv->balance_dirty = TRUE; /* new type may affect balance computation */
+    account_invalidate_balances (acc);
     mark_account(acc);
     xaccAccountCommitEdit(acc);
 }
@@ -2247,7 +2583,10 @@ xaccAccountSetName (Account *acc, const char *str)
         return;
 
     xaccAccountBeginEdit(acc);
+    account_index_remove (acc);
     priv->accountName = qof_string_cache_replace(priv->accountName, str);
+    account_index_add (acc);
+    account_invalidate_full_names (acc);
     mark_account (acc);
     xaccAccountCommitEdit(acc);
 }
@@ -2266,7 +2605,9 @@ xaccAccountSetCode (Account *acc, const char *str)
         return;
 
     xaccAccountBeginEdit(acc);
+    account_index_remove (acc);
     priv->accountCode = qof_string_cache_replace(priv->accountCode, str ? str : "");
+    account_index_add (acc);
     mark_account (acc);
     xaccAccountCommitEdit(acc);
 }
@@ -2410,6 +2751,7 @@ xaccAccountSetCommodity (Account * acc, gnc_commodity * com)
 
     priv->sort_dirty = TRUE;  /* Not needed. */
     priv->balance_dirty = TRUE;
+    account_invalidate_balances (acc);
     mark_account (acc);
 
     xaccAccountCommitEdit(acc);
@@ -2554,14 +2896,19 @@ gnc_account_append_child (Account *new_parent, Account *child)
             PWARN ("reparenting accounts across books is not correctly supported\n");
 
             qof_event_gen (&child->inst, QOF_EVENT_DESTROY, NULL);
+            account_index_remove (child);
             col = qof_book_get_collection (qof_instance_get_book(new_parent),
                                            GNC_ID_ACCOUNT);
             qof_collection_insert_entity (col, &child->inst);
+            account_index_add (child);
             qof_event_gen (&child->inst, QOF_EVENT_CREATE, NULL);
         }
     }
     cpriv->parent = new_parent;
     ppriv->children = g_list_append(ppriv->children, child);
+    account_invalidate_balances (new_parent);
+    account_index_invalidate_full_names (child);
+    account_invalidate_full_names (child);
     qof_instance_set_dirty(&new_parent->inst);
     qof_instance_set_dirty(&child->inst);
 
@@ -2602,12 +2949,15 @@ gnc_account_remove_child (Account *parent, Account *child)
     ed.idx = g_list_index(ppriv->children, child);
 
     ppriv->children = g_list_remove(ppriv->children, child);
+    account_invalidate_balances (parent);
 
     /* Now send the event. */
     qof_event_gen(&child->inst, QOF_EVENT_REMOVE, &ed);
 
     /* clear the account's parent pointer after REMOVE event generation. */
     cpriv->parent = NULL;
+    account_index_invalidate_full_names (child);
+    account_invalidate_full_names (child);
 
     qof_event_gen (&parent->inst, QOF_EVENT_MODIFY, NULL);
 }
@@ -2802,6 +3152,11 @@ gnc_account_lookup_by_name (const Account *parent, const char * name)
     g_return_val_if_fail(GNC_IS_ACCOUNT(parent), NULL);
     g_return_val_if_fail(name, NULL);
 
+    auto index = account_index (parent);
+    if (index && *name &&
+        account_index_lookup (index->by_name, name, parent, &result))
+        return result;
+
     /* first, look for accounts hanging off the current node */
     ppriv = GET_PRIVATE(parent);
     for (node = ppriv->children; node; node = node->next)
@@ -2835,6 +3190,11 @@ gnc_account_lookup_by_code (const Account *parent, const char * code)
     g_return_val_if_fail(GNC_IS_ACCOUNT(parent), NULL);
     g_return_val_if_fail(code, NULL);
 
+    auto index = account_index (parent);
+    if (index && *code &&
+        account_index_lookup (index->by_code, code, parent, &result))
+        return result;
+
     /* first, look for accounts hanging off the current node */
     ppriv = GET_PRIVATE(parent);
     for (node = ppriv->children; node; node = node->next)
@@ -2923,6 +3283,14 @@ gnc_account_lookup_by_full_name (const Account *any_acc,
         root = rpriv->parent;
         rpriv = GET_PRIVATE(root);
     }
+
+    auto index = account_index (root);
+    if (index && *name &&
+        account_index_lookup (account_index_full_names (index,
+                                                        qof_instance_get_book (root)),
+                              name, root, &found))
+        return found;
+
     names = g_strsplit(name, gnc_get_account_separator_string(), -1);
     found = gnc_account_lookup_by_full_name_helper(root, names);
     g_strfreev(names);
@@ -3027,15 +3395,41 @@ xaccAccountGetName (const Account *acc)
     return GET_PRIVATE(acc)->accountName;
 }
 
+const char *
+xaccAccountGetFullName (const Account *account)
+{
+    AccountPrivate *priv, *ppriv;
+
+    if (NULL == account)
+        return "";
+    g_return_val_if_fail(GNC_IS_ACCOUNT(account), "");
+
+    priv = GET_PRIVATE(account);
+    if (!priv->parent)
+        return "";
+    if (priv->full_name &&
+        priv->full_name_generation == account_separator_generation)
+        return priv->full_name;
+
+    /* The root account's name isn't part of the full name, so the
+     * children of the root are known by their own name. */
+    ppriv = GET_PRIVATE(priv->parent);
+    auto fullname = ppriv->parent ?
+        g_strjoin (account_separator, xaccAccountGetFullName (priv->parent),
+                   priv->accountName, NULL) :
+        g_strdup (priv->accountName);
+
+    if (priv->full_name)
+        qof_string_cache_remove (priv->full_name);
+    priv->full_name = static_cast<char*>(qof_string_cache_insert (fullname));
+    priv->full_name_generation = account_separator_generation;
+    g_free (fullname);
+    return priv->full_name;
+}
+
 gchar *
 gnc_account_get_full_name(const Account *account)
 {
-    AccountPrivate *priv;
-    const Account *a;
-    char *fullname;
-    gchar **names;
-    int level;
-
     /* So much for hardening the API. Too many callers to this function don't
      * bother to check if they have a non-NULL pointer before calling. */
     if (NULL == account)
@@ -3044,35 +3438,7 @@ gnc_account_get_full_name(const Account *account)
     /* errors */
     g_return_val_if_fail(GNC_IS_ACCOUNT(account), g_strdup(""));
 
-    /* optimizations */
-    priv = GET_PRIVATE(account);
-    if (!priv->parent)
-        return g_strdup("");
-
-    /* Figure out how much space is needed by counting the nodes up to
-     * the root. */
-    level = 0;
-    for (a = account; a; a = priv->parent)
-    {
-        priv = GET_PRIVATE(a);
-        level++;
-    }
-
-    /* Get all the pointers in the right order. The root node "entry"
-     * becomes the terminating NULL pointer for the array of strings. */
-    names = (gchar **)g_malloc(level * sizeof(gchar *));
-    names[--level] = NULL;
-    for (a = account; level > 0; a = priv->parent)
-    {
-        priv = GET_PRIVATE(a);
-        names[--level] = priv->accountName;
-    }
-
-    /* Build the full name */
-    fullname =  g_strjoinv(account_separator, names);
-    g_free(names);
-
-    return fullname;
+    return g_strdup (xaccAccountGetFullName (account));
 }
 
 const char *
@@ -3196,6 +3562,7 @@ gnc_account_set_start_balance (Account *acc, const gnc_numeric start_baln)
     priv = GET_PRIVATE(acc);
     priv->starting_balance = start_baln;
     priv->balance_dirty = TRUE;
+    account_invalidate_balances (acc);
 }
 
 void
@@ -3209,6 +3576,7 @@ gnc_account_set_start_cleared_balance (Account *acc,
     priv = GET_PRIVATE(acc);
     priv->starting_cleared_balance = start_baln;
     priv->balance_dirty = TRUE;
+    account_invalidate_balances (acc);
 }
 
 void
@@ -3222,6 +3590,7 @@ gnc_account_set_start_reconciled_balance (Account *acc,
     priv = GET_PRIVATE(acc);
     priv->starting_reconciled_balance = start_baln;
     priv->balance_dirty = TRUE;
+    account_invalidate_balances (acc);
 }
 
 gnc_numeric
@@ -3286,15 +3655,9 @@ xaccAccountGetProjectedMinimumBalance (const Account *acc)
 gnc_numeric
 xaccAccountGetBalanceAsOfDate (Account *acc, time64 date)
 {
-    /* Ideally this could use xaccAccountForEachSplit, but
-     * it doesn't exist yet and I'm uncertain of exactly how
-     * it would work at this time, since it differs from
-     * xaccAccountForEachTransaction by using gpointer return
-     * values rather than gints.
-     */
     AccountPrivate *priv;
     GList   *lp;
-    gboolean found = FALSE;
+    guint lo, hi;
     gnc_numeric balance;
 
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), gnc_numeric_zero());
@@ -3305,37 +3668,39 @@ xaccAccountGetBalanceAsOfDate (Account *acc, time64 date)
     priv = GET_PRIVATE(acc);
     balance = priv->balance;
 
-    /* Since transaction post times are stored as a Timespec,
-     * convert date into a Timespec as well rather than converting
-     * each transaction's Timespec into a time64.
-     *
-     * FIXME: CAS: I think this comment is a bogus justification for
-     * using xaccTransGetDatePostedTS.  There's no benefit to using
-     * Timespec when the input argument is time64, and it's hard to
-     * imagine that casting long long to long and comparing two longs is
-     * worse than comparing two long longs every time.  IMO,
-     * xaccAccountGetPresentBalance gets this right, and its algorithm
-     * should be used here.
-     */
+    /* The splits are sorted by date posted, so the first one posted on
+     * or after the date can be found with a binary search.  Budgets and
+     * the account tree ask for many dates in a row, so the index is
+     * kept until the split list changes again. */
+    if (!priv->split_index)
+    {
+        priv->split_index = g_ptr_array_sized_new (g_list_length (priv->splits));
+        for (lp = priv->splits; lp; lp = lp->next)
+            g_ptr_array_add (priv->split_index, lp->data);
+    }
 
-    lp = priv->splits;
-    while ( lp && !found )
+    lo = 0;
+    hi = priv->split_index->len;
+    while (lo < hi)
     {
-        time64 trans_time = xaccTransRetDatePosted( xaccSplitGetParent( (Split *)lp->data ));
-        if ( trans_time >= date )
-            found = TRUE;
+        guint mid = lo + (hi - lo) / 2;
+        auto split = static_cast<Split*>(g_ptr_array_index (priv->split_index, mid));
+        if (xaccTransRetDatePosted (xaccSplitGetParent (split)) < date)
+            lo = mid + 1;
         else
-            lp = lp->next;
+            hi = mid;
     }
 
-    if ( lp )
+    if (lo < priv->split_index->len)
     {
-        if ( lp->prev )
+        if (lo > 0)
         {
-            /* Since lp is now pointing to a split which was past the reconcile
+            /* Since lo is now pointing to a split which was past the
              * date, get the running balance of the previous split.
              */
-            balance = xaccSplitGetBalance( (Split *)lp->prev->data );
+            auto split = static_cast<Split*>(g_ptr_array_index (priv->split_index,
+                                                                 lo - 1));
+            balance = xaccSplitGetBalance (split);
         }
         else
         {
@@ -3488,7 +3853,6 @@ xaccAccountGetXxxBalanceAsOfDateInCurrency(Account *acc, time64 date,
 typedef struct
 {
     const gnc_commodity *currency;
-    gnc_numeric balance;
     xaccGetBalanceFn fn;
     xaccGetBalanceAsOfDateFn asOfDateFn;
     time64 date;
@@ -3496,45 +3860,50 @@ typedef struct
 
 
 /*
- * A helper function for iterating over all the accounts in a list or
- * tree.  This function is called once per account, and sums up the
- * values of all these accounts.
+ * Sum up the balance of an account and of all its descendants,
+ * converted to the requested commodity.  The sums are cached on each
+ * account of the subtree, so after a change only the sums of the
+ * changed account's ancestors are computed again.
  */
-static void
-xaccAccountBalanceHelper (Account *acc, gpointer data)
+static gnc_numeric
+xaccAccountGetRolledUpBalance (Account *acc, const CurrencyBalance *cb)
 {
-    CurrencyBalance *cb = static_cast<CurrencyBalance*>(data);
+    BalanceCacheEntry key;
     gnc_numeric balance;
 
-    if (!cb->fn || !cb->currency)
-        return;
-    balance = xaccAccountGetXxxBalanceInCurrency (acc, cb->fn, cb->currency);
-    cb->balance = gnc_numeric_add (cb->balance, balance,
-                                   gnc_commodity_get_fraction (cb->currency),
-                                   GNC_HOW_RND_ROUND_HALF_UP);
-}
+    key.fn = cb->fn ? reinterpret_cast<gpointer>(cb->fn) :
+             reinterpret_cast<gpointer>(cb->asOfDateFn);
+    key.commodity = cb->currency;
+    key.date = cb->date;
 
-static void
-xaccAccountBalanceAsOfDateHelper (Account *acc, gpointer data)
-{
-    CurrencyBalance *cb = static_cast<CurrencyBalance*>(data);
-    gnc_numeric balance;
+    auto entry = account_lookup_balance (acc, &key);
+    if (entry)
+        return entry->balance;
 
-    g_return_if_fail (cb->asOfDateFn && cb->currency);
+    if (cb->fn)
+        balance = xaccAccountGetXxxBalanceInCurrency (acc, cb->fn, cb->currency);
+    else
+        balance = xaccAccountGetXxxBalanceAsOfDateInCurrency (
+                      acc, cb->date, cb->asOfDateFn, cb->currency);
 
-    balance = xaccAccountGetXxxBalanceAsOfDateInCurrency (
-                  acc, cb->date, cb->asOfDateFn, cb->currency);
-    cb->balance = gnc_numeric_add (cb->balance, balance,
+    for (auto node = GET_PRIVATE(acc)->children; node; node = g_list_next (node))
+    {
+        auto child = static_cast<Account*>(node->data);
+        balance = gnc_numeric_add (balance,
+                                   xaccAccountGetRolledUpBalance (child, cb),
                                    gnc_commodity_get_fraction (cb->currency),
                                    GNC_HOW_RND_ROUND_HALF_UP);
-}
+    }
 
+    account_store_balance (acc, &key, balance);
+    return balance;
+}
 
 
 /*
  * Common function that iterates recursively over all accounts below
- * the specified account.  It uses xaccAccountBalanceHelper to sum up
- * the balances of all its children, and uses the specified function
+ * the specified account.  It uses xaccAccountGetRolledUpBalance to sum
+ * up the balances of all its children, and uses the specified function
  * 'fn' for extracting the balance.  This function may extract the
  * current value, the reconciled value, etc.
  *
@@ -3547,35 +3916,23 @@ xaccAccountGetXxxBalanceInCurrencyRecursive (const Account *acc,
         const gnc_commodity *report_commodity,
         gboolean include_children)
 {
-    gnc_numeric balance;
-
     if (!acc) return gnc_numeric_zero ();
     if (!report_commodity)
         report_commodity = xaccAccountGetCommodity (acc);
     if (!report_commodity)
         return gnc_numeric_zero();
 
-    balance = xaccAccountGetXxxBalanceInCurrency (acc, fn, report_commodity);
+    if (!include_children)
+        return xaccAccountGetXxxBalanceInCurrency (acc, fn, report_commodity);
 
-    /* If needed, sum up the children converting to the *requested*
-       commodity. */
-    if (include_children)
-    {
-#ifdef _MSC_VER
-        /* MSVC compiler: Somehow, the struct initialization containing a
-           gnc_numeric doesn't work. As an exception, we hand-initialize
-           that member afterwards. */
-        CurrencyBalance cb = { report_commodity, { 0 }, fn, NULL, 0 };
-        cb.balance = balance;
-#else
-        CurrencyBalance cb = { report_commodity, balance, fn, NULL, 0 };
-#endif
-
-        gnc_account_foreach_descendant (acc, xaccAccountBalanceHelper, &cb);
-        balance = cb.balance;
-    }
+    /* The present and projected minimum balances depend on today's
+     * date, so today is part of their key. */
+    CurrencyBalance cb = { report_commodity, fn, NULL, 0 };
+    if (fn == xaccAccountGetPresentBalance ||
+        fn == xaccAccountGetProjectedMinimumBalance)
+        cb.date = gnc_time64_get_today_end ();
 
-    return balance;
+    return xaccAccountGetRolledUpBalance (const_cast<Account*>(acc), &cb);
 }
 
 static gnc_numeric
@@ -3583,36 +3940,18 @@ xaccAccountGetXxxBalanceAsOfDateInCurrencyRecursive (
     Account *acc, time64 date, xaccGetBalanceAsOfDateFn fn,
     gnc_commodity *report_commodity, gboolean include_children)
 {
-    gnc_numeric balance;
-
     g_return_val_if_fail(acc, gnc_numeric_zero());
     if (!report_commodity)
         report_commodity = xaccAccountGetCommodity (acc);
     if (!report_commodity)
         return gnc_numeric_zero();
 
-    balance = xaccAccountGetXxxBalanceAsOfDateInCurrency(
-                  acc, date, fn, report_commodity);
-
-    /* If needed, sum up the children converting to the *requested*
-       commodity. */
-    if (include_children)
-    {
-#ifdef _MSC_VER
-        /* MSVC compiler: Somehow, the struct initialization containing a
-           gnc_numeric doesn't work. As an exception, we hand-initialize
-           that member afterwards. */
-        CurrencyBalance cb = { report_commodity, 0, NULL, fn, date };
-        cb.balance = balance;
-#else
-        CurrencyBalance cb = { report_commodity, balance, NULL, fn, date };
-#endif
-
-        gnc_account_foreach_descendant (acc, xaccAccountBalanceAsOfDateHelper, &cb);
-        balance = cb.balance;
-    }
+    if (!include_children)
+        return xaccAccountGetXxxBalanceAsOfDateInCurrency(
+                   acc, date, fn, report_commodity);
 
-    return balance;
+    CurrencyBalance cb = { report_commodity, NULL, fn, date };
+    return xaccAccountGetRolledUpBalance (acc, &cb);
 }
 
 gnc_numeric
@@ -5086,17 +5425,14 @@ gnc_account_imap_find_account (GncImportMatchMap *imap,
                                const char *category,
                                const char *key)
 {
-    GValue v = G_VALUE_INIT;
-    GncGUID * guid = NULL;
     if (!imap || !key) return NULL;
-    std::vector<std::string> path {IMAP_FRAME};
-    if (category)
-        path.push_back (category);
-    path.push_back (key);
-    qof_instance_get_path_kvp (QOF_INSTANCE (imap->acc), &v, path);
-    if (G_VALUE_HOLDS_BOXED (&v))
-        guid = (GncGUID*)g_value_get_boxed (&v);
-    return xaccAccountLookup (guid, imap->book);
+    auto inst = QOF_INSTANCE (imap->acc);
+    auto value = category ?
+        qof_instance_get_path_kvp_value (inst, {IMAP_FRAME, category, key}) :
+        qof_instance_get_path_kvp_value (inst, {IMAP_FRAME, key});
+    if (!value)
+        return NULL;
+    return xaccAccountLookup (value->get<GncGUID*> (), imap->book);
 }
 
 /* Store an Account in the map */
@@ -5182,16 +5518,89 @@ struct AccountInfo
     int32_t probability;
 };
 
+#define IMAP_BAYES_INDEX "imap-bayes-index"
+
+/** The Bayesian entries of a source account, by token, so that a lookup
+ * needn't walk the account's slots once for every token. generation is that
+ * of the slot frame the index was built from; any other write to the slots,
+ * or replacing them, changes it and the index is rebuilt.
+ */
+struct ImapBayesIndex
+{
+    std::unordered_map<std::string, TokenAccountsInfo> tokens;
+    uint64_t generation;
+};
+
+static void
+imap_bayes_index_add (ImapBayesIndex & index, std::string const & token,
+                      std::string const & account_guid, int64_t count)
+{
+    auto & info = index.tokens[token];
+    info.total_count += count;
+    auto account = std::find_if (info.accounts.begin (), info.accounts.end (),
+        [&account_guid] (AccountTokenCount const & a) {
+            return a.account_guid == account_guid; });
+    if (account != info.accounts.end ())
+        account->token_count += count;
+    else
+        info.accounts.push_back ({account_guid, count});
+}
+
+static void
+imap_bayes_index_free (gpointer data)
+{
+    delete static_cast<ImapBayesIndex*> (data);
+}
+
 static void
-build_token_info(char const * key, KvpValue * value, TokenAccountsInfo & tokenInfo)
+imap_bayes_index_invalidate (Account * acc)
+{
+    g_object_set_data (G_OBJECT (acc), IMAP_BAYES_INDEX, nullptr);
+}
+
+/* Returns the account's index if it's current, otherwise nullptr. */
+static ImapBayesIndex *
+imap_bayes_index_peek (Account * acc)
+{
+    auto index = static_cast<ImapBayesIndex*> (g_object_get_data (G_OBJECT (acc),
+                                                                IMAP_BAYES_INDEX));
+    auto frame = qof_instance_get_slots (QOF_INSTANCE (acc));
+    if (index && index->generation != frame->generation ())
+    {
+        imap_bayes_index_invalidate (acc);
+        index = nullptr;
+    }
+    return index;
+}
+
+static ImapBayesIndex &
+imap_bayes_index_get (Account * acc)
 {
-    tokenInfo.total_count += value->get<int64_t>();
-    AccountTokenCount this_account;
-    std::string account_guid {key};
-    /*By convention, the key ends with the account GUID.*/
-    this_account.account_guid = account_guid.substr(account_guid.size() - GUID_ENCODING_LENGTH);
-    this_account.token_count = value->get<int64_t>();
-    tokenInfo.accounts.push_back(this_account);
+    auto index = imap_bayes_index_peek (acc);
+    if (index)
+        return *index;
+    index = new ImapBayesIndex;
+    auto frame = qof_instance_get_slots (QOF_INSTANCE (acc));
+    index->generation = frame->generation ();
+    /* Keys are IMAP_FRAME_BAYES/token/account_guid, and the token may itself
+     * contain '/'. */
+    auto header_length = strlen (IMAP_FRAME_BAYES "/");
+    frame->for_each_slot_prefix (IMAP_FRAME_BAYES "/",
+        [index, header_length] (char const * key, KvpValue * value) {
+            std::string path {key};
+            if (path.size () < header_length + GUID_ENCODING_LENGTH + 1 ||
+                value->get_type () != KvpValue::Type::INT64)
+                return;
+            auto guid_start = path.size () - GUID_ENCODING_LENGTH;
+            imap_bayes_index_add (*index,
+                                  path.substr (header_length, guid_start - 1 - header_length),
+                                  path.substr (guid_start), value->get<int64_t> ());
+        });
+    g_object_set_data_full (G_OBJECT (acc), IMAP_BAYES_INDEX, index,
+                            imap_bayes_index_free);
+    PINFO ("Indexed %" G_GSIZE_FORMAT " tokens for '%s'", index->tokens.size (),
+           xaccAccountGetName (acc));
+    return *index;
 }
 
 /** We scale the probability values by probability_factor.
@@ -5231,21 +5640,24 @@ static ProbabilityVec
 get_first_pass_probabilities(GncImportMatchMap * imap, GList * tokens)
 {
     ProbabilityVec ret;
+    std::unordered_map<std::string, std::size_t> positions;
+    auto const & index = imap_bayes_index_get (imap->acc);
     /* find the probability for each account that contains any of the tokens
      * in the input tokens list. */
     for (auto current_token = tokens; current_token; current_token = current_token->next)
     {
-        TokenAccountsInfo tokenInfo{};
-        auto path = std::string{IMAP_FRAME_BAYES "/"} + static_cast <char const *> (current_token->data);
-        qof_instance_foreach_slot_prefix (QOF_INSTANCE (imap->acc), path, &build_token_info, tokenInfo);
+        if (!current_token->data)
+            continue;
+        auto token = index.tokens.find (static_cast <char const *> (current_token->data));
+        if (token == index.tokens.end ())
+            continue;
+        auto const & tokenInfo = token->second;
         for (auto const & current_account_token : tokenInfo.accounts)
         {
-            auto item = std::find_if(ret.begin(), ret.end(), [&current_account_token]
-                (std::pair<std::string, AccountProbability> const & a) {
-                    return current_account_token.account_guid == a.first;
-                });
-            if (item != ret.end())
+            auto position = positions.find (current_account_token.account_guid);
+            if (position != positions.end ())
             {/* This account is already in the map */
+                auto item = ret.begin () + position->second;
                 item->second.product = ((double)current_account_token.token_count /
                                       (double)tokenInfo.total_count) * item->second.product;
                 item->second.product_difference = ((double)1 - ((double)current_account_token.token_count /
@@ -5258,6 +5670,7 @@ get_first_pass_probabilities(GncImportMatchMap * imap, GList * tokens)
                 new_probability.product = ((double)current_account_token.token_count /
                                       (double)tokenInfo.total_count);
                 new_probability.product_difference = 1 - (new_probability.product);
+                positions.emplace (current_account_token.account_guid, ret.size ());
                 ret.push_back({current_account_token.account_guid, std::move(new_probability)});
             }
         } /* for all accounts in tokenInfo */
@@ -5363,6 +5776,7 @@ convert_imap_account_bayes_to_flat (Account *acc)
         return false;
     auto new_imap = get_new_flat_imap(acc);
     xaccAccountBeginEdit(acc);
+    imap_bayes_index_invalidate (acc);
     frame->set({IMAP_FRAME_BAYES}, nullptr);
     if (!new_imap.size ())
     {
@@ -5509,6 +5923,9 @@ gnc_account_imap_add_account_bayes (GncImportMatchMap *imap,
     PINFO("account name: '%s'", account_fullname);
 
     guid_string = guid_to_string (xaccAccountGetGUID (acc));
+    /* Keep an existing index up to date rather than have the next lookup
+     * rebuild it. */
+    auto index = imap_bayes_index_peek (imap->acc);
 
     /* process each token in the list */
     for (current_token = g_list_first(tokens); current_token;
@@ -5526,7 +5943,12 @@ gnc_account_imap_add_account_bayes (GncImportMatchMap *imap,
         auto path = std::string {IMAP_FRAME_BAYES} + '/' + static_cast<char*>(current_token->data) + '/' + guid_string;
         /* change the imap entry for the account */
         change_imap_entry (imap, path, token_count);
+        if (index)
+            imap_bayes_index_add (*index, static_cast<char*>(current_token->data),
+                                  guid_string, token_count);
     }
+    if (index)
+        index->generation = qof_instance_get_slots (QOF_INSTANCE (imap->acc))->generation ();
     /* free up the account fullname and guid string */
     qof_instance_set_dirty (QOF_INSTANCE (imap->acc));
     xaccAccountCommitEdit (imap->acc);
@@ -5673,6 +6095,7 @@ gnc_account_delete_map_entry (Account *acc, char *full_category, gboolean empty)
     if ((acc != NULL) && qof_instance_has_slot (QOF_INSTANCE(acc), kvp_path))
     {
         xaccAccountBeginEdit (acc);
+        imap_bayes_index_invalidate (acc);
         if (empty)
             qof_instance_slot_path_delete_if_empty (QOF_INSTANCE(acc), {kvp_path});
         else
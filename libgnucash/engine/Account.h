@@ -430,6 +430,15 @@ void xaccAccountSortSplits (Account *acc, gboolean force);
  */
 gchar * gnc_account_get_full_name (const Account *account);
 
+/** Return the fully qualified name of the account, like
+ * gnc_account_get_full_name(), without allocating a new string.
+ *
+ * The name is cached in the account and the string belongs to the
+ * engine; it stays valid until the account or one of its ancestors is
+ * renamed or moved, or the separator is changed.  Copy it to keep it.
+ */
+const char * xaccAccountGetFullName (const Account *account);
+
 /** Retrieve the gains account used by this account for the indicated
  * currency, creating and recording a new one if necessary.
  *
@@ -578,7 +587,9 @@ gnc_numeric xaccAccountConvertBalanceToCurrencyAsOfDate(
     gnc_commodity *new_currency, time64 date);
 
 /* These functions get some type of balance in the desired commodity.
-   'report_commodity' may be NULL to use the account's commodity. */
+   'report_commodity' may be NULL to use the account's commodity.
+   Balances including the children are cached per account, so asking
+   again for an unchanged subtree doesn't walk it. */
 gnc_numeric xaccAccountGetBalanceInCurrency (
     const Account *account, const gnc_commodity *report_commodity,
     gboolean include_children);
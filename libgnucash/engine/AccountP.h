@@ -49,6 +49,22 @@ extern "C" {
 
 /** STRUCTS *********************************************************/
 
+/* How many balances an account's balance cache holds at most.  Enough
+ * for the period boundaries of a year's budget besides the tree view's
+ * other columns. */
+#define BALANCE_CACHE_SIZE 32
+
+/* A balance of an account and its descendants, computed by the balance
+ * function fn, converted to commodity and taken at date. */
+typedef struct
+{
+    gpointer fn;
+    const gnc_commodity *commodity;
+    time64 date;
+    gnc_numeric balance;
+    GList *lru;         /* its link in the account's balance_lru */
+} BalanceCacheEntry;
+
 /** This is the data that describes an account.
  *
  * This is the *private* header for the account structure.
@@ -73,6 +89,13 @@ typedef struct AccountPrivate
      */
     char *accountCode;
 
+    /* Cached result of xaccAccountGetFullName, interned in the string
+     * cache.  NULL, or a generation other than the current separator's,
+     * means it has to be rebuilt.
+     */
+    char *full_name;
+    guint full_name_generation;
+
     /* The description is an arbitrary string assigned by the user.
      * It is intended to be a longer, 1-5 sentence description of what
      * this account is all about.
@@ -114,9 +137,26 @@ typedef struct AccountPrivate
 
     gboolean balance_dirty;     /* balances in splits incorrect */
 
+    /* Balances of the account and all of its descendants, keyed by
+     * balance function, report commodity and date.  The least recently
+     * used ones go once there are more than BALANCE_CACHE_SIZE, with
+     * balance_lru holding them most recently used first.  Cleared up
+     * the parent chain whenever a balance changes, and entirely when
+     * the price database's generation moves on.
+     */
+    GHashTable *balance_cache;
+    GQueue balance_lru;
+    guint balance_cache_generation;
+
     GList *splits;              /* list of split pointers */
     gboolean sort_dirty;        /* sort order of splits is bad */
 
+    /* The splits in the order of the list, for finding the balance as
+     * of a date with a binary search.  NULL until it's next needed
+     * after the list changes.
+     */
+    GPtrArray *split_index;
+
     LotList   *lots;		/* list of lot pointers */
     GNCPolicy *policy;		/* Cached pointer to policy method */
 
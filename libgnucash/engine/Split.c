@@ -1485,19 +1485,26 @@ xaccSplitOrder (const Split *sa, const Split *sb)
         retval = xaccTransOrder (sa->parent, sb->parent);
     if (retval) return retval;
 
-    /* otherwise, sort on memo strings */
-    da = sa->memo ? sa->memo : "";
-    db = sb->memo ? sb->memo : "";
-    retval = g_utf8_collate (da, db);
-    if (retval)
-        return retval;
+    /* otherwise, sort on memo strings; cached strings that are the same
+     * pointer are equal, so skip collating those. */
+    if (!CACHE_EQUAL (sa->memo, sb->memo))
+    {
+        da = sa->memo ? sa->memo : "";
+        db = sb->memo ? sb->memo : "";
+        retval = g_utf8_collate (da, db);
+        if (retval)
+            return retval;
+    }
 
     /* otherwise, sort on action strings */
-    da = sa->action ? sa->action : "";
-    db = sb->action ? sb->action : "";
-    retval = g_utf8_collate (da, db);
-    if (retval != 0)
-        return retval;
+    if (!CACHE_EQUAL (sa->action, sb->action))
+    {
+        da = sa->action ? sa->action : "";
+        db = sb->action ? sb->action : "";
+        retval = g_utf8_collate (da, db);
+        if (retval != 0)
+            return retval;
+    }
 
     /* the reconciled flag ... */
     if (sa->reconciled < sb->reconciled) return -1;
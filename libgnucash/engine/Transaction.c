@@ -1901,12 +1901,16 @@ xaccTransOrder_num_action (const Transaction *ta, const char *actna,
     if (ta->date_entered != tb->date_entered)
         return (ta->date_entered > tb->date_entered) - (ta->date_entered < tb->date_entered);
 
-    /* otherwise, sort on description string */
-    da = ta->description ? ta->description : "";
-    db = tb->description ? tb->description : "";
-    retval = g_utf8_collate (da, db);
-    if (retval)
-        return retval;
+    /* otherwise, sort on description string; cached strings that are
+     * the same pointer are equal, so skip collating those. */
+    if (!CACHE_EQUAL (ta->description, tb->description))
+    {
+        da = ta->description ? ta->description : "";
+        db = tb->description ? tb->description : "";
+        retval = g_utf8_collate (da, db);
+        if (retval)
+            return retval;
+    }
 
     /* else, sort on guid - keeps sort stable. */
     return qof_instance_guid_compare(ta, tb);
@@ -115,6 +115,8 @@ gnc_localtime (const time64 *secs)
 struct tm*
 gnc_localtime_r (const time64 *secs, struct tm* time)
 {
+    if (GncDateTime::local_tm(*secs, *time))
+        return time;
     try
     {
         *time = static_cast<struct tm>(GncDateTime(*secs));
@@ -207,6 +209,9 @@ gnc_mktime (struct tm* time)
     try
     {
         normalize_struct_tm (time);
+        time64 secs;
+        if (GncDateTime::local_time64(*time, secs))
+            return secs;
         GncDateTime gncdt(*time);
         *time = static_cast<struct tm>(gncdt);
         return static_cast<time64>(gncdt);
@@ -31,6 +31,7 @@ extern "C"
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/date_time/local_time/local_time.hpp>
 #include <boost/regex.hpp>
+#include <cstring>
 #include <libintl.h>
 #include <map>
 #include <memory>
@@ -181,6 +182,73 @@ LDT_from_struct_tm(const struct tm tm)
     }
 }
 
+/* Calendar arithmetic for the fast local time conversions, after Howard
+ * Hinnant's days_from_civil and civil_from_days.
+ */
+static constexpr time64 secs_per_day = INT64_C(86400);
+
+static time64
+floor_div(time64 num, time64 den) noexcept
+{
+    return num / den - (num % den < 0 ? 1 : 0);
+}
+
+static time64
+days_from_civil(time64 year, unsigned month, unsigned day) noexcept
+{
+    year -= month <= 2;
+    auto era = (year >= 0 ? year : year - 399) / 400;
+    auto yoe = static_cast<unsigned>(year - era * 400);
+    auto doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    auto doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<time64>(doe) - 719468;
+}
+
+static void
+civil_from_days(time64 days, int& year, unsigned& month, unsigned& day) noexcept
+{
+    days += 719468;
+    auto era = (days >= 0 ? days : days - 146096) / 146097;
+    auto doe = static_cast<unsigned>(days - era * 146097);
+    auto yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    auto doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    auto mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = static_cast<int>(static_cast<time64>(yoe) + era * 400 + (month <= 2));
+}
+
+static inline bool
+year_in_table_range(time64 year) noexcept
+{
+    /* Leave the first and last supported years to boost, which throws
+     * for times that spill out of them. */
+    return year > TimeZoneProvider::min_year && year < TimeZoneProvider::max_year;
+}
+
+static void
+fill_local_tm(time64 local, const TZ_Transition& entry, struct tm& tm) noexcept
+{
+    auto days = floor_div(local, secs_per_day);
+    auto secs = static_cast<int>(local - days * secs_per_day);
+    int year;
+    unsigned month, day;
+    civil_from_days(days, year, month, day);
+    memset(&tm, 0, sizeof(tm));
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = day;
+    tm.tm_hour = secs / 3600;
+    tm.tm_min = secs % 3600 / 60;
+    tm.tm_sec = secs % 60;
+    tm.tm_wday = static_cast<int>((days % 7 + 11) % 7); // 1970-01-01 was a Thursday
+    tm.tm_yday = static_cast<int>(days - days_from_civil(year, 1, 1));
+    tm.tm_isdst = entry.is_dst ? 1 : 0;
+#if HAVE_STRUCT_TM_GMTOFF
+    tm.tm_gmtoff = entry.offset;
+#endif
+}
+
 using TD = boost::posix_time::time_duration;
 
 class GncDateTimeImpl
@@ -494,6 +562,65 @@ GncDateTime::format_zulu(const char* format) const
     return m_impl->format_zulu(format);
 }
 
+bool
+GncDateTime::local_tm(time64 time, struct tm& tm) noexcept
+{
+    int year;
+    unsigned month, day;
+    civil_from_days(floor_div(time, secs_per_day), year, month, day);
+    if (!year_in_table_range(year))
+        return false;
+    auto& table = tzp.transitions(year);
+    if (table.empty())
+        return false;
+    auto entry = table.begin();
+    while (entry + 1 != table.end() && (entry + 1)->utc_start <= time)
+        ++entry;
+    fill_local_tm(time + entry->offset, *entry, tm);
+    return true;
+}
+
+bool
+GncDateTime::local_time64(struct tm& tm, time64& time) noexcept
+{
+    auto year = static_cast<time64>(tm.tm_year) + 1900;
+    if (!year_in_table_range(year) || tm.tm_mon < 0 || tm.tm_mon > 11 ||
+        tm.tm_mday < 1 || tm.tm_hour < 0 || tm.tm_hour > 23 ||
+        tm.tm_min < 0 || tm.tm_min > 59 || tm.tm_sec < 0 || tm.tm_sec > 59)
+        return false;
+    auto days = days_from_civil(year, tm.tm_mon + 1, tm.tm_mday);
+    int check_year;
+    unsigned check_month, check_day;
+    civil_from_days(days, check_year, check_month, check_day);
+    if (static_cast<int>(check_day) != tm.tm_mday) // e.g. February 30
+        return false;
+    auto& table = tzp.transitions(year);
+    if (table.empty())
+        return false;
+    auto local = days * secs_per_day + tm.tm_hour * 3600 + tm.tm_min * 60 +
+        tm.tm_sec;
+    /* Staying a day clear of January 1 keeps the UTC year, whose table this
+     * is, the same as the local year boost would use. */
+    auto year_end = days_from_civil(year + 1, 1, 1) * secs_per_day;
+    if (local - table.front().utc_start < secs_per_day ||
+        year_end - local <= secs_per_day)
+        return false;
+    for (auto entry = table.begin(); entry != table.end(); ++entry)
+    {
+        auto utc = local - entry->offset;
+        auto entry_end = entry + 1 == table.end() ? year_end : (entry + 1)->utc_start;
+        if (utc < entry->utc_start || utc >= entry_end)
+            continue;
+        if ((entry != table.begin() && utc - entry->utc_start < secs_per_day) ||
+            (entry + 1 != table.end() && entry_end - utc <= secs_per_day))
+            return false;
+        fill_local_tm(local, *entry, tm);
+        time = utc;
+        return true;
+    }
+    return false;
+}
+
 /* GncDate */
 GncDate::GncDate() : m_impl{new GncDateImpl} {}
 GncDate::GncDate(int year, int month, int day) :
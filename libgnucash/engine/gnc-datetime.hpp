@@ -148,6 +148,24 @@ public:
  *  GMT (timezone Z) according to the format.
  */
     std::string format_zulu(const char* format) const;
+/** Convert a time64 to a struct tm in the current timezone, like
+ *  static_cast<struct tm>(GncDateTime(time)) but from the timezone's
+ *  table of offsets instead of boost::local_time.
+ *  @param time Seconds from the POSIX epoch.
+ *  @param tm The struct tm to fill in.
+ *  @return false if the time isn't covered by the table, in which case
+ *  the caller must construct a GncDateTime.
+ */
+    static bool local_tm(time64 time, struct tm& tm) noexcept;
+/** Convert a struct tm in the current timezone to a time64, like
+ *  static_cast<time64>(GncDateTime(tm)), and normalize tm the same way.
+ *  Times within a day of a DST change or of the year's end are left to
+ *  GncDateTime, which knows how to report the ambiguous and invalid ones.
+ *  @param tm A normalized struct tm.
+ *  @param time Receives the seconds from the POSIX epoch.
+ *  @return false if the caller must construct a GncDateTime instead.
+ */
+    static bool local_time64(struct tm& tm, time64& time) noexcept;
 
 private:
     std::unique_ptr<GncDateTimeImpl> m_impl;
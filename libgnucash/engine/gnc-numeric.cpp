@@ -39,6 +39,7 @@ extern "C"
 #include <boost/regex.hpp>
 #include <boost/locale/encoding_utf.hpp>
 #include <sstream>
+#include <vector>
 #include <cstdlib>
 
 #include "gnc-numeric.hpp"
@@ -652,6 +653,10 @@ gnc_numeric_compare(gnc_numeric a, gnc_numeric b)
 {
     gint64 aa, bb;
 
+    /* A positive denominator is never an error code. */
+    if (G_LIKELY(a.denom == b.denom && a.denom > 0))
+        return (a.num > b.num) - (a.num < b.num);
+
     if (gnc_numeric_check(a) || gnc_numeric_check(b))
     {
         return 0;
@@ -736,6 +741,61 @@ denom_lcd(gnc_numeric a, gnc_numeric b, int64_t denom, int how)
     return denom;
 }
 
+/* Amounts in the same commodity nearly always share a denominator, and
+ * adding or subtracting those can't need any rounding. Do it in plain
+ * int64_t arithmetic, leaving overflow, negative (multiplier) denominators
+ * and the denominator types that might change the result to the rational
+ * code.
+ */
+static inline bool
+int64_add_overflows (int64_t a, int64_t b, int64_t& result)
+{
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5)
+    return __builtin_add_overflow (a, b, &result);
+#else
+    if ((b > 0 && a > INT64_MAX - b) || (b < 0 && a < INT64_MIN - b))
+        return true;
+    result = a + b;
+    return false;
+#endif
+}
+
+static inline bool
+int64_sub_overflows (int64_t a, int64_t b, int64_t& result)
+{
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5)
+    return __builtin_sub_overflow (a, b, &result);
+#else
+    if ((b < 0 && a > INT64_MAX + b) || (b > 0 && a < INT64_MIN + b))
+        return true;
+    result = a - b;
+    return false;
+#endif
+}
+
+static inline bool
+same_denom_fast_path (gnc_numeric a, gnc_numeric b, gint64 denom, gint how)
+{
+    if (a.denom != b.denom || a.denom <= 0)
+        return false;
+    if (denom != GNC_DENOM_AUTO && denom != a.denom)
+        return false;
+    auto dtype = how & GNC_NUMERIC_DENOM_MASK;
+    return dtype != GNC_HOW_DENOM_REDUCE && dtype != GNC_HOW_DENOM_SIGFIG;
+}
+
+/* Like the rational code, make an exact zero with an automatic denominator
+ * 0/1 unless rounding is forbidden. */
+static inline gnc_numeric
+same_denom_result (int64_t num, gint64 num_denom, gint64 denom, gint how)
+{
+    if (num == 0 && denom == GNC_DENOM_AUTO &&
+        (how & GNC_NUMERIC_DENOM_MASK) == GNC_HOW_DENOM_EXACT &&
+        (how & GNC_NUMERIC_RND_MASK) != GNC_HOW_RND_NEVER)
+        return gnc_numeric_create (0, 1);
+    return gnc_numeric_create (num, num_denom);
+}
+
 /* *******************************************************************
  *  gnc_numeric_add
  ********************************************************************/
@@ -744,6 +804,11 @@ gnc_numeric
 gnc_numeric_add(gnc_numeric a, gnc_numeric b,
                 gint64 denom, gint how)
 {
+    int64_t num;
+    if (G_LIKELY(same_denom_fast_path (a, b, denom, how)) &&
+        !int64_add_overflows (a.num, b.num, num) && num != INT64_MIN)
+        return same_denom_result (num, a.denom, denom, how);
+
     if (gnc_numeric_check(a) || gnc_numeric_check(b))
     {
         return gnc_numeric_error(GNC_ERROR_ARG);
@@ -798,6 +863,11 @@ gnc_numeric_sub(gnc_numeric a, gnc_numeric b,
                 gint64 denom, gint how)
 {
     gnc_numeric nb;
+    int64_t num;
+    if (G_LIKELY(same_denom_fast_path (a, b, denom, how)) &&
+        !int64_sub_overflows (a.num, b.num, num) && num != INT64_MIN)
+        return same_denom_result (num, a.denom, denom, how);
+
     if (gnc_numeric_check(a) || gnc_numeric_check(b))
     {
         return gnc_numeric_error(GNC_ERROR_ARG);
@@ -843,6 +913,145 @@ gnc_numeric_sub(gnc_numeric a, gnc_numeric b,
     }
 }
 
+/* *******************************************************************
+ *  gnc_numeric_sum
+ ********************************************************************/
+
+namespace
+{
+/* The numerators with one denominator are added as int64_t and only
+ * folded into the 128-bit total when the next addition would overflow,
+ * so a run of amounts in one commodity costs an integer add apiece. */
+struct DenomSum
+{
+    int64_t denom;
+    int64_t partial;
+    GncInt128 total;
+};
+
+/* Amounts rarely come in more than a few denominators, so the first few
+ * groups are kept on the stack and summing doesn't allocate. */
+static constexpr size_t local_denoms = 4;
+}
+
+static gnc_numeric
+sum_numerics (const gnc_numeric *values, const guint8 *mask, guint8 select,
+              gsize count, gint64 denom, gint how)
+{
+    DenomSum local[local_denoms];
+    size_t n_local = 0;
+    std::vector<DenomSum> more;
+    DenomSum *current = nullptr;
+    try
+    {
+        for (gsize i = 0; i < count; ++i)
+        {
+            if (mask && !(mask[i] & select))
+                continue;
+            auto value = values[i];
+            if (gnc_numeric_check (value))
+                return gnc_numeric_error (GNC_ERROR_ARG);
+            if (value.denom < 0) // A multiplier; GncNumeric applies it.
+                value = static_cast<gnc_numeric>(GncNumeric (value));
+            if (!current || current->denom != value.denom)
+            {
+                current = nullptr;
+                for (size_t j = 0; j < n_local; ++j)
+                    if (local[j].denom == value.denom)
+                        current = &local[j];
+                for (auto& sum : more)
+                    if (sum.denom == value.denom)
+                        current = &sum;
+                if (!current && n_local < local_denoms)
+                {
+                    local[n_local] = {value.denom, 0, GncInt128 (0)};
+                    current = &local[n_local++];
+                }
+                else if (!current)
+                {
+                    more.push_back ({value.denom, 0, GncInt128 (0)});
+                    current = &more.back ();
+                }
+            }
+            int64_t partial;
+            if (int64_add_overflows (current->partial, value.num, partial))
+            {
+                current->total += GncInt128 (current->partial);
+                current->partial = value.num;
+            }
+            else
+                current->partial = partial;
+        }
+
+        GncRational total;
+        for (size_t j = 0; j < n_local; ++j)
+        {
+            local[j].total += GncInt128 (local[j].partial);
+            total = total + GncRational (local[j].total, local[j].denom);
+        }
+        for (auto& sum : more)
+        {
+            sum.total += GncInt128 (sum.partial);
+            total = total + GncRational (sum.total, sum.denom);
+        }
+        if (!total.valid ())
+            return gnc_numeric_error (GNC_ERROR_OVERFLOW);
+
+        if (denom == GNC_DENOM_AUTO &&
+            (how & GNC_NUMERIC_DENOM_MASK) == GNC_HOW_DENOM_LCD)
+            denom = static_cast<int64_t>(total.denom ());
+        if ((how & GNC_NUMERIC_DENOM_MASK) != GNC_HOW_DENOM_EXACT)
+        {
+            GncNumeric sum (total);
+            return static_cast<gnc_numeric>(convert(sum, denom, how));
+        }
+        if (denom == GNC_DENOM_AUTO &&
+            (how & GNC_NUMERIC_RND_MASK) != GNC_HOW_RND_NEVER)
+            return static_cast<gnc_numeric>(total.round_to_numeric());
+        total = convert(total, denom, how);
+        if (total.is_big() || !total.valid())
+            return gnc_numeric_error(GNC_ERROR_OVERFLOW);
+        return static_cast<gnc_numeric>(total);
+    }
+    catch (const std::overflow_error& err)
+    {
+        PWARN("%s", err.what());
+        return gnc_numeric_error(GNC_ERROR_OVERFLOW);
+    }
+    catch (const std::invalid_argument& err)
+    {
+        PWARN("%s", err.what());
+        return gnc_numeric_error(GNC_ERROR_ARG);
+    }
+    catch (const std::underflow_error& err)
+    {
+        PWARN("%s", err.what());
+        return gnc_numeric_error(GNC_ERROR_OVERFLOW);
+    }
+    catch (const std::domain_error& err)
+    {
+        PWARN("%s", err.what());
+        return gnc_numeric_error(GNC_ERROR_REMAINDER);
+    }
+}
+
+gnc_numeric
+gnc_numeric_sum (const gnc_numeric *values, gsize count, gint64 denom,
+                 gint how)
+{
+    g_return_val_if_fail (values || !count, gnc_numeric_error (GNC_ERROR_ARG));
+    return sum_numerics (values, nullptr, 0, count, denom, how);
+}
+
+gnc_numeric
+gnc_numeric_sum_masked (const gnc_numeric *values, const guint8 *mask,
+                        guint8 select, gsize count, gint64 denom, gint how)
+{
+    g_return_val_if_fail ((values && mask) || !count,
+                          gnc_numeric_error (GNC_ERROR_ARG));
+    return sum_numerics (values, mask, select, count, denom, how);
+}
+
 /* *******************************************************************
  *  gnc_numeric_mul
  ********************************************************************/
@@ -397,6 +397,31 @@ gnc_numeric gnc_numeric_add(gnc_numeric a, gnc_numeric b,
 gnc_numeric gnc_numeric_sub(gnc_numeric a, gnc_numeric b,
                             gint64 denom, gint how);
 
+/** Return the sum of an array of values. The values are added exactly,
+ *  grouped by denominator, and the total is converted according to denom
+ *  and how only once, as gnc_numeric_add would convert the sum of two.
+ *  That is faster than adding them one at a time and, when how requires
+ *  rounding, rounds only once. The sum of no values is 0/1.
+ *
+ *  @param values The values to add.
+ *  @param count The number of values.
+ *  @param denom The denominator of the result, or GNC_DENOM_AUTO.
+ *  @param how The rounding and denominator flags as for gnc_numeric_add.
+ *  @return The sum, or an error value if any of the values is one or the
+ *  sum can't be represented.
+ */
+gnc_numeric gnc_numeric_sum(const gnc_numeric *values, gsize count,
+                            gint64 denom, gint how);
+
+/** Like gnc_numeric_sum, but add only the values whose entry in mask has
+ *  any of the bits in select set. This lets one array of flags, for
+ *  example one bit for cleared splits and another for reconciled ones,
+ *  serve several sums over the same values.
+ */
+gnc_numeric gnc_numeric_sum_masked(const gnc_numeric *values,
+                                   const guint8 *mask, guint8 select,
+                                   gsize count, gint64 denom, gint how);
+
 /** Multiply a times b, returning the product.  An overflow
  *  may occur if the result of the multiplication can't
  *  be represented as a ratio of 64-bit int's after removing
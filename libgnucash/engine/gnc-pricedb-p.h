@@ -90,6 +90,11 @@ void     gnc_pricedb_substitute_commodity(GNCPriceDB *db,
         gnc_commodity *old_c,
         gnc_commodity *new_c);
 
+/** A number that changes whenever a price is added to or removed from
+ *  a price database, or modified, including while events are suspended.
+ *  Lets cached price conversions tell when they may be stale. */
+guint gnc_pricedb_get_generation (void);
+
 /** register the pricedb object with the gncObject system */
 gboolean gnc_pricedb_register (void);
 
@@ -34,6 +34,9 @@
 /* This static indicates the debugging module that this .o belongs to.  */
 static QofLogModule log_module = GNC_MOD_PRICE;
 
+/* Moves on whenever a price is added, removed or changed. */
+static guint pricedb_generation = 1;
+
 static gboolean add_price(GNCPriceDB *db, GNCPrice *p);
 static gboolean remove_price(GNCPriceDB *db, GNCPrice *p, gboolean cleanup);
 static GNCPrice *lookup_nearest_in_time(GNCPriceDB *db, const gnc_commodity *c,
@@ -432,6 +435,14 @@ gnc_price_commit_edit (GNCPrice *p)
 
 /* ==================================================================== */
 
+guint
+gnc_pricedb_get_generation (void)
+{
+    return pricedb_generation;
+}
+
+/* ==================================================================== */
+
 void
 gnc_pricedb_begin_edit (GNCPriceDB *pdb)
 {
@@ -452,6 +463,7 @@ static void
 gnc_price_set_dirty (GNCPrice *p)
 {
     qof_instance_set_dirty(&p->inst);
+    pricedb_generation++;
     qof_event_gen(&p->inst, QOF_EVENT_MODIFY, NULL);
 }
 
@@ -1172,6 +1184,7 @@ add_price(GNCPriceDB *db, GNCPrice *p)
 
     g_hash_table_insert(currency_hash, currency, price_list);
     p->db = db;
+    pricedb_generation++;
 
     qof_event_gen (&p->inst, QOF_EVENT_ADD, NULL);
 
@@ -1265,6 +1278,7 @@ remove_price(GNCPriceDB *db, GNCPrice *p, gboolean cleanup)
         LEAVE (" cannot remove price list");
         return FALSE;
     }
+    pricedb_generation++;
 
     /* if the price list is empty, then remove this currency from the
        commodity hash */
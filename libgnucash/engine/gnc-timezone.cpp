@@ -739,3 +739,110 @@ TimeZoneProvider::get(int year) const noexcept
             return zone_vector.front().second;
     return iter->second;
 }
+
+using PTime = boost::posix_time::ptime;
+using LDT = boost::local_time::local_date_time;
+
+static const PTime unix_epoch (boost::gregorian::date(1970, boost::gregorian::Jan, 1),
+                               boost::posix_time::seconds(0));
+
+static int64_t
+to_time64 (const PTime& time)
+{
+    return (time - unix_epoch).total_seconds();
+}
+
+/* The offset and DST flag boost computes for a UTC time in zone. */
+static std::pair<int32_t, bool>
+offset_at (int64_t time, const TZ_Ptr& zone)
+{
+    PTime utc(unix_epoch.date(), boost::posix_time::hours(time / 3600) +
+              boost::posix_time::seconds(time % 3600));
+    LDT ldt(utc, zone);
+    return std::make_pair(static_cast<int32_t>((ldt.local_time() -
+                                                ldt.utc_time()).total_seconds()),
+                          ldt.is_dst());
+}
+
+/* Rather than reimplementing boost's DST rules, which decide by local year
+ * and treat the hours around each change specially, ask boost for the
+ * offset around every place the rules say a change might be and pin down
+ * the second it changes. If boost changes the offset anywhere the rules
+ * didn't predict, the year is left untabulated.
+ */
+TZ_Transitions
+TimeZoneProvider::make_transitions(int year) const
+{
+    constexpr int64_t window = 26 * 3600, step = 3600;
+    auto zone = get(year);
+    auto start = to_time64(PTime(boost::gregorian::date(year, 1, 1)));
+    auto end = to_time64(PTime(boost::gregorian::date(year + 1, 1, 1)));
+    auto current = offset_at(start, zone);
+    TZ_Transitions result {{start, current.first, current.second}};
+
+    if (zone->has_dst())
+    {
+        std::vector<int64_t> guesses;
+        auto base = zone->base_utc_offset().total_seconds();
+        for (auto y = year - 1; y <= year + 1; ++y)
+        {
+            guesses.push_back(to_time64(zone->dst_local_start_time(y)) - base);
+            guesses.push_back(to_time64(zone->dst_local_end_time(y)) - base);
+        }
+        std::sort(guesses.begin(), guesses.end());
+        auto searched = start;
+        for (auto guess : guesses)
+        {
+            auto from = std::max(std::max(guess - window, start), searched);
+            auto to = std::min(guess + window, end - 1);
+            if (from >= to)
+                continue;
+            if (offset_at(from, zone) != current)
+                return {};
+            for (auto time = from; time < to;)
+            {
+                auto next = std::min(time + step, to);
+                if (offset_at(next, zone) == current)
+                {
+                    time = next;
+                    continue;
+                }
+                auto lo = time, hi = next;
+                while (hi - lo > 1)
+                {
+                    auto mid = lo + (hi - lo) / 2;
+                    if (offset_at(mid, zone) == current)
+                        lo = mid;
+                    else
+                        hi = mid;
+                }
+                current = offset_at(hi, zone);
+                result.push_back({hi, current.first, current.second});
+                time = hi;
+            }
+            searched = to;
+        }
+    }
+    if (offset_at(end - 1, zone) != current)
+        return {};
+    return result;
+}
+
+const TZ_Transitions&
+TimeZoneProvider::transitions(int year) const
+{
+    std::lock_guard<std::mutex> lock(transition_mutex);
+    auto iter = transition_cache.find(year);
+    if (iter != transition_cache.end())
+        return iter->second;
+    TZ_Transitions table;
+    try
+    {
+        table = make_transitions(year);
+    }
+    catch(const std::exception& err)
+    {
+        PWARN("Unable to tabulate offsets for %d: %s", year, err.what());
+    }
+    return transition_cache.emplace(year, std::move(table)).first->second;
+}
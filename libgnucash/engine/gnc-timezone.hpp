@@ -32,6 +32,10 @@ extern "C"
 
 #define BOOST_ERROR_CODE_HEADER_ONLY
 #include <boost/date_time/local_time/local_time.hpp>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
 
 namespace gnc
 {
@@ -44,6 +48,17 @@ using TZ_Entry = std::pair<int, TZ_Ptr>;
 using TZ_Vector = std::vector<TZ_Entry>;
 using time_zone_names = boost::local_time::time_zone_names;
 
+/** The UTC offset in effect from utc_start (seconds since the POSIX epoch)
+ * until the next transition.
+ */
+struct TZ_Transition
+{
+    int64_t utc_start;
+    int32_t offset; // seconds east of UTC
+    bool is_dst;
+};
+using TZ_Transitions = std::vector<TZ_Transition>;
+
 class TimeZoneProvider
 {
 public:
@@ -55,12 +70,23 @@ public:
     TimeZoneProvider operator=(const TimeZoneProvider&) = delete;
     TimeZoneProvider operator=(const TimeZoneProvider&&) = delete;
     TZ_Ptr get (int year) const noexcept;
+    /** The offsets in effect during a UTC year, in order, the first one
+     * starting at 00:00 UTC on January 1.  They give exactly the local time
+     * a boost::local_time::local_date_time in get(year) would, without
+     * consulting the zone's rules again. An empty table means the zone
+     * couldn't be tabulated for that year and callers must use get().
+     * Tables are computed on first use and kept.
+     */
+    const TZ_Transitions& transitions (int year) const;
     static const unsigned int min_year; //1400
     static const unsigned int max_year; //9999
 private:
     void parse_file(const std::string& tzname);
     bool construct(const std::string& tzname);
+    TZ_Transitions make_transitions(int year) const;
     TZ_Vector zone_vector;
+    mutable std::map<int, TZ_Transitions> transition_cache;
+    mutable std::mutex transition_mutex;
 #if PLATFORM(WINDOWS)
     void load_windows_dynamic_tz(HKEY, time_zone_names);
     void load_windows_classic_tz(HKEY, time_zone_names);
@@ -56,6 +56,12 @@ extern "C"
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <boost/version.hpp>
+#ifndef G_OS_WIN32
+#include <pthread.h>
+#endif
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 
@@ -148,6 +154,15 @@ guid_replace (GncGUID *guid)
     guid_assign (*guid, temp_random);
 }
 
+void
+guid_replace_many (GncGUID *guids, size_t count)
+{
+    if (!guids) return;
+    static_assert (sizeof (GncGUID) == sizeof (gnc::GUID),
+                   "GncGUID and gnc::GUID must have the same layout");
+    gnc::GUID::create_random (reinterpret_cast<gnc::GUID*> (guids), count);
+}
+
 GncGUID *
 guid_new (void)
 {
@@ -315,11 +330,60 @@ gnc_guid_get_type (void)
 namespace gnc
 {
 
+namespace
+{
+
+/* Each thread has its own generator, so that creating a GUID doesn't take
+ * a lock. Since Boost 1.67 the plain random_generator makes a system call
+ * for every GUID, so there a Mersenne twister seeded from the system's
+ * random source is used instead. A child process forked without exec'ing
+ * would repeat its parent's sequence, so the forking thread's generator
+ * is dropped in the child and seeded afresh on next use.
+ */
+#if BOOST_VERSION >= 106700
+using RandomGenerator = boost::uuids::random_generator_mt19937;
+#else
+using RandomGenerator = boost::uuids::random_generator;
+#endif
+
+static thread_local std::unique_ptr<RandomGenerator> s_generator;
+
+#ifndef G_OS_WIN32
+static void
+drop_generator_in_child (void)
+{
+    s_generator.reset ();
+}
+#endif
+
+static RandomGenerator &
+get_generator (void)
+{
+#ifndef G_OS_WIN32
+    static std::once_flag s_atfork_once;
+    std::call_once (s_atfork_once, [] {
+        pthread_atfork (nullptr, nullptr, drop_generator_in_child);
+    });
+#endif
+    if (!s_generator)
+        s_generator.reset (new RandomGenerator);
+    return *s_generator;
+}
+
+} // namespace
+
 GUID
 GUID::create_random () noexcept
 {
-    static boost::uuids::random_generator gen;
-    return {gen ()};
+    return {get_generator () ()};
+}
+
+void
+GUID::create_random (GUID * guids, size_t count) noexcept
+{
+    auto& gen = get_generator ();
+    for (size_t i = 0; i < count; ++i)
+        guids[i] = GUID {gen ()};
 }
 
 GUID::GUID (boost::uuids::uuid const & other) noexcept
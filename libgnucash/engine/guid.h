@@ -90,6 +90,15 @@ const GncGUID* gnc_value_get_guid (const GValue *value);
  */
 void guid_replace (GncGUID *guid);
 
+/** Generate many new guids at once, for instance when importing or
+ *  loading a large number of objects.
+ *
+ *  @param guids An array of allocated guid data structures. The
+ *  existing values will be replaced with new values.
+ *  @param count The number of guids in the array.
+ */
+void guid_replace_many (GncGUID *guids, size_t count);
+
 /** Generate a new id.
  *
  * @return guid A data structure containing a copy of a newly constructed GncGUID.
@@ -48,6 +48,8 @@ struct GUID
 
     operator GncGUID () const noexcept;
     static GUID create_random () noexcept;
+    /** Fill guids[0..count) with new random GUIDs. */
+    static void create_random (GUID * guids, std::size_t count) noexcept;
     static GUID const & null_guid () noexcept;
     static GUID from_string (std::string const &);
     static bool is_valid_guid (std::string const &);
@@ -45,7 +45,15 @@ static QofLogModule log_module = "qof.kvp";
 
 static const char delim = '/';
 
-KvpFrameImpl::KvpFrameImpl(const KvpFrameImpl & rhs) noexcept
+uint64_t
+KvpFrameImpl::next_generation () noexcept
+{
+    static uint64_t last_generation {0};
+    return ++last_generation;
+}
+
+KvpFrameImpl::KvpFrameImpl(const KvpFrameImpl & rhs) noexcept :
+    m_generation{next_generation()}
 {
     std::for_each(rhs.m_valuemap.begin(), rhs.m_valuemap.end(),
         [this](const map_type::value_type & a)
@@ -115,6 +123,7 @@ KvpFrame::set_impl (std::string const & key, KvpValue * value) noexcept
         auto cachedkey = static_cast <char const *> (qof_string_cache_insert (key.c_str ()));
         m_valuemap.emplace (cachedkey, value);
     }
+    m_generation = next_generation ();
     return ret;
 }
 
@@ -128,7 +137,9 @@ KvpFrameImpl::set (Path path, KvpValue* value) noexcept
     auto target = get_child_frame_or_nullptr (path);
     if (!target)
         return nullptr;
-    return target->set_impl (key, value);
+    auto ret = target->set_impl (key, value);
+    m_generation = next_generation ();
+    return ret;
 }
 
 KvpValue *
@@ -139,23 +150,75 @@ KvpFrameImpl::set_path (Path path, KvpValue* value) noexcept
     auto target = get_child_frame_or_create (path);
     if (!target)
         return nullptr;
-    return target->set_impl (key, value);
+    auto ret = target->set_impl (key, value);
+    m_generation = next_generation ();
+    return ret;
 }
 
-KvpValue *
-KvpFrameImpl::get_slot (Path path) noexcept
+static inline const char*
+key_c_str (const char* key) noexcept
 {
-    auto key = path.back();
-    path.pop_back();
-    auto target = get_child_frame_or_nullptr (path);
-    if (!target)
+    return key;
+}
+
+static inline const char*
+key_c_str (std::string const & key) noexcept
+{
+    return key.c_str ();
+}
+
+template <typename Iter> KvpValue *
+KvpFrameImpl::get_slot_impl (Iter begin, Iter end) const noexcept
+{
+    if (begin == end)
         return nullptr;
-    auto spot = target->m_valuemap.find (key.c_str ());
-    if (spot != target->m_valuemap.end ())
+    auto frame = this;
+    auto last = end - 1;
+    for (auto key = begin; key != last; ++key)
+    {
+        auto spot = frame->m_valuemap.find (key_c_str (*key));
+        if (spot == frame->m_valuemap.end ())
+            return nullptr;
+        frame = spot->second->get <KvpFrame *> ();
+        if (!frame)
+            return nullptr;
+    }
+    auto spot = frame->m_valuemap.find (key_c_str (*last));
+    if (spot != frame->m_valuemap.end ())
         return spot->second;
     return nullptr;
 }
 
+KvpValue *
+KvpFrameImpl::get_slot (Path const & path) const noexcept
+{
+    return get_slot_impl (path.begin (), path.end ());
+}
+
+KvpValue *
+KvpFrameImpl::get_slot (std::initializer_list<const char*> keys) const noexcept
+{
+    return get_slot_impl (keys.begin (), keys.end ());
+}
+
+KvpValue *
+KvpFrameImpl::get_slot (KvpPath const & path) const noexcept
+{
+    return get_slot_impl (path.begin (), path.end ());
+}
+
+KvpPath::KvpPath (std::initializer_list<const char*> keys) :
+    KvpPath (Path (keys.begin (), keys.end ()))
+{
+}
+
+KvpPath::KvpPath (Path const & keys) : m_keys {keys}
+{
+    m_ptrs.reserve (m_keys.size ());
+    for (auto const & key : m_keys)
+        m_ptrs.push_back (key.c_str ());
+}
+
 std::string
 KvpFrameImpl::to_string() const noexcept
 {
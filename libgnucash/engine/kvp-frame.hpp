@@ -88,12 +88,32 @@
 #include <map>
 #include <string>
 #include <vector>
+#include <initializer_list>
 #include <cstring>
+#include <cstdint>
 #include <algorithm>
 #include <iostream>
 using Path = std::vector<std::string>;
 using KvpEntry = std::pair <std::vector <std::string>, KvpValue*>;
 
+/** A path compiled once for repeated lookups with KvpFrameImpl::get_slot.
+ *  Looking it up needs no allocations, so it suits paths that are read in
+ *  loops or on every call of a frequently used function.
+ */
+class KvpPath
+{
+public:
+    KvpPath(std::initializer_list<const char*> keys);
+    explicit KvpPath(Path const & keys);
+    KvpPath(KvpPath const & other) : KvpPath(other.m_keys) {}
+    KvpPath& operator=(KvpPath const &) = delete;
+    const char* const* begin() const noexcept { return m_ptrs.data(); }
+    const char* const* end() const noexcept { return m_ptrs.data() + m_ptrs.size(); }
+private:
+    Path m_keys;
+    std::vector<const char*> m_ptrs;
+};
+
 /** Implements KvpFrame.
  *  It's a struct because QofInstance needs to use the typename to declare a
  *  KvpFrame* member, and QofInstance's API is C until its children are all
@@ -121,7 +141,7 @@ struct KvpFrameImpl
     using map_type = std::map<const char *, KvpValue*, cstring_comparer>;
 
     public:
-    KvpFrameImpl() noexcept {};
+    KvpFrameImpl() noexcept : m_generation{next_generation()} {};
 
     /**
      * Performs a deep copy.
@@ -191,7 +211,18 @@ struct KvpFrameImpl
      * @param path: Path of keys leading to the desired value.
      * @return The value at the key or nullptr.
      */
-    KvpValue* get_slot(Path keys) noexcept;
+    KvpValue* get_slot(Path const & keys) const noexcept;
+    /** Get the value for the tail of the path or nullptr if it doesn't exist,
+     * without allocating. Braced lists of C strings pick this overload.
+     * @param keys: Keys leading to the desired value.
+     * @return The value at the key or nullptr.
+     */
+    KvpValue* get_slot(std::initializer_list<const char*> keys) const noexcept;
+    /** Get the value for a precompiled path or nullptr if it doesn't exist.
+     * @param path: Path of keys leading to the desired value.
+     * @return The value at the key or nullptr.
+     */
+    KvpValue* get_slot(KvpPath const & path) const noexcept;
 
     /** The function should be of the form:
      * <anything> func (char const *, KvpValue *, data_type &);
@@ -224,11 +255,28 @@ struct KvpFrameImpl
      * @return true if the frame contains nothing.
      */
     bool empty() const noexcept { return m_valuemap.empty(); }
+
+    /** Count the slots in the frame itself, not those of any sub-frames.
+     * @return The number of keys in the frame.
+     */
+    std::size_t size() const noexcept { return m_valuemap.size(); }
+
+    /** Report a number that changes whenever a slot is set or removed
+     * through this frame's set functions. No two frames share one, so a cache
+     * built from a frame can tell whether it is still current even if the
+     * frame has been replaced.
+     * @return The frame's current generation.
+     */
+    uint64_t generation() const noexcept { return m_generation; }
     friend int compare(const KvpFrameImpl&, const KvpFrameImpl&) noexcept;
 
     private:
     map_type m_valuemap;
+    uint64_t m_generation;
+
+    static uint64_t next_generation() noexcept;
 
+    template <typename Iter> KvpValue* get_slot_impl(Iter begin, Iter end) const noexcept;
     KvpFrame * get_child_frame_or_nullptr (Path const &) noexcept;
     KvpFrame * get_child_frame_or_create (Path const &) noexcept;
     void flatten_kvp_impl(std::vector <std::string>, std::vector <KvpEntry> &) const noexcept;
@@ -265,6 +265,17 @@ public:
  *   database with it. Implemented only in the XML backend at present.
  */
     virtual void export_coa(QofBook *) {}
+/**
+ *    Report whether another user has changed the stored data since the engine
+ *    last read it.
+ */
+    virtual bool events_pending() { return false; }
+/**
+ *    Bring the engine up to date with the changes reported by
+ *    events_pending().
+ *    @return true if the engine was changed.
+ */
+    virtual bool process_events() { return false; }
 /** Set the error value only if there isn't already an error already.
  */
     void set_error(QofBackendError err);
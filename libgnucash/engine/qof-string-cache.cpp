@@ -37,46 +37,238 @@ extern "C"
 #include "qof.h"
 }
 
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
 /* Uncomment if you need to log anything.
 static QofLogModule log_module = QOF_MOD_UTIL;
 */
 /* =================================================================== */
 /* The QOF string cache                                                */
 /*                                                                     */
-/* The cache is a GHashTable where a copy of the string is the key,    */
-/* and a ref count is the value                                        */
+/* Each cached string is stored once, behind a small header holding    */
+/* its reference count and hash, in blocks carved out of large chunks. */
+/* The blocks are found again through an open-addressed table of       */
+/* pointers to them, so a string costs one block and one table slot    */
+/* instead of a copy, a separately allocated refcount and a hash node. */
 /* =================================================================== */
 
-static GHashTable* qof_string_cache = NULL;
+namespace
+{
+
+struct CacheEntry
+{
+    guint refcount;
+    guint hash;
+    char str[sizeof (CacheEntry*)];
+};
+
+/* Freed blocks are kept on a list per size class for reuse; the link
+ * overlays the string. */
+union FreeBlock
+{
+    CacheEntry entry;
+    struct
+    {
+        guint pad[2];
+        FreeBlock* next;
+    } link;
+};
+
+static constexpr size_t block_granule = 8;
+static constexpr size_t max_pooled_block = 256;
+static constexpr size_t chunk_size = 64 * 1024;
+static constexpr size_t min_table_size = 1024;
+
+class StringPool
+{
+public:
+    StringPool () : m_table (min_table_size, nullptr),
+                    m_free (max_pooled_block / block_granule + 1, nullptr) {}
+    ~StringPool ();
+    char* insert (const char* key);
+    void remove (const char* key);
+private:
+    size_t find_slot (const char* key, guint hash) const noexcept;
+    void grow ();
+    void erase_slot (size_t slot) noexcept;
+    static size_t block_size (size_t length) noexcept;
+    CacheEntry* allocate (size_t size);
+    void release (CacheEntry* entry, size_t size) noexcept;
+
+    std::vector<CacheEntry*> m_table;
+    size_t m_count = 0;
+    std::vector<FreeBlock*> m_free;
+    std::vector<char*> m_chunks;
+    char* m_next = nullptr;
+    char* m_end = nullptr;
+};
+
+StringPool::~StringPool ()
+{
+    for (auto entry : m_table)
+        if (entry && block_size (strlen (entry->str)) > max_pooled_block)
+            g_free (entry);
+    for (auto chunk : m_chunks)
+        g_free (chunk);
+}
 
-static GHashTable*
-qof_get_string_cache(void)
+/* Returns the slot holding key, or the empty slot where it belongs. */
+size_t
+StringPool::find_slot (const char* key, guint hash) const noexcept
 {
-    if (!qof_string_cache)
+    auto mask = m_table.size () - 1;
+    for (auto slot = hash & mask; ; slot = (slot + 1) & mask)
     {
-        qof_string_cache = g_hash_table_new_full(
-                               g_str_hash,               /* hash_func          */
-                               g_str_equal,              /* key_equal_func     */
-                               g_free,                   /* key_destroy_func   */
-                               g_free);                  /* value_destroy_func */
+        auto entry = m_table[slot];
+        if (!entry || (entry->hash == hash && strcmp (entry->str, key) == 0))
+            return slot;
     }
-    return qof_string_cache;
 }
 
 void
-qof_string_cache_init(void)
+StringPool::grow ()
 {
-    (void)qof_get_string_cache();
+    std::vector<CacheEntry*> old (m_table.size () * 2, nullptr);
+    std::swap (old, m_table);
+    auto mask = m_table.size () - 1;
+    for (auto entry : old)
+    {
+        if (!entry)
+            continue;
+        auto slot = entry->hash & mask;
+        while (m_table[slot])
+            slot = (slot + 1) & mask;
+        m_table[slot] = entry;
+    }
 }
 
+/* Linear probing can't just empty a slot: later members of the same run
+ * would become unreachable. Move them back into the gap instead. */
 void
-qof_string_cache_destroy (void)
+StringPool::erase_slot (size_t slot) noexcept
+{
+    auto mask = m_table.size () - 1;
+    auto next = slot;
+    while (true)
+    {
+        next = (next + 1) & mask;
+        auto entry = m_table[next];
+        if (!entry)
+            break;
+        auto home = entry->hash & mask;
+        if ((next > slot && (home <= slot || home > next)) ||
+            (next < slot && home <= slot && home > next))
+        {
+            m_table[slot] = entry;
+            slot = next;
+        }
+    }
+    m_table[slot] = nullptr;
+}
+
+size_t
+StringPool::block_size (size_t length) noexcept
+{
+    auto size = std::max (offsetof (CacheEntry, str) + length + 1, sizeof (FreeBlock));
+    return (size + block_granule - 1) / block_granule * block_granule;
+}
+
+CacheEntry*
+StringPool::allocate (size_t size)
+{
+    if (size > max_pooled_block)
+        return static_cast<CacheEntry*> (g_malloc (size));
+    auto& free_list = m_free[size / block_granule];
+    if (free_list)
+    {
+        auto block = free_list;
+        free_list = block->link.next;
+        return &block->entry;
+    }
+    if (m_end - m_next < static_cast<ptrdiff_t> (size))
+    {
+        m_chunks.push_back (static_cast<char*> (g_malloc (chunk_size)));
+        m_next = m_chunks.back ();
+        m_end = m_next + chunk_size;
+    }
+    auto entry = reinterpret_cast<CacheEntry*> (m_next);
+    m_next += size;
+    return entry;
+}
+
+void
+StringPool::release (CacheEntry* entry, size_t size) noexcept
 {
-    if (qof_string_cache)
+    if (size > max_pooled_block)
     {
-        g_hash_table_destroy(qof_string_cache);
+        g_free (entry);
+        return;
     }
-    qof_string_cache = NULL;
+    auto block = reinterpret_cast<FreeBlock*> (entry);
+    auto& free_list = m_free[size / block_granule];
+    block->link.next = free_list;
+    free_list = block;
+}
+
+char*
+StringPool::insert (const char* key)
+{
+    auto hash = g_str_hash (key);
+    auto slot = find_slot (key, hash);
+    if (m_table[slot])
+    {
+        ++m_table[slot]->refcount;
+        return m_table[slot]->str;
+    }
+    auto length = strlen (key);
+    auto entry = allocate (block_size (length));
+    entry->refcount = 1;
+    entry->hash = hash;
+    memcpy (entry->str, key, length + 1);
+    m_table[slot] = entry;
+    /* Keep the table at most half full so that probe runs stay short. */
+    if (++m_count * 2 > m_table.size ())
+        grow ();
+    return entry->str;
+}
+
+void
+StringPool::remove (const char* key)
+{
+    auto slot = find_slot (key, g_str_hash (key));
+    auto entry = m_table[slot];
+    if (!entry || --entry->refcount)
+        return;
+    erase_slot (slot);
+    --m_count;
+    release (entry, block_size (strlen (entry->str)));
+}
+
+} // namespace
+
+static StringPool* qof_string_pool = nullptr;
+
+static StringPool&
+qof_get_string_pool (void)
+{
+    if (!qof_string_pool)
+        qof_string_pool = new StringPool;
+    return *qof_string_pool;
+}
+
+void
+qof_string_cache_init(void)
+{
+    (void)qof_get_string_pool();
+}
+
+void
+qof_string_cache_destroy (void)
+{
+    delete qof_string_pool;
+    qof_string_pool = nullptr;
 }
 
 /* If the key exists in the cache, check the refcount.  If 1, just
@@ -85,23 +277,7 @@ void
 qof_string_cache_remove(const char * key)
 {
     if (key)
-    {
-        GHashTable* cache = qof_get_string_cache();
-        gpointer value;
-        gpointer cache_key;
-        if (g_hash_table_lookup_extended(cache, key, &cache_key, &value))
-        {
-            guint* refcount = (guint*)value;
-            if (*refcount == 1)
-            {
-                g_hash_table_remove(cache, key);
-            }
-            else
-            {
-                --(*refcount);
-            }
-        }
-    }
+        qof_get_string_pool().remove (key);
 }
 
 /* If the key exists in the cache, increment the refcount.  Otherwise,
@@ -110,25 +286,7 @@ char *
 qof_string_cache_insert(const char * key)
 {
     if (key)
-    {
-        GHashTable* cache = qof_get_string_cache();
-        gpointer value;
-        gpointer cache_key;
-        if (g_hash_table_lookup_extended(cache, key, &cache_key, &value))
-        {
-            guint* refcount = (guint*)value;
-            ++(*refcount);
-            return static_cast <char *> (cache_key);
-        }
-        else
-        {
-            gpointer new_key = g_strdup(static_cast<const char*>(key));
-            guint* refcount = static_cast<unsigned int*>(g_malloc(sizeof(guint)));
-            *refcount = 1;
-            g_hash_table_insert(cache, new_key, refcount);
-            return static_cast <char *> (new_key);
-        }
-    }
+        return qof_get_string_pool().insert (key);
     return NULL;
 }
 
@@ -108,6 +108,11 @@ char * qof_string_cache_replace(const char * dst, const char * src);
 
 #define QOF_CACHE_NEW(void) qof_string_cache_insert("")
 
+/* A string is cached only once, so two cached strings are equal exactly
+ * when they are the same pointer. Both arguments must come from the cache.
+ */
+#define CACHE_EQUAL(a, b) ((a) == (b))
+
 #ifdef __cplusplus
 }
 #endif
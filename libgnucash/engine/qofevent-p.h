@@ -31,7 +31,9 @@
 typedef struct
 {
     QofEventHandler handler;
+    QofEventBatchHandler batch_handler;
     gpointer user_data;
+    QofEventId event_mask;
 
     gint handler_id;
 } HandlerInfo;
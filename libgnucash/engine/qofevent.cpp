@@ -31,54 +31,101 @@ extern "C"
 #include "qof.h"
 #include "qofevent-p.h"
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 /* Static Variables ************************************************/
 static guint   suspend_counter   = 0;
 static gint    next_handler_id   = 1;
 static guint   handler_run_level = 0;
 static guint   pending_deletes   = 0;
 static GList   *handlers  =   NULL;
+/* Handlers registered for one type of entity, by type. */
+static std::unordered_map<std::string, GList*> typed_handlers;
+static GList   *batch_handlers = NULL;
+
+struct GuidHash
+{
+    size_t operator()(const GncGUID& guid) const
+    {
+        return guid_hash_to_guint (&guid);
+    }
+};
+
+struct GuidEqual
+{
+    bool operator()(const GncGUID& a, const GncGUID& b) const
+    {
+        return guid_equal (&a, &b);
+    }
+};
+
+/* The events collected in the current batch. The entries' types are in
+ * the string cache, so they outlive the entities. */
+static guint batch_level = 0;
+static std::vector<QofEventBatchEntry> batch_entries;
+static std::unordered_map<GncGUID, size_t, GuidHash, GuidEqual> batch_index;
 
 /* This static indicates the debugging module that this .o belongs to.  */
 static QofLogModule log_module = QOF_MOD_ENGINE;
 
 /* Implementations *************************************************/
 
+static HandlerInfo *
+find_handler (gint handler_id, GList ***list, GList **node)
+{
+    for (auto n = handlers; n; n = n->next)
+        if (static_cast<HandlerInfo*>(n->data)->handler_id == handler_id)
+        {
+            *list = &handlers;
+            *node = n;
+            return static_cast<HandlerInfo*>(n->data);
+        }
+    for (auto& entry : typed_handlers)
+        for (auto n = entry.second; n; n = n->next)
+            if (static_cast<HandlerInfo*>(n->data)->handler_id == handler_id)
+            {
+                *list = &entry.second;
+                *node = n;
+                return static_cast<HandlerInfo*>(n->data);
+            }
+    for (auto n = batch_handlers; n; n = n->next)
+        if (static_cast<HandlerInfo*>(n->data)->handler_id == handler_id)
+        {
+            *list = &batch_handlers;
+            *node = n;
+            return static_cast<HandlerInfo*>(n->data);
+        }
+    return NULL;
+}
+
 static gint
 find_next_handler_id(void)
 {
-    HandlerInfo *hi;
-    gint handler_id;
+    GList **list;
     GList *node;
+    gint handler_id;
 
     /* look for a free handler id */
     handler_id = next_handler_id;
-    node = handlers;
-
-    while (node)
-    {
-        hi = static_cast<HandlerInfo*>(node->data);
-
-        if (hi->handler_id == handler_id)
-        {
-            handler_id++;
-            node = handlers;
-            continue;
-        }
+    while (find_handler (handler_id, &list, &node))
+        handler_id++;
 
-        node = node->next;
-    }
     /* Update id for next registration */
     next_handler_id = handler_id + 1;
     return handler_id;
 }
 
-gint
-qof_event_register_handler (QofEventHandler handler, gpointer user_data)
+static gint
+register_handler (QofEventHandler handler, gpointer user_data,
+                  QofIdTypeConst type, QofEventId event_mask)
 {
     HandlerInfo *hi;
     gint handler_id;
 
-    ENTER ("(handler=%p, data=%p)", handler, user_data);
+    ENTER ("(handler=%p, data=%p, type=%s, mask=%x)", handler, user_data,
+           type ? type : "(all)", event_mask);
 
     /* sanity check */
     if (!handler)
@@ -95,53 +142,97 @@ qof_event_register_handler (QofEventHandler handler, gpointer user_data)
 
     hi->handler = handler;
     hi->user_data = user_data;
+    hi->event_mask = event_mask;
     hi->handler_id = handler_id;
 
-    handlers = g_list_prepend (handlers, hi);
+    if (type)
+    {
+        auto& list = typed_handlers[type];
+        list = g_list_prepend (list, hi);
+    }
+    else
+        handlers = g_list_prepend (handlers, hi);
     LEAVE ("(handler=%p, data=%p) handler_id=%d", handler, user_data, handler_id);
     return handler_id;
 }
 
-void
-qof_event_unregister_handler (gint handler_id)
+gint
+qof_event_register_handler (QofEventHandler handler, gpointer user_data)
 {
-    GList *node;
+    return register_handler (handler, user_data, NULL, ~QOF_EVENT_NONE);
+}
 
-    ENTER ("(handler_id=%d)", handler_id);
-    for (node = handlers; node; node = node->next)
-    {
-        HandlerInfo *hi = static_cast<HandlerInfo*>(node->data);
+gint
+qof_event_register_typed_handler (QofEventHandler handler, gpointer user_data,
+                                  QofIdTypeConst type, QofEventId event_mask)
+{
+    g_return_val_if_fail (type, 0);
+    return register_handler (handler, user_data, type, event_mask);
+}
 
-        if (hi->handler_id != handler_id)
-            continue;
+gint
+qof_event_register_batch_handler (QofEventBatchHandler handler,
+                                  gpointer user_data)
+{
+    HandlerInfo *hi;
 
-        /* Normally, we could actually remove the handler's node from the
-           list, but we may be unregistering the event handler as a result
-           of a generated event, such as QOF_EVENT_DESTROY.  In that case,
-           we're in the middle of walking the GList and it is wrong to
-           modify the list. So, instead, we just NULL the handler. */
-        if (hi->handler)
-            LEAVE ("(handler_id=%d) handler=%p data=%p", handler_id,
-                   hi->handler, hi->user_data);
+    ENTER ("(handler=%p, data=%p)", handler, user_data);
+    if (!handler)
+    {
+        PERR ("no handler specified");
+        return 0;
+    }
 
-        /* safety -- clear the handler in case we're running events now */
-        hi->handler = NULL;
+    hi = g_new0 (HandlerInfo, 1);
+    hi->batch_handler = handler;
+    hi->user_data = user_data;
+    hi->handler_id = find_next_handler_id();
 
-        if (handler_run_level == 0)
-        {
-            handlers = g_list_remove_link (handlers, node);
-            g_list_free_1 (node);
-            g_free (hi);
-        }
-        else
-        {
-            pending_deletes++;
-        }
+    batch_handlers = g_list_prepend (batch_handlers, hi);
+    LEAVE ("(handler=%p, data=%p) handler_id=%d", handler, user_data,
+           hi->handler_id);
+    return hi->handler_id;
+}
+
+void
+qof_event_unregister_handler (gint handler_id)
+{
+    GList **list;
+    GList *node;
+    HandlerInfo *hi;
 
+    ENTER ("(handler_id=%d)", handler_id);
+    hi = find_handler (handler_id, &list, &node);
+    if (!hi)
+    {
+        PERR ("no such handler: %d", handler_id);
         return;
     }
 
-    PERR ("no such handler: %d", handler_id);
+    /* Normally, we could actually remove the handler's node from the
+       list, but we may be unregistering the event handler as a result
+       of a generated event, such as QOF_EVENT_DESTROY.  In that case,
+       we're in the middle of walking the GList and it is wrong to
+       modify the list. So, instead, we just NULL the handler. */
+    if (hi->handler || hi->batch_handler)
+        LEAVE ("(handler_id=%d) handler=%p data=%p", handler_id,
+               hi->handler ? (gpointer)hi->handler : (gpointer)hi->batch_handler,
+               hi->user_data);
+
+    /* safety -- clear the handler in case we're running events now */
+    hi->handler = NULL;
+    hi->batch_handler = NULL;
+
+    if (handler_run_level == 0)
+    {
+        *list = g_list_remove_link (*list, node);
+        g_list_free_1 (node);
+        g_free (hi);
+    }
+    else
+    {
+        pending_deletes++;
+    }
 }
 
 void
@@ -168,12 +259,103 @@ qof_event_resume (void)
 }
 
 static void
-qof_event_generate_internal (QofInstance *entity, QofEventId event_id,
-                             gpointer event_data)
+run_handlers (GList *list, QofInstance *entity, QofEventId event_id,
+              gpointer event_data)
+{
+    GList *node;
+    GList *next_node = NULL;
+
+    for (node = list; node; node = next_node)
+    {
+        HandlerInfo *hi = static_cast<HandlerInfo*>(node->data);
+
+        next_node = node->next;
+        if (hi->handler && (hi->event_mask & event_id))
+        {
+            PINFO("id=%d hi=%p han=%p data=%p", hi->handler_id, hi,
+                  hi->handler, event_data);
+            hi->handler (entity, event_id, hi->user_data, event_data);
+        }
+    }
+}
+
+static void
+remove_cleared_handlers (GList **list)
+{
+    GList *node;
+    GList *next_node = NULL;
+
+    for (node = *list; node; node = next_node)
+    {
+        HandlerInfo *hi = static_cast<HandlerInfo*>(node->data);
+        next_node = node->next;
+        if (hi->handler == NULL && hi->batch_handler == NULL)
+        {
+            /* remove this node from the list, then free this node */
+            *list = g_list_remove_link (*list, node);
+            g_list_free_1 (node);
+            g_free (hi);
+        }
+    }
+}
+
+/* If we're the outermost event runner and we have pending deletes
+ * then go delete the handlers now.
+ */
+static void
+remove_pending_deletes (void)
+{
+    if (handler_run_level || !pending_deletes)
+        return;
+
+    remove_cleared_handlers (&handlers);
+    for (auto& entry : typed_handlers)
+        remove_cleared_handlers (&entry.second);
+    remove_cleared_handlers (&batch_handlers);
+    pending_deletes = 0;
+}
+
+static void
+run_batch_handlers (const QofEventBatchEntry *entries, guint n_entries)
 {
     GList *node;
     GList *next_node = NULL;
 
+    handler_run_level++;
+    for (node = batch_handlers; node; node = next_node)
+    {
+        HandlerInfo *hi = static_cast<HandlerInfo*>(node->data);
+
+        next_node = node->next;
+        if (hi->batch_handler)
+        {
+            PINFO("id=%d hi=%p han=%p entries=%u", hi->handler_id, hi,
+                  hi->batch_handler, n_entries);
+            hi->batch_handler (entries, n_entries, hi->user_data);
+        }
+    }
+    handler_run_level--;
+    remove_pending_deletes ();
+}
+
+static void
+add_to_batch (QofInstance *entity, QofEventId event_id)
+{
+    auto guid = qof_instance_get_guid (entity);
+    auto found = batch_index.find (*guid);
+    if (found != batch_index.end ())
+    {
+        batch_entries[found->second].event_mask |= event_id;
+        return;
+    }
+    batch_index.emplace (*guid, batch_entries.size ());
+    batch_entries.push_back ({*guid, CACHE_INSERT (entity->e_type), event_id});
+}
+
+static void
+qof_event_generate_internal (QofInstance *entity, QofEventId event_id,
+                             gpointer event_data)
+{
     g_return_if_fail(entity);
 
     switch (event_id)
@@ -186,39 +368,56 @@ qof_event_generate_internal (QofInstance *entity, QofEventId event_id,
     }
 
     handler_run_level++;
-    for (node = handlers; node; node = next_node)
+    run_handlers (handlers, entity, event_id, event_data);
+    if (entity->e_type && !typed_handlers.empty ())
     {
-        HandlerInfo *hi = static_cast<HandlerInfo*>(node->data);
-
-        next_node = node->next;
-        if (hi->handler)
-        {
-            PINFO("id=%d hi=%p han=%p data=%p", hi->handler_id, hi,
-                  hi->handler, event_data);
-            hi->handler (entity, event_id, hi->user_data, event_data);
-        }
+        auto typed = typed_handlers.find (entity->e_type);
+        if (typed != typed_handlers.end ())
+            run_handlers (typed->second, entity, event_id, event_data);
     }
     handler_run_level--;
+    remove_pending_deletes ();
 
-    /* If we're the outermost event runner and we have pending deletes
-     * then go delete the handlers now.
-     */
-    if (handler_run_level == 0 && pending_deletes)
+    if (!batch_handlers)
+        return;
+    if (batch_level)
     {
-        for (node = handlers; node; node = next_node)
-        {
-            HandlerInfo *hi = static_cast<HandlerInfo*>(node->data);
-            next_node = node->next;
-            if (hi->handler == NULL)
-            {
-                /* remove this node from the list, then free this node */
-                handlers = g_list_remove_link (handlers, node);
-                g_list_free_1 (node);
-                g_free (hi);
-            }
-        }
-        pending_deletes = 0;
+        add_to_batch (entity, event_id);
+        return;
+    }
+    QofEventBatchEntry entry {*qof_instance_get_guid (entity), entity->e_type,
+                              event_id};
+    run_batch_handlers (&entry, 1);
+}
+
+void
+qof_event_begin_batch (void)
+{
+    batch_level++;
+}
+
+void
+qof_event_end_batch (void)
+{
+    if (batch_level == 0)
+    {
+        PERR ("batch level underflow");
+        return;
     }
+
+    if (--batch_level || batch_entries.empty ())
+        return;
+
+    /* Events generated by the batch handlers are delivered on their own,
+     * so take the entries out of the batch before running them. */
+    std::vector<QofEventBatchEntry> entries;
+    entries.swap (batch_entries);
+    batch_index.clear ();
+    ENTER ("(entries=%" G_GSIZE_FORMAT ")", entries.size ());
+    run_batch_handlers (entries.data (), entries.size ());
+    for (auto& entry : entries)
+        CACHE_REMOVE (entry.type);
+    LEAVE (" ");
 }
 
 void
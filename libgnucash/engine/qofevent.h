@@ -98,6 +98,67 @@ typedef void (*QofEventHandler) (QofInstance *ent,  QofEventId event_type,
  */
 gint qof_event_register_handler (QofEventHandler handler, gpointer handler_data);
 
+/** \brief Register a handler for some events on one type of entity.
+ *
+ * The handler is only invoked for events on entities whose e_type is
+ * type and whose event id has a bit in common with event_mask. Handlers
+ * registered this way are kept in a table by type, so an event costs
+ * them nothing unless it is on an entity of their type. They are invoked
+ * after the handlers registered with qof_event_register_handler().
+ *
+ * @param handler:   handler to register
+ * @param handler_data: data provided when handler is invoked
+ * @param type: the type of entity, e.g. GNC_ID_ACCOUNT
+ * @param event_mask: the events to handle, e.g.
+ * QOF_EVENT_MODIFY | QOF_EVENT_DESTROY
+ *
+ * @return id identifying handler, for qof_event_unregister_handler()
+ */
+gint qof_event_register_typed_handler (QofEventHandler handler,
+                                       gpointer handler_data,
+                                       QofIdTypeConst type,
+                                       QofEventId event_mask);
+
+/** \brief The events on one entity during a batch.
+ *
+ * The entity may have been destroyed by the time the batch is delivered,
+ * so it is identified by its GncGUID and type rather than by pointer.
+ */
+typedef struct
+{
+    GncGUID guid;
+    QofIdTypeConst type;
+    QofEventId event_mask;
+} QofEventBatchEntry;
+
+/** \brief Handler invoked with a batch of events.
+ *
+ * @param entries: one entry per entity, in the order of their first event,
+ * with the ids of all of the entity's events or'ed together.
+ * @param n_entries: the number of entries.
+ * @param handler_data: data supplied when handler was registered.
+ */
+typedef void (*QofEventBatchHandler) (const QofEventBatchEntry *entries,
+                                      guint n_entries,
+                                      gpointer handler_data);
+
+/** \brief Register a handler for batches of events.
+ *
+ * Between qof_event_begin_batch() and the matching qof_event_end_batch()
+ * events are collected for batch handlers and delivered to them together
+ * when the batch ends, once per entity. Outside a batch each event is
+ * delivered to them as soon as it is generated, as a batch of one.
+ * Handlers registered with qof_event_register_handler() get every event
+ * as it happens, batch or no batch.
+ *
+ * @param handler:   handler to register
+ * @param handler_data: data provided when handler is invoked
+ *
+ * @return id identifying handler, for qof_event_unregister_handler()
+ */
+gint qof_event_register_batch_handler (QofEventBatchHandler handler,
+                                       gpointer handler_data);
+
 /** \brief Unregister an event handler.
  *
  * @param handler_id: the id of the handler to unregister
@@ -139,6 +200,18 @@ void qof_event_suspend (void);
 /** Resume engine event generation. */
 void qof_event_resume (void);
 
+/** \brief Start collecting events for batch handlers.
+ *
+ * Bulk operations call this before changing many entities and
+ * qof_event_end_batch() afterwards, so that batch handlers see each
+ * changed entity once. Batches may be nested; the events are delivered
+ * when the outermost one ends.
+ */
+void qof_event_begin_batch (void);
+
+/** End a batch started with qof_event_begin_batch(). */
+void qof_event_end_batch (void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -33,14 +33,140 @@ extern "C"
 #include "qofid-p.h"
 #include "qofinstance-p.h"
 
+#include <cstdint>
+#include <vector>
+
 static QofLogModule log_module = QOF_MOD_ENGINE;
 
+namespace
+{
+
+/* The entities of a collection, in an open-addressed table keyed by a copy
+ * of their GncGUID. GUIDs are mostly random already, so hashing them is
+ * just folding the two halves together; the multiplication is for the ones
+ * that aren't, like sequential GUIDs made up in tests. Removal shifts the
+ * rest of a probe run back instead of leaving tombstones, so lookups never
+ * probe past deleted entries.
+ */
+class GuidMap
+{
+public:
+    GuidMap () : m_slots (min_slots) {}
+    QofInstance* lookup (const GncGUID* guid) const noexcept
+    {
+        return m_slots[find_slot (*guid)].ent;
+    }
+    void insert (const GncGUID* guid, QofInstance* ent)
+    {
+        auto slot = find_slot (*guid);
+        if (!m_slots[slot].ent)
+        {
+            if ((m_count + 1) * 4 > m_slots.size () * 3)
+            {
+                rehash (m_slots.size () * 2);
+                slot = find_slot (*guid);
+            }
+            ++m_count;
+            m_slots[slot].guid = *guid;
+        }
+        m_slots[slot].ent = ent;
+    }
+    void remove (const GncGUID* guid) noexcept
+    {
+        auto slot = find_slot (*guid);
+        if (!m_slots[slot].ent)
+            return;
+        auto mask = m_slots.size () - 1;
+        auto next = slot;
+        while (true)
+        {
+            next = (next + 1) & mask;
+            if (!m_slots[next].ent)
+                break;
+            auto home = hash (m_slots[next].guid) & mask;
+            if ((next > slot && (home <= slot || home > next)) ||
+                (next < slot && home <= slot && home > next))
+            {
+                m_slots[slot] = m_slots[next];
+                slot = next;
+            }
+        }
+        m_slots[slot].ent = nullptr;
+        --m_count;
+    }
+    void reserve (size_t count)
+    {
+        auto size = m_slots.size ();
+        while (count * 4 > size * 3)
+            size *= 2;
+        if (size != m_slots.size ())
+            rehash (size);
+    }
+    size_t size () const noexcept { return m_count; }
+    std::vector<QofInstance*> values () const
+    {
+        std::vector<QofInstance*> ret;
+        ret.reserve (m_count);
+        for (auto const& entry : m_slots)
+            if (entry.ent)
+                ret.push_back (entry.ent);
+        return ret;
+    }
+private:
+    struct Entry
+    {
+        GncGUID guid;
+        QofInstance* ent = nullptr;
+    };
+    static constexpr size_t min_slots = 16;
+
+    static size_t hash (const GncGUID& guid) noexcept
+    {
+        uint64_t lo, hi;
+        memcpy (&lo, guid.reserved, sizeof lo);
+        memcpy (&hi, guid.reserved + sizeof lo, sizeof hi);
+        auto h = (lo ^ hi) * UINT64_C (0x9e3779b97f4a7c15);
+        return static_cast<size_t> (h ^ (h >> 32));
+    }
+    /* Returns the slot holding guid, or the empty slot where it belongs. */
+    size_t find_slot (const GncGUID& guid) const noexcept
+    {
+        auto mask = m_slots.size () - 1;
+        for (auto slot = hash (guid) & mask; ; slot = (slot + 1) & mask)
+        {
+            auto const& entry = m_slots[slot];
+            if (!entry.ent || guid_equal (&entry.guid, &guid))
+                return slot;
+        }
+    }
+    void rehash (size_t size)
+    {
+        std::vector<Entry> old (size);
+        std::swap (old, m_slots);
+        auto mask = size - 1;
+        for (auto const& entry : old)
+        {
+            if (!entry.ent)
+                continue;
+            auto slot = hash (entry.guid) & mask;
+            while (m_slots[slot].ent)
+                slot = (slot + 1) & mask;
+            m_slots[slot] = entry;
+        }
+    }
+
+    std::vector<Entry> m_slots;
+    size_t m_count = 0;
+};
+
+} // namespace
+
 struct QofCollection_s
 {
     QofIdType    e_type;
     gboolean     is_dirty;
 
-    GHashTable * hash_of_entities;
+    GuidMap      entities;
     gpointer     data;       /* place where object class can hang arbitrary data */
 };
 
@@ -50,9 +176,9 @@ QofCollection *
 qof_collection_new (QofIdType type)
 {
     QofCollection *col;
-    col = g_new0(QofCollection, 1);
+    col = new QofCollection;
     col->e_type = static_cast<QofIdType>(CACHE_INSERT (type));
-    col->hash_of_entities = guid_hash_table_new();
+    col->is_dirty = FALSE;
     col->data = NULL;
     return col;
 }
@@ -61,11 +187,9 @@ void
 qof_collection_destroy (QofCollection *col)
 {
     CACHE_REMOVE (col->e_type);
-    g_hash_table_destroy(col->hash_of_entities);
     col->e_type = NULL;
-    col->hash_of_entities = NULL;
     col->data = NULL;   /** XXX there should be a destroy notifier for this */
-    g_free (col);
+    delete col;
 }
 
 /* =============================================================== */
@@ -89,7 +213,7 @@ qof_collection_remove_entity (QofInstance *ent)
     col = qof_instance_get_collection(ent);
     if (!col) return;
     guid = qof_instance_get_guid(ent);
-    g_hash_table_remove (col->hash_of_entities, guid);
+    col->entities.remove (guid);
     qof_instance_set_collection(ent, NULL);
 }
 
@@ -103,7 +227,7 @@ qof_collection_insert_entity (QofCollection *col, QofInstance *ent)
     if (guid_equal(guid, guid_null())) return;
     g_return_if_fail (col->e_type == ent->e_type);
     qof_collection_remove_entity (ent);
-    g_hash_table_insert (col->hash_of_entities, (gpointer)guid, ent);
+    col->entities.insert (guid, ent);
     qof_instance_set_collection(ent, col);
 }
 
@@ -129,7 +253,7 @@ qof_collection_add_entity (QofCollection *coll, QofInstance *ent)
     {
         return FALSE;
     }
-    g_hash_table_insert (coll->hash_of_entities, (gpointer)guid, ent);
+    coll->entities.insert (guid, ent);
     return TRUE;
 }
 
@@ -216,8 +340,7 @@ qof_collection_lookup_entity (const QofCollection *col, const GncGUID * guid)
     QofInstance *ent;
     g_return_val_if_fail (col, NULL);
     if (guid == NULL) return NULL;
-    ent = static_cast<QofInstance*>(g_hash_table_lookup (col->hash_of_entities,
-							 guid));
+    ent = col->entities.lookup (guid);
     return ent;
 }
 
@@ -245,10 +368,17 @@ qof_collection_count (const QofCollection *col)
 {
     guint c;
 
-    c = g_hash_table_size(col->hash_of_entities);
+    c = col->entities.size ();
     return c;
 }
 
+void
+qof_collection_reserve (QofCollection *col, guint count)
+{
+    g_return_if_fail (col);
+    col->entities.reserve (count);
+}
+
 /* =============================================================== */
 
 gboolean
@@ -302,40 +432,21 @@ qof_collection_set_data (QofCollection *col, gpointer user_data)
 
 /* =============================================================== */
 
-struct _iterate
-{
-    QofInstanceForeachCB      fcn;
-    gpointer                data;
-};
-
-static void
-foreach_cb (gpointer item, gpointer arg)
-{
-    struct _iterate *iter = static_cast<_iterate*>(arg);
-    QofInstance *ent = static_cast<QofInstance*>(item);
-
-    iter->fcn (ent, iter->data);
-}
-
 void
 qof_collection_foreach (const QofCollection *col, QofInstanceForeachCB cb_func,
                         gpointer user_data)
 {
-    struct _iterate iter;
-    GList *entries;
-
     g_return_if_fail (col);
     g_return_if_fail (cb_func);
 
-    iter.fcn = cb_func;
-    iter.data = user_data;
-
-    PINFO("Hash Table size of %s before is %d", col->e_type, g_hash_table_size(col->hash_of_entities));
+    PINFO("Hash Table size of %s before is %" G_GSIZE_FORMAT, col->e_type,
+          col->entities.size ());
 
-    entries = g_hash_table_get_values (col->hash_of_entities);
-    g_list_foreach (entries, foreach_cb, &iter);
-    g_list_free (entries);
+    /* Iterate over a copy; the callback may add or remove entities. */
+    for (auto ent : col->entities.values ())
+        cb_func (ent, user_data);
 
-    PINFO("Hash Table size of %s after is %d", col->e_type, g_hash_table_size(col->hash_of_entities));
+    PINFO("Hash Table size of %s after is %" G_GSIZE_FORMAT, col->e_type,
+          col->entities.size ());
 }
 /* =============================================================== */
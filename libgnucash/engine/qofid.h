@@ -140,7 +140,7 @@ print error message if its bad  */
 
 @param e_type QofIdType
 @param is_dirty gboolean
-@param hash_of_entities GHashTable
+@param entities table of the entities keyed by GncGUID
 @param data gpointer, place where object class can hang arbitrary data
 
 */
@@ -154,6 +154,14 @@ QofCollection * qof_collection_new (QofIdType type);
 /** return the number of entities in the collection. */
 guint qof_collection_count (const QofCollection *col);
 
+/** Make room for count entities in the collection, so that loading a
+ * known number of them doesn't have to grow the table repeatedly. Backends
+ * should call it with the number of rows or elements they're about to
+ * load, plus whatever the collection already holds. The collection never
+ * shrinks, so an overestimate only costs memory.
+ */
+void qof_collection_reserve (QofCollection *col, guint count);
+
 /** destroy the collection */
 void qof_collection_destroy (QofCollection *col);
 
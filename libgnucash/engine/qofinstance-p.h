@@ -163,6 +163,15 @@ void qof_instance_foreach_slot (const QofInstance *inst, const char *path,
 
 void qof_instance_get_path_kvp (QofInstance *, GValue *, std::vector<std::string> const &);
 
+void qof_instance_get_path_kvp (QofInstance *, GValue *, std::initializer_list<char const *>);
+
+/** Returns the KvpValue at path or nullptr, without copying it into a GValue
+ * and without allocating. The value still belongs to the instance.
+ */
+KvpValue* qof_instance_get_path_kvp_value (QofInstance const *, std::initializer_list<char const *>);
+
+KvpValue* qof_instance_get_path_kvp_value (QofInstance const *, KvpPath const &);
+
 void qof_instance_set_path_kvp (QofInstance *, GValue const *, std::vector<std::string> const &);
 
 bool qof_instance_has_path_slot (QofInstance const *, std::vector<std::string> const &);
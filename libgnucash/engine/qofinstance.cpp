@@ -34,8 +34,12 @@ extern "C"
 {
 #include <config.h>
 #include <glib.h>
+#ifndef G_OS_WIN32
+#include <pthread.h>
+#endif
 }
 
+#include <mutex>
 #include <utility>
 #include "qof.h"
 #include "qofbook-p.h"
@@ -272,6 +276,46 @@ qof_instance_init (QofInstance *inst)
     priv->infant = TRUE;
 }
 
+/* Instances are created by the thousand when a book is loaded or a file
+ * imported, so their GUIDs are made a batch at a time into a pool per
+ * thread. A forked child mustn't hand out what's left of its parent's
+ * pool, so the forking thread's pool is emptied in the child.
+ */
+#define GUID_POOL_SIZE 64
+
+typedef struct
+{
+    GncGUID guids[GUID_POOL_SIZE];
+    size_t available;
+} GuidPool;
+
+static thread_local GuidPool guid_pool;
+
+#ifndef G_OS_WIN32
+static void
+empty_guid_pool_in_child (void)
+{
+    guid_pool.available = 0;
+}
+#endif
+
+static void
+guid_pool_take (GncGUID *guid)
+{
+#ifndef G_OS_WIN32
+    static std::once_flag atfork_once;
+    std::call_once (atfork_once, [] {
+        pthread_atfork (nullptr, nullptr, empty_guid_pool_in_child);
+    });
+#endif
+    if (!guid_pool.available)
+    {
+        guid_replace_many (guid_pool.guids, GUID_POOL_SIZE);
+        guid_pool.available = GUID_POOL_SIZE;
+    }
+    *guid = guid_pool.guids[--guid_pool.available];
+}
+
 void
 qof_instance_init_data (QofInstance *inst, QofIdType type, QofBook *book)
 {
@@ -301,7 +345,7 @@ qof_instance_init_data (QofInstance *inst, QofIdType type, QofBook *book)
 
     do
     {
-        guid_replace(&priv->guid);
+        guid_pool_take(&priv->guid);
 
         if (NULL == qof_collection_lookup_entity (col, &priv->guid))
             break;
@@ -1077,9 +1121,10 @@ qof_instance_set_kvp (QofInstance * inst, GValue const * value, unsigned count,
     delete inst->kvp_data->set_path (path, kvp_value_from_gvalue (value));
 }
 
-void qof_instance_get_path_kvp (QofInstance * inst, GValue * value, std::vector<std::string> const & path)
+static void
+gvalue_set_from_kvp_value (GValue *value, KvpValue *kval)
 {
-    auto temp = gvalue_from_kvp_value (inst->kvp_data->get_slot (path));
+    auto temp = gvalue_from_kvp_value (kval);
     if (G_IS_VALUE (temp))
     {
         if (G_IS_VALUE (value))
@@ -1090,6 +1135,28 @@ void qof_instance_get_path_kvp (QofInstance * inst, GValue * value, std::vector<
     }
 }
 
+void qof_instance_get_path_kvp (QofInstance * inst, GValue * value, std::vector<std::string> const & path)
+{
+    gvalue_set_from_kvp_value (value, inst->kvp_data->get_slot (path));
+}
+
+void qof_instance_get_path_kvp (QofInstance * inst, GValue * value, std::initializer_list<char const *> path)
+{
+    gvalue_set_from_kvp_value (value, inst->kvp_data->get_slot (path));
+}
+
+KvpValue*
+qof_instance_get_path_kvp_value (QofInstance const * inst, std::initializer_list<char const *> path)
+{
+    return inst->kvp_data->get_slot (path);
+}
+
+KvpValue*
+qof_instance_get_path_kvp_value (QofInstance const * inst, KvpPath const & path)
+{
+    return inst->kvp_data->get_slot (path);
+}
+
 void
 qof_instance_get_kvp (QofInstance * inst, GValue * value, unsigned count, ...)
 {
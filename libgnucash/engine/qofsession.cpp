@@ -528,13 +528,17 @@ QofSessionImpl::swap_books (QofSessionImpl & other) noexcept
 bool
 QofSessionImpl::events_pending () const noexcept
 {
-    return false;
+    auto backend = qof_book_get_backend (m_book);
+    if (!backend) return false;
+    return backend->events_pending ();
 }
 
 bool
 QofSessionImpl::process_events () const noexcept
 {
-    return false;
+    auto backend = qof_book_get_backend (m_book);
+    if (!backend) return false;
+    return backend->process_events ();
 }
 
 /* XXX This exports the list of accounts to a file.  It does not
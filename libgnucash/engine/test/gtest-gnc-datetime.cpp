@@ -23,7 +23,10 @@
 \********************************************************************/
 
 #include "../gnc-datetime.hpp"
+#include "../gnc-timezone.hpp"
 #include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
 
 TEST(gnc_date_constructors, test_default_constructor)
 {
@@ -407,3 +410,92 @@ TEST(gnc_datetime_functions, test_timezone_offset)
     EXPECT_EQ(-25200, gncdt3.offset());
 }
 */
+
+static void
+expect_same_tm(const struct tm& expected, const struct tm& actual, time64 time)
+{
+    EXPECT_EQ(expected.tm_year, actual.tm_year) << "at " << time;
+    EXPECT_EQ(expected.tm_mon, actual.tm_mon) << "at " << time;
+    EXPECT_EQ(expected.tm_mday, actual.tm_mday) << "at " << time;
+    EXPECT_EQ(expected.tm_hour, actual.tm_hour) << "at " << time;
+    EXPECT_EQ(expected.tm_min, actual.tm_min) << "at " << time;
+    EXPECT_EQ(expected.tm_sec, actual.tm_sec) << "at " << time;
+    EXPECT_EQ(expected.tm_wday, actual.tm_wday) << "at " << time;
+    EXPECT_EQ(expected.tm_yday, actual.tm_yday) << "at " << time;
+    EXPECT_EQ(expected.tm_isdst, actual.tm_isdst) << "at " << time;
+}
+
+static void
+check_local_tm(time64 time)
+{
+    struct tm fast;
+    ASSERT_TRUE(GncDateTime::local_tm(time, fast)) << "at " << time;
+    expect_same_tm(static_cast<struct tm>(GncDateTime(time)), fast, time);
+}
+
+/* The fast conversions must agree with boost::local_time everywhere, so
+ * walk every year of the common range and every second around each of
+ * the local zone's changes. */
+TEST(gnc_datetime_functions, test_local_tm_matches_datetime)
+{
+    TimeZoneProvider tzp;
+    for (int year = 1902; year <= 2038; ++year)
+    {
+        auto start = static_cast<time64>(GncDateTime(GncDate(year, 1, 1),
+                                                     DayPart::start));
+        for (auto time = start - 86400; time < start + 366 * 86400;
+             time += 3 * 3600 + 17)
+            check_local_tm(time);
+        for (auto& entry : tzp.transitions(year))
+            for (auto time = entry.utc_start - 3; time <= entry.utc_start + 3;
+                 ++time)
+                check_local_tm(time);
+        if (HasFatalFailure() || HasFailure())
+            return;
+    }
+}
+
+TEST(gnc_datetime_functions, test_local_time64_matches_datetime)
+{
+    for (int year = 1902; year <= 2038; ++year)
+        for (int month = 0; month < 12; ++month)
+            for (int day = 1; day <= 28; day += 3)
+                for (int hour = 0; hour < 24; hour += 5)
+                {
+                    struct tm tm{};
+                    tm.tm_year = year - 1900;
+                    tm.tm_mon = month;
+                    tm.tm_mday = day;
+                    tm.tm_hour = hour;
+                    tm.tm_min = 41;
+                    tm.tm_sec = 7;
+                    auto fast = tm;
+                    time64 time;
+                    if (!GncDateTime::local_time64(fast, time))
+                        continue;
+                    GncDateTime gncdt(tm);
+                    EXPECT_EQ(static_cast<time64>(gncdt), time);
+                    expect_same_tm(static_cast<struct tm>(gncdt), fast, time);
+                    if (HasFailure())
+                        return;
+                }
+}
+
+/* A benchmark rather than a test; run with --gtest_also_run_disabled_tests. */
+TEST(gnc_datetime_functions, DISABLED_benchmark_local_tm)
+{
+    constexpr int count = 1000000;
+    const time64 start = 1262304000; // 2010-01-01
+    struct tm tm;
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i)
+        tm = static_cast<struct tm>(GncDateTime(start + i * 307));
+    auto middle = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i)
+        GncDateTime::local_tm(start + i * 307, tm);
+    auto end = std::chrono::steady_clock::now();
+    using ms = std::chrono::duration<double, std::milli>;
+    std::cout << count << " conversions: GncDateTime "
+              << ms(middle - begin).count() << "ms, local_tm "
+              << ms(end - middle).count() << "ms" << std::endl;
+}
@@ -23,6 +23,9 @@
 #include <gtest/gtest.h>
 #include "../gnc-numeric.hpp"
 #include "../gnc-rational.hpp"
+#include <chrono>
+#include <random>
+#include <vector>
 
 TEST(gncnumeric_constructors, test_default_constructor)
 {
@@ -332,6 +335,265 @@ TEST(gncnumeric_operators, test_subtraction)
     EXPECT_EQ(12, c.denom());
 }
 
+TEST(gncnumeric_operators, test_same_denom_add_sub)
+{
+    auto a = gnc_numeric_create(123, 100), b = gnc_numeric_create(-456, 100);
+    auto c = gnc_numeric_add(a, b, GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD);
+    EXPECT_EQ(-333, c.num);
+    EXPECT_EQ(100, c.denom);
+    c = gnc_numeric_sub(a, b, 100, GNC_HOW_RND_ROUND_HALF_UP);
+    EXPECT_EQ(579, c.num);
+    EXPECT_EQ(100, c.denom);
+    /* A different target denominator still rounds. */
+    c = gnc_numeric_add(a, b, 10, GNC_HOW_RND_ROUND_HALF_UP);
+    EXPECT_EQ(-33, c.num);
+    EXPECT_EQ(10, c.denom);
+    /* So does reducing. */
+    c = gnc_numeric_add(gnc_numeric_create(25, 100), gnc_numeric_create(25, 100),
+                        GNC_DENOM_AUTO, GNC_HOW_DENOM_REDUCE);
+    EXPECT_EQ(1, c.num);
+    EXPECT_EQ(2, c.denom);
+    /* Exact zero sums are 0/1 unless rounding is forbidden. */
+    c = gnc_numeric_sub(a, a, GNC_DENOM_AUTO, GNC_HOW_DENOM_EXACT);
+    EXPECT_EQ(0, c.num);
+    EXPECT_EQ(1, c.denom);
+    c = gnc_numeric_sub(a, a, GNC_DENOM_AUTO,
+                        GNC_HOW_DENOM_EXACT | GNC_HOW_RND_NEVER);
+    EXPECT_EQ(0, c.num);
+    EXPECT_EQ(100, c.denom);
+    /* Negative denominators are multipliers. */
+    c = gnc_numeric_add(gnc_numeric_create(3, -10), gnc_numeric_create(4, -10),
+                        GNC_DENOM_AUTO, GNC_HOW_DENOM_EXACT);
+    EXPECT_EQ(70, gnc_numeric_to_double(c));
+    /* Overflowing int64 falls back to the 128-bit code rather than
+     * wrapping around. */
+    auto big = gnc_numeric_create(INT64_MAX - 1, 100);
+    c = gnc_numeric_add(big, big, GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD);
+    EXPECT_TRUE(gnc_numeric_check(c) || gnc_numeric_positive_p(c));
+    c = gnc_numeric_sub(gnc_numeric_create(INT64_MIN + 1, 100), big,
+                        GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD);
+    EXPECT_TRUE(gnc_numeric_check(c) || gnc_numeric_negative_p(c));
+    /* Errors still propagate. */
+    c = gnc_numeric_add(gnc_numeric_error(GNC_ERROR_ARG), a, GNC_DENOM_AUTO,
+                        GNC_HOW_DENOM_LCD);
+    EXPECT_EQ(GNC_ERROR_ARG, gnc_numeric_check(c));
+}
+
+TEST(gncnumeric_operators, test_same_denom_matches_rational)
+{
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<int64_t> dist(INT64_MIN / 2, INT64_MAX / 2);
+    for (int i = 0; i < 10000; ++i)
+    {
+        auto denom = INT64_C(1) << (i % 20);
+        GncNumeric a(dist(gen), denom), b(dist(gen), denom);
+        GncNumeric sum{a + b}, diff{a - b};
+        auto c = gnc_numeric_add(static_cast<gnc_numeric>(a),
+                                 static_cast<gnc_numeric>(b),
+                                 GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD);
+        EXPECT_EQ(sum.num(), c.num);
+        EXPECT_EQ(sum.denom(), c.denom);
+        c = gnc_numeric_sub(static_cast<gnc_numeric>(a),
+                            static_cast<gnc_numeric>(b),
+                            GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD);
+        EXPECT_EQ(diff.num(), c.num);
+        EXPECT_EQ(diff.denom(), c.denom);
+    }
+}
+
+TEST(gncnumeric_functions, test_same_denom_compare)
+{
+    auto a = gnc_numeric_create(123, 100), b = gnc_numeric_create(-456, 100);
+    EXPECT_EQ(1, gnc_numeric_compare(a, b));
+    EXPECT_EQ(-1, gnc_numeric_compare(b, a));
+    EXPECT_EQ(0, gnc_numeric_compare(a, a));
+    EXPECT_EQ(-1, gnc_numeric_compare(gnc_numeric_create(INT64_MIN, 1),
+                                      gnc_numeric_create(INT64_MAX, 1)));
+    EXPECT_EQ(0, gnc_numeric_compare(gnc_numeric_error(GNC_ERROR_ARG),
+                                     gnc_numeric_error(GNC_ERROR_OVERFLOW)));
+}
+
+/* Run with --gtest_also_run_disabled_tests to compare the same-denominator
+ * fast path of gnc_numeric_add with the rational arithmetic it skips. */
+TEST(gncnumeric_operators, DISABLED_benchmark_same_denom_add)
+{
+    const int count = 10000000;
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<int64_t> dist(-1000000, 1000000);
+    std::vector<gnc_numeric> values;
+    for (int i = 0; i < 1000; ++i)
+        values.push_back(gnc_numeric_create(dist(gen), 100));
+
+    auto start = std::chrono::steady_clock::now();
+    auto fast = gnc_numeric_create(0, 100);
+    for (int i = 0; i < count; ++i)
+        fast = gnc_numeric_add(fast, values[i % values.size()],
+                               GNC_DENOM_AUTO, GNC_HOW_DENOM_FIXED);
+    auto middle = std::chrono::steady_clock::now();
+    GncNumeric slow;
+    for (int i = 0; i < count; ++i)
+        slow += GncNumeric(values[i % values.size()]);
+    auto end = std::chrono::steady_clock::now();
+
+    EXPECT_TRUE(gnc_numeric_equal(fast, static_cast<gnc_numeric>(slow)));
+    std::chrono::duration<double, std::milli> fast_ms = middle - start;
+    std::chrono::duration<double, std::milli> slow_ms = end - middle;
+    std::cout << count << " additions: gnc_numeric_add " << fast_ms.count()
+              << " ms, GncNumeric " << slow_ms.count() << " ms\n";
+}
+
+TEST(gncnumeric_operators, test_sum)
+{
+    std::vector<gnc_numeric> values {gnc_numeric_create(123, 100),
+                                     gnc_numeric_create(-456, 100),
+                                     gnc_numeric_create(1, 3),
+                                     gnc_numeric_create(7, 100)};
+    auto c = gnc_numeric_sum(values.data(), 0, GNC_DENOM_AUTO,
+                             GNC_HOW_DENOM_LCD);
+    EXPECT_EQ(0, c.num);
+    EXPECT_EQ(1, c.denom);
+    c = gnc_numeric_sum(values.data(), 2, GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD);
+    EXPECT_EQ(-333, c.num);
+    EXPECT_EQ(100, c.denom);
+    /* Mixed denominators are added exactly and rounded once. */
+    c = gnc_numeric_sum(values.data(), values.size(), GNC_DENOM_AUTO,
+                        GNC_HOW_DENOM_LCD);
+    EXPECT_EQ(-878, c.num);
+    EXPECT_EQ(300, c.denom);
+    c = gnc_numeric_sum(values.data(), values.size(), 100,
+                        GNC_HOW_RND_ROUND_HALF_UP);
+    EXPECT_EQ(-293, c.num);
+    EXPECT_EQ(100, c.denom);
+    /* Negative denominators are multipliers. */
+    values.push_back(gnc_numeric_create(3, -10));
+    c = gnc_numeric_sum(values.data() + 4, 1, GNC_DENOM_AUTO,
+                        GNC_HOW_DENOM_LCD);
+    EXPECT_EQ(30, gnc_numeric_to_double(c));
+    /* Partial sums that overflow int64 are carried in 128 bits. */
+    std::vector<gnc_numeric> big(4, gnc_numeric_create(INT64_MAX - 1, 100));
+    big.push_back(gnc_numeric_create(-(INT64_MAX - 1), 100));
+    big.push_back(gnc_numeric_create(-(INT64_MAX - 1), 100));
+    big.push_back(gnc_numeric_create(-(INT64_MAX - 1), 100));
+    c = gnc_numeric_sum(big.data(), big.size(), GNC_DENOM_AUTO,
+                        GNC_HOW_DENOM_LCD);
+    EXPECT_EQ(INT64_MAX - 1, c.num);
+    EXPECT_EQ(100, c.denom);
+    c = gnc_numeric_sum(big.data(), 4, GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD);
+    EXPECT_TRUE(gnc_numeric_check(c) || gnc_numeric_positive_p(c));
+    /* Errors propagate. */
+    values.push_back(gnc_numeric_error(GNC_ERROR_ARG));
+    c = gnc_numeric_sum(values.data(), values.size(), GNC_DENOM_AUTO,
+                        GNC_HOW_DENOM_LCD);
+    EXPECT_EQ(GNC_ERROR_ARG, gnc_numeric_check(c));
+}
+
+TEST(gncnumeric_operators, test_sum_masked)
+{
+    const guint8 cleared = 1, reconciled = 2;
+    std::vector<gnc_numeric> values {gnc_numeric_create(100, 100),
+                                     gnc_numeric_create(200, 100),
+                                     gnc_numeric_create(400, 100),
+                                     gnc_numeric_error(GNC_ERROR_ARG)};
+    std::vector<guint8> mask {cleared, reconciled, 0, 0};
+    auto c = gnc_numeric_sum_masked(values.data(), mask.data(), cleared,
+                                    values.size(), GNC_DENOM_AUTO,
+                                    GNC_HOW_DENOM_LCD);
+    EXPECT_EQ(100, c.num);
+    c = gnc_numeric_sum_masked(values.data(), mask.data(),
+                               cleared | reconciled, values.size(),
+                               GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD);
+    EXPECT_EQ(300, c.num);
+    EXPECT_EQ(100, c.denom);
+}
+
+TEST(gncnumeric_operators, test_sum_matches_add)
+{
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<int64_t> dist(-100000000, 100000000);
+    const int64_t denoms[] {1, 100, 1000, 3};
+    std::vector<gnc_numeric> values;
+    auto total = gnc_numeric_zero();
+    for (int i = 0; i < 1000; ++i)
+    {
+        values.push_back(gnc_numeric_create(dist(gen), denoms[i / 250]));
+        total = gnc_numeric_add(total, values.back(), GNC_DENOM_AUTO,
+                                GNC_HOW_DENOM_LCD);
+    }
+    auto c = gnc_numeric_sum(values.data(), values.size(), GNC_DENOM_AUTO,
+                             GNC_HOW_DENOM_LCD);
+    EXPECT_EQ(total.num, c.num);
+    EXPECT_EQ(total.denom, c.denom);
+}
+
+/* Run with --gtest_also_run_disabled_tests to compare gnc_numeric_sum with
+ * adding the same values one at a time. */
+TEST(gncnumeric_operators, DISABLED_benchmark_sum)
+{
+    const int count = 10000;
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<int64_t> dist(-1000000, 1000000);
+    std::vector<gnc_numeric> values;
+    for (int i = 0; i < 1000; ++i)
+        values.push_back(gnc_numeric_create(dist(gen), 100));
+
+    auto start = std::chrono::steady_clock::now();
+    auto batch = gnc_numeric_zero();
+    for (int i = 0; i < count; ++i)
+        batch = gnc_numeric_sum(values.data(), values.size(), GNC_DENOM_AUTO,
+                                GNC_HOW_DENOM_FIXED);
+    auto middle = std::chrono::steady_clock::now();
+    auto scalar = gnc_numeric_zero();
+    for (int i = 0; i < count; ++i)
+    {
+        scalar = gnc_numeric_zero();
+        for (auto value : values)
+            scalar = gnc_numeric_add_fixed(scalar, value);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    EXPECT_TRUE(gnc_numeric_equal(batch, scalar));
+    std::chrono::duration<double, std::milli> batch_ms = middle - start;
+    std::chrono::duration<double, std::milli> scalar_ms = end - middle;
+    std::cout << count << " sums of " << values.size()
+              << " values: gnc_numeric_sum " << batch_ms.count()
+              << " ms, gnc_numeric_add " << scalar_ms.count() << " ms\n";
+}
+
+/* The budget totals column adds a dozen periods at a time, with the
+ * denominator chosen from the values. */
+TEST(gncnumeric_operators, DISABLED_benchmark_sum_lcd)
+{
+    const int count = 1000000;
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<int64_t> dist(-1000000, 1000000);
+    std::vector<gnc_numeric> values;
+    for (int i = 0; i < 12; ++i)
+        values.push_back(gnc_numeric_create(dist(gen), 100));
+
+    auto start = std::chrono::steady_clock::now();
+    auto batch = gnc_numeric_zero();
+    for (int i = 0; i < count; ++i)
+        batch = gnc_numeric_sum(values.data(), values.size(), GNC_DENOM_AUTO,
+                                GNC_HOW_DENOM_LCD);
+    auto middle = std::chrono::steady_clock::now();
+    auto scalar = gnc_numeric_zero();
+    for (int i = 0; i < count; ++i)
+    {
+        scalar = gnc_numeric_zero();
+        for (auto value : values)
+            scalar = gnc_numeric_add(scalar, value, GNC_DENOM_AUTO,
+                                     GNC_HOW_DENOM_LCD);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    EXPECT_TRUE(gnc_numeric_equal(batch, scalar));
+    std::chrono::duration<double, std::milli> batch_ms = middle - start;
+    std::chrono::duration<double, std::milli> scalar_ms = end - middle;
+    std::cout << count << " sums of " << values.size()
+              << " values: gnc_numeric_sum " << batch_ms.count()
+              << " ms, gnc_numeric_add " << scalar_ms.count() << " ms\n";
+}
+
 TEST(gncnumeric_operators, test_multiplication)
 {
     GncNumeric a(123456789987654321, 1000000000);
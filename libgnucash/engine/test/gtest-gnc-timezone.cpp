@@ -60,6 +60,35 @@ TEST(gnc_timezone_constructors, test_pacific_time_constructor)
 }
 
 #if !PLATFORM(WINDOWS)
+TEST(gnc_timezone_functions, test_transitions)
+{
+    TimeZoneProvider tzp ("America/Los_Angeles");
+    auto& table = tzp.transitions (2017);
+    ASSERT_EQ(3U, table.size());
+    EXPECT_EQ(1483228800, table[0].utc_start); //2017-01-01 00:00 Z
+    EXPECT_EQ(-28800, table[0].offset);
+    EXPECT_FALSE(table[0].is_dst);
+    EXPECT_EQ(-25200, table[1].offset);
+    EXPECT_TRUE(table[1].is_dst);
+    EXPECT_EQ(-28800, table[2].offset);
+    EXPECT_FALSE(table[2].is_dst);
+
+    /* Each entry starts on the second boost changes the offset. */
+    using boost::posix_time::seconds;
+    const boost::posix_time::ptime epoch (boost::gregorian::date(1970, 1, 1));
+    auto tz = tzp.get (2017);
+    for (auto entry = table.begin() + 1; entry != table.end(); ++entry)
+    {
+        boost::local_time::local_date_time before (epoch + seconds(entry->utc_start - 1), tz);
+        boost::local_time::local_date_time after (epoch + seconds(entry->utc_start), tz);
+        EXPECT_EQ((entry - 1)->offset,
+                  (before.local_time() - before.utc_time()).total_seconds());
+        EXPECT_EQ(entry->offset,
+                  (after.local_time() - after.utc_time()).total_seconds());
+    }
+    EXPECT_EQ(&table, &tzp.transitions (2017));
+}
+
 TEST(gnc_timezone_constructors, test_posix_timezone)
 {
     std::string timezone("FST08FDT07,M4.1.0,M10.31.0");
@@ -318,6 +318,39 @@ TEST_F(ImapBayesTest, AddAccountBayes)
     EXPECT_EQ(2, value->get<int64_t>());
 }
 
+TEST_F(ImapBayesTest, FindAccountBayesAfterChanges)
+{
+    qof_instance_increase_editlevel(QOF_INSTANCE(t_bank_account));
+    gnc_account_imap_add_account_bayes(t_imap, t_list1, t_expense_account1);
+    EXPECT_EQ(t_expense_account1, gnc_account_imap_find_account_bayes(t_imap, t_list1));
+    EXPECT_EQ(nullptr, gnc_account_imap_find_account_bayes(t_imap, t_list3));
+    for (int i = 0; i < 4; ++i)
+        gnc_account_imap_add_account_bayes(t_imap, t_list1, t_expense_account2);
+    EXPECT_EQ(t_expense_account2, gnc_account_imap_find_account_bayes(t_imap, t_list1));
+
+    /* Changing a count leaves the number of slots alone. */
+    auto root = qof_instance_get_slots(QOF_INSTANCE(t_bank_account));
+    auto acct1_guid = guid_to_string (xaccAccountGetGUID(t_expense_account1));
+    auto slot_count = root->size();
+    for (auto token : {foo, bar})
+        root->set_path({std::string{IMAP_FRAME_BAYES} + "/" + token + "/" + acct1_guid},
+                       new KvpValue{INT64_C(10)});
+    EXPECT_EQ(slot_count, root->size());
+    EXPECT_EQ(t_expense_account1, gnc_account_imap_find_account_bayes(t_imap, t_list1));
+
+    root->set_path({std::string{IMAP_FRAME_BAYES} + "/" + pepper + "/" + acct1_guid},
+                   new KvpValue{INT64_C(3)});
+    EXPECT_EQ(t_expense_account1, gnc_account_imap_find_account_bayes(t_imap, t_list3));
+
+    gnc_account_delete_map_entry(t_bank_account,
+                                 g_strdup_printf("%s/%s/%s", IMAP_FRAME_BAYES, pepper,
+                                                 acct1_guid), FALSE);
+    g_free(acct1_guid);
+    EXPECT_EQ(nullptr, gnc_account_imap_find_account_bayes(t_imap, t_list3));
+    qof_instance_mark_clean(QOF_INSTANCE(t_bank_account));
+    qof_instance_reset_editlevel(QOF_INSTANCE(t_bank_account));
+}
+
 TEST_F(ImapBayesTest, ConvertBayesData)
 {
     auto root = qof_instance_get_slots(QOF_INSTANCE(t_bank_account));
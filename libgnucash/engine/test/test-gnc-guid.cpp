@@ -25,12 +25,18 @@
 #include "../guid.hpp"
 
 #include <random>
+#include <set>
 #include <sstream>
 #include <iomanip>
 #include <string>
+#include <vector>
 #include <iostream>
 #include <gtest/gtest.h>
 #include <boost/version.hpp>
+#ifndef G_OS_WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 TEST (GncGUID, creation)
 {
@@ -40,6 +46,48 @@ TEST (GncGUID, creation)
     GncGUID other;
 }
 
+TEST (GncGUID, create_many)
+{
+    /* A batch, then a few more one at a time from the same generator. */
+    std::vector<gnc::GUID> guids (1000);
+    gnc::GUID::create_random (guids.data (), guids.size ());
+    for (int i = 0; i < 10; ++i)
+        guids.push_back (gnc::GUID::create_random ());
+    std::set<std::string> unique;
+    for (auto const & guid : guids)
+        unique.insert (guid.to_string ());
+    EXPECT_EQ (guids.size (), unique.size ());
+    EXPECT_EQ (0U, unique.count (gnc::GUID::null_guid ().to_string ()));
+}
+
+#ifndef G_OS_WIN32
+TEST (GncGUID, create_after_fork)
+{
+    /* Make sure this thread's generator exists before forking. */
+    auto before = gnc::GUID::create_random ();
+    int fds[2];
+    ASSERT_EQ (0, pipe (fds));
+    auto pid = fork ();
+    ASSERT_NE (-1, pid);
+    if (pid == 0)
+    {
+        auto str = gnc::GUID::create_random ().to_string ();
+        auto written = write (fds[1], str.c_str (), str.size ());
+        _exit (written == static_cast<ssize_t> (str.size ()) ? 0 : 1);
+    }
+    close (fds[1]);
+    char buf[GUID_ENCODING_LENGTH + 1] {};
+    auto got = read (fds[0], buf, GUID_ENCODING_LENGTH);
+    close (fds[0]);
+    int status;
+    waitpid (pid, &status, 0);
+    ASSERT_EQ (GUID_ENCODING_LENGTH, static_cast<int> (got));
+    auto in_parent = gnc::GUID::create_random ().to_string ();
+    EXPECT_NE (in_parent, std::string (buf));
+    EXPECT_NE (before.to_string (), std::string (buf));
+}
+#endif
+
 TEST (GncGUID, copy)
 {
     auto guid = gnc::GUID::create_random ();
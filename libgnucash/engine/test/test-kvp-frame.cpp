@@ -102,6 +102,21 @@ TEST_F (KvpFrameTest, SetPathSlash)
     delete v1;
 }
 
+TEST_F (KvpFrameTest, GetSlotWithoutPath)
+{
+    const char* key = "first";
+    KvpPath compiled {"top", "third"};
+    KvpPath copy {compiled};
+    KvpPath missing {"top", "third", "thirty-first"};
+
+    EXPECT_EQ (t_int_val, t_root.get_slot ({"top", key}));
+    EXPECT_EQ (t_str_val, t_root.get_slot (compiled));
+    EXPECT_EQ (t_str_val, t_root.get_slot (copy));
+    EXPECT_EQ (nullptr, t_root.get_slot (missing));
+    EXPECT_EQ (nullptr, t_root.get_slot ({"bottom", key}));
+    EXPECT_EQ (nullptr, t_root.get_slot (Path {}));
+}
+
 TEST_F (KvpFrameTest, SetPathWithCreate)
 {
     Path path1 {"top", "second", "twenty-first"};
@@ -189,6 +204,21 @@ TEST_F (KvpFrameTest, Empty)
     EXPECT_FALSE(f2.empty());
 }
 
+TEST_F (KvpFrameTest, Generation)
+{
+    auto generation = t_root.generation();
+    delete t_root.set_path({"top", "first"}, new KvpValue {INT64_C(16)});
+    EXPECT_NE (generation, t_root.generation());
+    generation = t_root.generation();
+    delete t_root.set({"top", "third"}, nullptr);
+    EXPECT_NE (generation, t_root.generation());
+    generation = t_root.generation();
+    EXPECT_EQ (nullptr, t_root.set({"nowhere", "key"}, nullptr));
+    EXPECT_EQ (generation, t_root.generation());
+    KvpFrameImpl copy {t_root};
+    EXPECT_NE (generation, copy.generation());
+}
+
 TEST (KvpFrameTestForEachPrefix, for_each_prefix_1)
 {
     KvpFrame fr;
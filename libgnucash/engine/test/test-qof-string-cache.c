@@ -77,8 +77,52 @@ test_qof_string_cache( void )
     g_assert(str1_1 != str1_4);
 }
 
+static void
+test_qof_string_cache_many( void )
+{
+    /* Cached strings must stay put while the cache grows, and strings
+     * too long to share a chunk must be handled as well. */
+    const int count = 5000;
+    gchar **cached = g_new0 (gchar*, count);
+    gchar *long_str = g_strnfill (1000, 'x');
+    gchar *long_1, *long_2;
+    int i;
+
+    for (i = 0; i < count; ++i)
+    {
+        gchar *str = g_strdup_printf ("string %d", i);
+        cached[i] = qof_string_cache_insert (str);
+        g_free (str);
+    }
+    long_1 = qof_string_cache_insert (long_str);
+    g_assert (long_1 != long_str);
+    g_assert_cmpstr (long_1, ==, long_str);
+    for (i = 0; i < count; ++i)
+    {
+        gchar *str = g_strdup_printf ("string %d", i);
+        g_assert_cmpstr (cached[i], ==, str);
+        g_assert (CACHE_EQUAL (qof_string_cache_insert (str), cached[i]));
+        qof_string_cache_remove (str);
+        if (i % 2)
+            qof_string_cache_remove (cached[i]);
+        g_free (str);
+    }
+    /* Removing half the strings mustn't lose the others. */
+    for (i = 0; i < count; i += 2)
+    {
+        gchar *str = g_strdup_printf ("string %d", i);
+        g_assert (qof_string_cache_insert (str) == cached[i]);
+        g_free (str);
+    }
+    long_2 = qof_string_cache_insert (long_str);
+    g_assert (long_1 == long_2);
+    g_free (long_str);
+    g_free (cached);
+}
+
 void
 test_suite_qof_string_cache ( void )
 {
     GNC_TEST_ADD_FUNC( suitename, "string-cache", test_qof_string_cache);
+    GNC_TEST_ADD_FUNC( suitename, "string-cache-many", test_qof_string_cache_many);
 }
@@ -0,0 +1,218 @@
+/********************************************************************
+ * test-qofevent.c: GLib g_test test suite for qofevent.cpp.        *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+
+#include <config.h>
+#include <glib.h>
+#include <unittest-support.h>
+#include "qof.h"
+
+static const gchar *suitename = "/qof/qofevent";
+void test_suite_qofevent ( void );
+
+typedef struct
+{
+    QofBook *book;
+    QofInstance *a;
+    QofInstance *b;
+} Fixture;
+
+typedef struct
+{
+    gint count;
+    QofEventId last_event;
+    gint unregister_id;
+} Counter;
+
+static void
+setup( Fixture *fixture, gconstpointer pData )
+{
+    fixture->book = qof_book_new ();
+    fixture->a = g_object_new (QOF_TYPE_INSTANCE, NULL);
+    qof_instance_init_data (fixture->a, "test-type-a", fixture->book);
+    fixture->b = g_object_new (QOF_TYPE_INSTANCE, NULL);
+    qof_instance_init_data (fixture->b, "test-type-b", fixture->book);
+}
+
+static void
+teardown( Fixture *fixture, gconstpointer pData )
+{
+    g_object_unref (fixture->a);
+    g_object_unref (fixture->b);
+    qof_book_destroy (fixture->book);
+}
+
+static void
+count_event (QofInstance *ent, QofEventId event_type, gpointer handler_data,
+             gpointer event_data)
+{
+    Counter *counter = handler_data;
+    counter->count++;
+    counter->last_event = event_type;
+    if (counter->unregister_id)
+    {
+        qof_event_unregister_handler (counter->unregister_id);
+        counter->unregister_id = 0;
+    }
+}
+
+static void
+test_typed_handler (Fixture *fixture, gconstpointer pData)
+{
+    Counter all = {0}, a_modify = {0}, b_any = {0};
+    gint all_id = qof_event_register_handler (count_event, &all);
+    gint a_id = qof_event_register_typed_handler (count_event, &a_modify,
+                                                  "test-type-a",
+                                                  QOF_EVENT_MODIFY);
+    gint b_id = qof_event_register_typed_handler (count_event, &b_any,
+                                                  "test-type-b",
+                                                  ~QOF_EVENT_NONE);
+
+    qof_event_gen (fixture->a, QOF_EVENT_MODIFY, NULL);
+    g_assert_cmpint (all.count, ==, 1);
+    g_assert_cmpint (a_modify.count, ==, 1);
+    g_assert_cmpint (b_any.count, ==, 0);
+
+    qof_event_gen (fixture->a, QOF_EVENT_DESTROY, NULL);
+    g_assert_cmpint (all.count, ==, 2);
+    g_assert_cmpint (a_modify.count, ==, 1);
+
+    qof_event_gen (fixture->b, QOF_MAKE_EVENT (QOF_EVENT_BASE + 1), NULL);
+    g_assert_cmpint (all.count, ==, 3);
+    g_assert_cmpint (b_any.count, ==, 1);
+    g_assert_cmpint (b_any.last_event, ==, QOF_MAKE_EVENT (QOF_EVENT_BASE + 1));
+
+    /* Suspended events aren't delivered to typed handlers either. */
+    qof_event_suspend ();
+    qof_event_gen (fixture->a, QOF_EVENT_MODIFY, NULL);
+    qof_event_resume ();
+    g_assert_cmpint (a_modify.count, ==, 1);
+
+    qof_event_unregister_handler (a_id);
+    qof_event_gen (fixture->a, QOF_EVENT_MODIFY, NULL);
+    g_assert_cmpint (all.count, ==, 4);
+    g_assert_cmpint (a_modify.count, ==, 1);
+
+    qof_event_unregister_handler (b_id);
+    qof_event_unregister_handler (all_id);
+}
+
+static void
+test_unregister_while_running (Fixture *fixture, gconstpointer pData)
+{
+    Counter first = {0}, second = {0};
+    gint first_id = qof_event_register_typed_handler (count_event, &first,
+                                                      "test-type-a",
+                                                      QOF_EVENT_MODIFY);
+    gint second_id = qof_event_register_typed_handler (count_event, &second,
+                                                       "test-type-a",
+                                                       QOF_EVENT_MODIFY);
+    /* The newest handler runs first and removes the other one, which
+     * must not be invoked afterwards. */
+    second.unregister_id = first_id;
+    qof_event_gen (fixture->a, QOF_EVENT_MODIFY, NULL);
+    g_assert_cmpint (second.count, ==, 1);
+    g_assert_cmpint (first.count, ==, 0);
+
+    qof_event_gen (fixture->a, QOF_EVENT_MODIFY, NULL);
+    g_assert_cmpint (second.count, ==, 2);
+    g_assert_cmpint (first.count, ==, 0);
+    qof_event_unregister_handler (second_id);
+}
+
+typedef struct
+{
+    gint batches;
+    guint n_entries;
+    QofEventBatchEntry entries[4];
+} BatchRecord;
+
+static void
+record_batch (const QofEventBatchEntry *entries, guint n_entries,
+              gpointer handler_data)
+{
+    BatchRecord *record = handler_data;
+    guint i;
+
+    record->batches++;
+    record->n_entries = n_entries;
+    for (i = 0; i < n_entries && i < G_N_ELEMENTS (record->entries); i++)
+        record->entries[i] = entries[i];
+}
+
+static void
+test_batch (Fixture *fixture, gconstpointer pData)
+{
+    BatchRecord record = {0};
+    Counter all = {0};
+    gint batch_id = qof_event_register_batch_handler (record_batch, &record);
+    gint all_id = qof_event_register_handler (count_event, &all);
+
+    /* Outside a batch every event is a batch of one. */
+    qof_event_gen (fixture->a, QOF_EVENT_MODIFY, NULL);
+    g_assert_cmpint (record.batches, ==, 1);
+    g_assert_cmpuint (record.n_entries, ==, 1);
+    g_assert (guid_equal (&record.entries[0].guid,
+                          qof_instance_get_guid (fixture->a)));
+    g_assert_cmpstr (record.entries[0].type, ==, "test-type-a");
+
+    qof_event_begin_batch ();
+    qof_event_gen (fixture->b, QOF_EVENT_CREATE, NULL);
+    qof_event_gen (fixture->a, QOF_EVENT_MODIFY, NULL);
+    qof_event_begin_batch ();
+    qof_event_gen (fixture->b, QOF_EVENT_MODIFY, NULL);
+    qof_event_gen (fixture->a, QOF_EVENT_MODIFY, NULL);
+    qof_event_end_batch ();
+    /* Plain handlers aren't held back. */
+    g_assert_cmpint (all.count, ==, 5);
+    g_assert_cmpint (record.batches, ==, 1);
+    qof_event_end_batch ();
+
+    g_assert_cmpint (record.batches, ==, 2);
+    g_assert_cmpuint (record.n_entries, ==, 2);
+    g_assert (guid_equal (&record.entries[0].guid,
+                          qof_instance_get_guid (fixture->b)));
+    g_assert_cmpint (record.entries[0].event_mask, ==,
+                     QOF_EVENT_CREATE | QOF_EVENT_MODIFY);
+    g_assert_cmpstr (record.entries[0].type, ==, "test-type-b");
+    g_assert (guid_equal (&record.entries[1].guid,
+                          qof_instance_get_guid (fixture->a)));
+    g_assert_cmpint (record.entries[1].event_mask, ==, QOF_EVENT_MODIFY);
+
+    /* An empty batch delivers nothing. */
+    qof_event_begin_batch ();
+    qof_event_end_batch ();
+    g_assert_cmpint (record.batches, ==, 2);
+
+    qof_event_unregister_handler (batch_id);
+    qof_event_begin_batch ();
+    qof_event_gen (fixture->a, QOF_EVENT_MODIFY, NULL);
+    qof_event_end_batch ();
+    g_assert_cmpint (record.batches, ==, 2);
+    qof_event_unregister_handler (all_id);
+}
+
+void
+test_suite_qofevent ( void )
+{
+    GNC_TEST_ADD( suitename, "typed handler", Fixture, NULL, setup, test_typed_handler, teardown );
+    GNC_TEST_ADD( suitename, "unregister while running", Fixture, NULL, setup, test_unregister_while_running, teardown );
+    GNC_TEST_ADD( suitename, "batch", Fixture, NULL, setup, test_batch, teardown );
+}
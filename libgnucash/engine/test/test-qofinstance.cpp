@@ -30,6 +30,7 @@ extern "C"
 }
 #include "../qof-backend.hpp"
 #include "../kvp-frame.hpp"
+#include <vector>
 static const gchar *suitename = "/qof/qofinstance";
 extern "C" void test_suite_qofinstance ( void );
 static gchar* error_message;
@@ -277,6 +278,55 @@ test_instance_init_data( void )
     qof_book_destroy( book );
 }
 
+static void
+count_entities( QofInstance *inst, gpointer user_data )
+{
+    ++*static_cast<guint*>(user_data);
+}
+
+static void
+test_collection_many_entities( void )
+{
+    /* Enough instances to grow the collection's table several times past
+     * the reserved size, with some removed and some renumbered. */
+    const guint count = 2000;
+    QofIdType test_type = "test type";
+    QofBook *book = qof_book_new();
+    QofCollection *col = qof_book_get_collection( book, test_type );
+    std::vector<QofInstance*> insts;
+    guint counted = 0;
+
+    qof_collection_reserve( col, count / 4 );
+    for ( guint i = 0; i < count; ++i )
+    {
+        auto inst = static_cast<QofInstance*>(g_object_new( QOF_TYPE_INSTANCE, NULL ));
+        qof_instance_init_data( inst, test_type, book );
+        insts.push_back( inst );
+    }
+    g_assert_cmpuint( qof_collection_count( col ), == , count );
+
+    for ( guint i = 0; i < count; i += 2 )
+        qof_collection_remove_entity( insts[i] );
+    for ( guint i = 1; i < count; i += 4 )
+    {
+        GncGUID guid;
+        guid_replace( &guid );
+        qof_instance_set_guid( insts[i], &guid );
+    }
+    g_assert_cmpuint( qof_collection_count( col ), == , count / 2 );
+    for ( guint i = 0; i < count; ++i )
+    {
+        auto found = qof_collection_lookup_entity( col, qof_instance_get_guid( insts[i] ) );
+        g_assert( found == ( i % 2 ? insts[i] : NULL ) );
+    }
+    qof_collection_foreach( col, count_entities, &counted );
+    g_assert_cmpuint( counted, == , count / 2 );
+
+    for ( auto inst : insts )
+        g_object_unref( inst );
+    qof_book_destroy( book );
+}
+
 static void
 test_instance_get_set_slots( Fixture *fixture, gconstpointer pData )
 {
@@ -1011,6 +1061,7 @@ test_suite_qofinstance ( void )
     GNC_TEST_ADD( suitename, "set get guid", Fixture, NULL, setup, test_instance_set_get_guid, teardown );
     GNC_TEST_ADD_FUNC( suitename, "instance new and destroy", test_instance_new_destroy );
     GNC_TEST_ADD_FUNC( suitename, "init data", test_instance_init_data );
+    GNC_TEST_ADD_FUNC( suitename, "collection with many entities", test_collection_many_entities );
     GNC_TEST_ADD( suitename, "get set slots", Fixture, NULL, setup, test_instance_get_set_slots, teardown );
     GNC_TEST_ADD_FUNC( suitename, "version compare", test_instance_version_cmp );
     GNC_TEST_ADD( suitename, "get set dirty", Fixture, NULL, setup, test_instance_get_set_dirty, teardown );
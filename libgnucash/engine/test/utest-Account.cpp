@@ -33,6 +33,7 @@ extern "C"
 #include "../Split.h"
 #include "../Transaction.h"
 #include "../gnc-lot.h"
+#include "../gnc-pricedb-p.h"
 
 #if defined(__clang__) && (__clang_major__ == 5 || (__clang_major__ == 3 && __clang_minor__ < 5))
 #define USE_CLANG_FUNC_SIG 1
@@ -1744,6 +1745,38 @@ test_gnc_account_lookup_by_full_name (Fixture *fixture, gconstpointer pData)
     g_free (code);
 }
 
+/* The lookups are answered from a book-level index; make sure it follows
+ * renames, recodes and moves.
+ */
+static void
+test_gnc_account_lookup_after_change (Fixture *fixture, gconstpointer pData)
+{
+    Account *root, *income, *target;
+    root = gnc_account_get_root (fixture->acct);
+    income = gnc_account_lookup_by_name (root, "income");
+    target = gnc_account_lookup_by_full_name (root, "income:taxable:int");
+    g_assert (target != NULL);
+
+    xaccAccountSetName (target, "interest");
+    g_assert (gnc_account_lookup_by_full_name (root, "income:taxable:int") == NULL);
+    g_assert (gnc_account_lookup_by_full_name (root, "income:taxable:interest") == target);
+    g_assert (gnc_account_lookup_by_name (root, "interest") == target);
+
+    xaccAccountSetCode (target, "4999");
+    g_assert (gnc_account_lookup_by_code (root, "4160") == NULL);
+    g_assert (gnc_account_lookup_by_code (root, "4999") == target);
+
+    gnc_account_append_child (income, target);
+    g_assert (gnc_account_lookup_by_full_name (root, "income:interest") == target);
+    g_assert (gnc_account_lookup_by_full_name (root, "income:taxable:interest") == NULL);
+
+    gnc_account_remove_child (income, target);
+    g_assert (gnc_account_lookup_by_name (root, "interest") == NULL);
+    g_assert (gnc_account_lookup_by_code (root, "4999") == NULL);
+    g_assert (gnc_account_lookup_by_full_name (root, "income:interest") == NULL);
+    gnc_account_append_child (income, target);
+}
+
 static void
 thunk (Account *s, gpointer data)
 {
@@ -1870,6 +1903,35 @@ test_gnc_account_get_full_name (Fixture *fixture, gconstpointer pData)
 
 }
 
+/* xaccAccountGetFullName
+const char *
+xaccAccountGetFullName (const Account *account)*/
+static void
+test_xaccAccountGetFullName (Fixture *fixture, gconstpointer pData)
+{
+    Account *baz = gnc_account_get_parent (fixture->acct);
+    Account *foo = gnc_account_get_parent (baz);
+    g_assert_cmpstr (xaccAccountGetFullName (NULL), == , "");
+    g_assert_cmpstr (xaccAccountGetFullName (fixture->acct), == ,
+                     "foo:baz:waldo");
+    /* Cached, so the same string comes back. */
+    g_assert (xaccAccountGetFullName (fixture->acct) ==
+              xaccAccountGetFullName (fixture->acct));
+
+    xaccAccountSetName (foo, "bar");
+    g_assert_cmpstr (xaccAccountGetFullName (fixture->acct), == ,
+                     "bar:baz:waldo");
+
+    gnc_account_append_child (foo, fixture->acct);
+    g_assert_cmpstr (xaccAccountGetFullName (fixture->acct), == ,
+                     "bar:waldo");
+
+    gnc_set_account_separator ("-");
+    g_assert_cmpstr (xaccAccountGetFullName (fixture->acct), == ,
+                     "bar-waldo");
+    gnc_set_account_separator (":");
+}
+
 /* DxaccAccountGetCurrency
 gnc_commodity *
 DxaccAccountGetCurrency (const Account *acc)// C: 9 in 5
@@ -1931,6 +1993,11 @@ test_xaccAccountGetBalanceAsOfDate (Fixture *fixture, gconstpointer pData)
                                          (gnc_time (NULL) - offset));
     dval = gnc_numeric_to_double (val);
     g_assert_cmpfloat (dval, == , dbal);
+    /* Before the first split and after the last one */
+    val = xaccAccountGetBalanceAsOfDate (fixture->acct, 0);
+    g_assert (gnc_numeric_zero_p (val));
+    val = xaccAccountGetBalanceAsOfDate (fixture->acct, G_MAXINT64);
+    g_assert (gnc_numeric_equal (val, xaccAccountGetBalance (fixture->acct)));
 }
 /* xaccAccountGetPresentBalance
 gnc_numeric
@@ -1958,6 +2025,174 @@ test_xaccAccountGetPresentBalance (Fixture *fixture, gconstpointer pData)
     dval = gnc_numeric_to_double (val);
     g_assert_cmpfloat (dval, == , dbal);
 }
+/* xaccAccountGetBalanceInCurrency
+gnc_numeric
+xaccAccountGetBalanceInCurrency (const Account *acc,// C: 5 in 3
+The sums including the children are cached; check that they follow
+changes to a descendant's balance, to the tree and to the prices.
+*/
+static void
+set_usd (Account *acct, gpointer data)
+{
+    xaccAccountSetCommodity (acct, static_cast<gnc_commodity*>(data));
+}
+
+static void
+test_xaccAccountGetBalanceInCurrency (Fixture *fixture, gconstpointer pData)
+{
+    auto root = gnc_account_get_root (fixture->acct);
+    auto book = gnc_account_get_book (root);
+    auto usd = gnc_commodity_new (book, "US Dollar", "CURRENCY", "USD", "0", 100);
+    auto expense = gnc_account_lookup_by_name (root, "expense");
+    auto income = gnc_account_lookup_by_name (root, "income");
+    auto food = gnc_account_lookup_by_name (root, "food");
+    auto utilities = gnc_account_lookup_by_name (root, "utilities");
+    gnc_numeric val;
+
+    xaccAccountSetCommodity (root, usd);
+    gnc_account_foreach_descendant (root, set_usd, usd);
+    gnc_account_set_start_balance (food, gnc_numeric_create (10000, 100));
+    gnc_account_set_start_balance (utilities, gnc_numeric_create (5000, 100));
+    xaccAccountRecomputeBalance (food);
+    xaccAccountRecomputeBalance (utilities);
+
+    val = xaccAccountGetBalanceInCurrency (root, NULL, TRUE);
+    g_assert (gnc_numeric_equal (val, gnc_numeric_create (15000, 100)));
+    val = xaccAccountGetBalanceInCurrency (expense, NULL, TRUE);
+    g_assert (gnc_numeric_equal (val, gnc_numeric_create (15000, 100)));
+    val = xaccAccountGetBalanceInCurrency (expense, NULL, FALSE);
+    g_assert (gnc_numeric_zero_p (val));
+
+    gnc_account_set_start_balance (food, gnc_numeric_create (3000, 100));
+    xaccAccountRecomputeBalance (food);
+    val = xaccAccountGetBalanceInCurrency (expense, NULL, TRUE);
+    g_assert (gnc_numeric_equal (val, gnc_numeric_create (8000, 100)));
+    val = xaccAccountGetBalanceInCurrency (root, NULL, TRUE);
+    g_assert (gnc_numeric_equal (val, gnc_numeric_create (8000, 100)));
+
+    gnc_account_append_child (income, utilities);
+    val = xaccAccountGetBalanceInCurrency (expense, NULL, TRUE);
+    g_assert (gnc_numeric_equal (val, gnc_numeric_create (3000, 100)));
+    val = xaccAccountGetBalanceInCurrency (income, NULL, TRUE);
+    g_assert (gnc_numeric_equal (val, gnc_numeric_create (5000, 100)));
+    val = xaccAccountGetBalanceInCurrency (root, NULL, TRUE);
+    g_assert (gnc_numeric_equal (val, gnc_numeric_create (8000, 100)));
+
+    /* Without a price food's euros count for nothing. */
+    gnc_pricedb_register ();
+    auto eur = gnc_commodity_new (book, "Euro", "CURRENCY", "EUR", "0", 100);
+    xaccAccountSetCommodity (food, eur);
+    auto price = gnc_price_create (book);
+    gnc_price_begin_edit (price);
+    gnc_price_set_commodity (price, eur);
+    gnc_price_set_currency (price, usd);
+    gnc_price_set_time64 (price, gnc_time (NULL));
+    gnc_price_set_source (price, PRICE_SOURCE_USER_PRICE);
+    gnc_price_set_value (price, gnc_numeric_create (2, 1));
+    gnc_price_commit_edit (price);
+    val = xaccAccountGetBalanceInCurrency (root, NULL, TRUE);
+    g_assert (gnc_numeric_equal (val, gnc_numeric_create (5000, 100)));
+
+    /* A price added while events are suspended, as when a book is
+     * loaded, reaches the cached sums too. */
+    qof_event_suspend ();
+    gnc_pricedb_add_price (gnc_pricedb_get_db (book), price);
+    qof_event_resume ();
+    val = xaccAccountGetBalanceInCurrency (root, NULL, TRUE);
+    g_assert (gnc_numeric_equal (val, gnc_numeric_create (11000, 100)));
+}
+/* The cache keeps sums for several dates side by side, up to
+ * BALANCE_CACHE_SIZE of them, dropping the least recently used first.
+ */
+static void
+test_balance_cache_dates (Fixture *fixture, gconstpointer pData)
+{
+    auto root = gnc_account_get_root (fixture->acct);
+    auto book = gnc_account_get_book (root);
+    auto usd = gnc_commodity_new (book, "US Dollar", "CURRENCY", "USD", "0", 100);
+    auto bar = gnc_account_lookup_by_name (root, "bar");
+    auto priv = fixture->func->get_private (bar);
+    time64 now = gnc_time (NULL), day = 24 * 3600;
+    BalanceCacheEntry key;
+    guint i;
+
+    xaccAccountSetCommodity (root, usd);
+    gnc_account_foreach_descendant (root, set_usd, usd);
+    xaccAccountRecomputeBalance (gnc_account_lookup_by_name (root, "meh"));
+
+    key.fn = reinterpret_cast<gpointer>(xaccAccountGetBalanceAsOfDate);
+    key.commodity = usd;
+
+    for (i = 0; i <= BALANCE_CACHE_SIZE; i++)
+        xaccAccountGetBalanceAsOfDateInCurrency (bar, now - i * day, NULL, TRUE);
+    g_assert_cmpuint (g_hash_table_size (priv->balance_cache), == , BALANCE_CACHE_SIZE);
+    g_assert_cmpuint (priv->balance_lru.length, == , BALANCE_CACHE_SIZE);
+    key.date = now;
+    g_assert (g_hash_table_lookup (priv->balance_cache, &key) == NULL);
+    key.date = now - 8 * day;
+    g_assert (g_hash_table_lookup (priv->balance_cache, &key) != NULL);
+
+    /* Using the oldest sum keeps it; the next oldest goes instead. */
+    xaccAccountGetBalanceAsOfDateInCurrency (bar, now - day, NULL, TRUE);
+    xaccAccountGetBalanceAsOfDateInCurrency (bar, now + day, NULL, TRUE);
+    g_assert_cmpuint (g_hash_table_size (priv->balance_cache), == , BALANCE_CACHE_SIZE);
+    key.date = now - day;
+    g_assert (g_hash_table_lookup (priv->balance_cache, &key) != NULL);
+    key.date = now - 2 * day;
+    g_assert (g_hash_table_lookup (priv->balance_cache, &key) == NULL);
+
+    /* A change to a descendant drops every date. */
+    gnc_account_set_start_balance (gnc_account_lookup_by_name (root, "meh"),
+                                   gnc_numeric_create (100, 100));
+    g_assert_cmpuint (g_hash_table_size (priv->balance_cache), == , 0);
+    g_assert_cmpuint (priv->balance_lru.length, == , 0);
+}
+/* xaccAccountGetBalanceChangeForPeriod
+gnc_numeric
+xaccAccountGetBalanceChangeForPeriod (Account *acc, time64 t1, time64 t2,
+                                      gboolean recurse)
+Both ends of the period stay cached, so asking again reads the cache.
+*/
+static void
+test_xaccAccountGetBalanceChangeForPeriod (Fixture *fixture, gconstpointer pData)
+{
+    auto root = gnc_account_get_root (fixture->acct);
+    auto book = gnc_account_get_book (root);
+    auto usd = gnc_commodity_new (book, "US Dollar", "CURRENCY", "USD", "0", 100);
+    auto bar = gnc_account_lookup_by_name (root, "bar");
+    auto priv = fixture->func->get_private (bar);
+    time64 day = 24 * 3600, t2 = gnc_time (NULL), t1 = t2 - 8 * day;
+    BalanceCacheEntry key, *e1, *e2;
+    gnc_numeric val;
+
+    xaccAccountSetCommodity (root, usd);
+    gnc_account_foreach_descendant (root, set_usd, usd);
+    xaccAccountRecomputeBalance (gnc_account_lookup_by_name (root, "meh"));
+
+    /* pepper and salt fall in the period. */
+    val = xaccAccountGetBalanceChangeForPeriod (bar, t1, t2, TRUE);
+    g_assert (gnc_numeric_equal (val, gnc_numeric_create (43760, 100)));
+
+    key.fn = reinterpret_cast<gpointer>(xaccAccountGetBalanceAsOfDate);
+    key.commodity = usd;
+    key.date = t1;
+    e1 = static_cast<BalanceCacheEntry*>(g_hash_table_lookup (priv->balance_cache, &key));
+    key.date = t2;
+    e2 = static_cast<BalanceCacheEntry*>(g_hash_table_lookup (priv->balance_cache, &key));
+    g_assert (e1 != NULL);
+    g_assert (e2 != NULL);
+
+    /* Change the cached sums behind the cache's back; the second call
+     * returns them, so it didn't sum the subtree again. */
+    e1->balance = gnc_numeric_create (100, 100);
+    e2->balance = gnc_numeric_create (1100, 100);
+    val = xaccAccountGetBalanceChangeForPeriod (bar, t1, t2, TRUE);
+    g_assert (gnc_numeric_equal (val, gnc_numeric_create (1000, 100)));
+
+    /* Without the children the account's own balances are used. */
+    val = xaccAccountGetBalanceChangeForPeriod (bar, t1, t2, FALSE);
+    g_assert (gnc_numeric_zero_p (val));
+}
 /*
  * xaccAccountConvertBalanceToCurrency
  * xaccAccountConvertBalanceToCurrencyAsOfDate are wrappers around
@@ -1971,17 +2206,14 @@ test_xaccAccountGetPresentBalance (Fixture *fixture, gconstpointer pData)
  *
  * xaccAccountGetXxxBalanceInCurrency
  * xaccAccountGetXxxBalanceAsOfDateInCurrency
- * xaccAccountBalanceHelper
- * xaccAccountBalanceAsOfDateHelper
+ * xaccAccountGetRolledUpBalance
  * xaccAccountGetXxxBalanceInCurrencyRecursive
  * xaccAccountGetXxxBalanceAsOfDateInCurrencyRecursive
- * xaccAccountGetBalanceInCurrency
  * xaccAccountGetClearedBalanceInCurrency
  * xaccAccountGetReconciledBalanceInCurrency
  * xaccAccountGetPresentBalanceInCurrency
  * xaccAccountGetProjectedMinimumBalanceInCurrency
  * xaccAccountGetBalanceAsOfDateInCurrency
- * xaccAccountGetBalanceChangeForPeriod
  */
 /*
  * Yet more getters & setters:
@@ -2572,13 +2804,18 @@ test_suite_account (void)
     GNC_TEST_ADD (suitename, "gnc account lookup by code", Fixture, &complex, setup, test_gnc_account_lookup_by_code,  teardown );
     GNC_TEST_ADD (suitename, "gnc account lookup by full name helper", Fixture, &complex, setup, test_gnc_account_lookup_by_full_name_helper,  teardown );
     GNC_TEST_ADD (suitename, "gnc account lookup by full name", Fixture, &complex, setup, test_gnc_account_lookup_by_full_name,  teardown );
+    GNC_TEST_ADD (suitename, "gnc account lookup after change", Fixture, &complex, setup, test_gnc_account_lookup_after_change,  teardown );
     GNC_TEST_ADD (suitename, "gnc account foreach child", Fixture, &complex, setup, test_gnc_account_foreach_child,  teardown );
     GNC_TEST_ADD (suitename, "gnc account foreach descendant", Fixture, &complex, setup, test_gnc_account_foreach_descendant,  teardown );
     GNC_TEST_ADD (suitename, "gnc account foreach descendant until", Fixture, &complex, setup, test_gnc_account_foreach_descendant_until,  teardown );
     GNC_TEST_ADD (suitename, "gnc account get full name", Fixture, &good_data, setup, test_gnc_account_get_full_name,  teardown );
+    GNC_TEST_ADD (suitename, "xaccAccountGetFullName", Fixture, &good_data, setup, test_xaccAccountGetFullName,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountGetProjectedMinimumBalance", Fixture, &some_data, setup, test_xaccAccountGetProjectedMinimumBalance,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountGetBalanceAsOfDate", Fixture, &some_data, setup, test_xaccAccountGetBalanceAsOfDate,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountGetPresentBalance", Fixture, &some_data, setup, test_xaccAccountGetPresentBalance,  teardown );
+    GNC_TEST_ADD (suitename, "xaccAccountGetBalanceInCurrency", Fixture, &complex, setup, test_xaccAccountGetBalanceInCurrency,  teardown );
+    GNC_TEST_ADD (suitename, "balance cache dates", Fixture, &some_data, setup, test_balance_cache_dates,  teardown );
+    GNC_TEST_ADD (suitename, "xaccAccountGetBalanceChangeForPeriod", Fixture, &some_data, setup, test_xaccAccountGetBalanceChangeForPeriod,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountFindOpenLots", Fixture, &complex_data, setup, test_xaccAccountFindOpenLots,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountForEachLot", Fixture, &complex_data, setup, test_xaccAccountForEachLot,  teardown );
 